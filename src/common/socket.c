@@ -240,6 +240,20 @@ static time_t socket_data_last_tick = 0;
 
 struct socket_data* session[FD_SETSIZE];
 
+// Packet batching (see batch_write)
+struct batch_entry {
+	size_t pos; // offset in bdata
+	uint16 len; // 0 when superseded
+	int id; // id of the unit the packet is about
+	uint32 key; // supersede key
+};
+
+// how many pending entries are checked for a superseded packet
+#define BATCH_SCAN_MAX 64
+
+static int batch_list[FD_SETSIZE]; // sessions with batched packets
+static int batch_list_count = 0;
+
 #ifdef SEND_SHORTLIST
 int send_shortlist_array[FD_SETSIZE];// we only support FD_SETSIZE sockets, limit the array to that
 int send_shortlist_count = 0;// how many fd's are in the shortlist
@@ -420,8 +434,11 @@ int send_from_fifo(int fd)
 /// Best effort - there's no warranty that the data will be sent.
 void flush_fifo(int fd)
 {
-	if(session[fd] != NULL)
+	if(session[fd] != NULL) {
+		if(session[fd]->bdata_size)
+			batch_flush(fd);
 		session[fd]->func_send(fd);
+	}
 }
 
 void flush_fifos(void)
@@ -608,6 +625,10 @@ static void delete_session(int fd)
 #endif
 		aFree(session[fd]->rdata);
 		aFree(session[fd]->wdata);
+		if( session[fd]->bdata )
+			aFree(session[fd]->bdata);
+		if( session[fd]->bentry )
+			aFree(session[fd]->bentry);
 		aFree(session[fd]->session_data);
 		aFree(session[fd]);
 		session[fd] = NULL;
@@ -658,6 +679,126 @@ int realloc_writefifo(int fd, size_t addition)
 	return 0;
 }
 
+/// Queues a packet for a client in the session's batch instead of writing it to the fifo.
+/// The batch is moved to the write fifo as one block before the next direct write (WFIFOHEAD)
+/// to the session and before sending, so the order of the packets is kept.
+/// A non-zero 'key' drops a pending packet with the same 'id' and 'key', as long as no other
+/// packet about 'id' was queued after it (the newer packet supersedes the older one).
+void batch_write(int fd, const uint8* buf, size_t len, int id, uint32 key)
+{
+	struct socket_data *s;
+	struct batch_entry *e;
+	size_t max_len = min(socket_max_client_packet, 0xFFFF);
+
+	if( !session_isActive(fd) )
+		return;
+
+	s = session[fd];
+
+	if( s->bdata_size + len > max_len ) { // the batch is written with a single WFIFOSET
+		batch_flush(fd);
+		if( len > max_len ) { // let WFIFOSET deal with it
+			WFIFOHEAD(fd, len);
+			memcpy(WFIFOP(fd,0), buf, len);
+			WFIFOSET(fd, len);
+			return;
+		}
+	}
+
+	if( key ) {
+		int i;
+
+		for( i = s->bentry_count - 1; i >= 0 && i >= s->bentry_count - BATCH_SCAN_MAX; i-- ) {
+			e = &s->bentry[i];
+			if( e->id != id || !e->len )
+				continue;
+			if( e->key == key )
+				e->len = 0;
+			break;
+		}
+	}
+
+	if( s->bdata_size + len > s->max_bdata ) {
+		s->max_bdata = max_len;
+		RECREATE(s->bdata, uint8, s->max_bdata);
+	}
+	if( s->bentry_count == s->max_bentry ) {
+		s->max_bentry += 32;
+		RECREATE(s->bentry, struct batch_entry, s->max_bentry);
+	}
+
+	e = &s->bentry[s->bentry_count++];
+	e->pos = s->bdata_size;
+	e->len = (uint16)len;
+	e->id = id;
+	e->key = key;
+	memcpy(s->bdata + s->bdata_size, buf, len);
+	s->bdata_size += len;
+
+	if( !s->flag.batched ) {
+		if( batch_list_count < ARRAYLENGTH(batch_list) ) {
+			s->flag.batched = 1;
+			batch_list[batch_list_count++] = fd;
+		} else // should not happen, don't hold the data
+			batch_flush(fd);
+	}
+}
+
+/// Moves the batched packets of a session to its write fifo.
+void batch_flush(int fd)
+{
+	struct socket_data *s;
+	size_t len = 0;
+	int i;
+
+	if( !session_isValid(fd) )
+		return;
+
+	s = session[fd];
+
+	if( !s->bdata_size )
+		return;
+
+	s->bdata_size = 0; // WFIFOHEAD would recurse otherwise
+	for( i = 0; i < s->bentry_count; i++ )
+		len += s->bentry[i].len;
+
+	if( len ) {
+		uint8 *p;
+
+		WFIFOHEAD(fd, len);
+		p = WFIFOP(fd,0);
+		for( i = 0; i < s->bentry_count; i++ ) {
+			struct batch_entry *e = &s->bentry[i];
+
+			if( !e->len )
+				continue;
+			memcpy(p, s->bdata + e->pos, e->len);
+			p += e->len;
+		}
+		WFIFOSET(fd, len);
+	}
+
+	s->bentry_count = 0;
+}
+
+/// Moves the batched packets of all sessions to their write fifos.
+/// Called at the end of the tick, before sending.
+void batch_flush_all(void)
+{
+	int i;
+
+	for( i = 0; i < batch_list_count; i++ ) {
+		int fd = batch_list[i];
+
+		if( !session_isValid(fd) )
+			continue;
+		session[fd]->flag.batched = 0;
+		batch_flush(fd);
+	}
+	batch_list_count = 0;
+}
+
 /// advance the RFIFO cursor (marking 'len' bytes as processed)
 int RFIFOSKIP(int fd, size_t len)
 {
@@ -753,6 +894,7 @@ int do_sockets(int next)
 
 	// PRESEND Timers are executed before do_sendrecv and can send packets and/or set sessions to eof.
 	// Send remaining data and process client-side disconnects here.
+	batch_flush_all();
 #ifdef SEND_SHORTLIST
 	send_shortlist_do_sends();
 #else
@@ -21,7 +21,7 @@
 
 // socket I/O macros
 #define RFIFOHEAD(fd)
-#define WFIFOHEAD(fd, size) do{ if((fd) && session[fd]->wdata_size + (size) > session[fd]->max_wdata ) realloc_writefifo(fd, size); }while(0)
+#define WFIFOHEAD(fd, size) do{ if((fd) && session[fd]->bdata_size) batch_flush(fd); if((fd) && session[fd]->wdata_size + (size) > session[fd]->max_wdata ) realloc_writefifo(fd, size); }while(0)
 #define RFIFOP(fd,pos) (session[fd]->rdata + session[fd]->rdata_pos + (pos))
 #define WFIFOP(fd,pos) (session[fd]->wdata + session[fd]->wdata_size + (pos))
 
@@ -77,6 +77,7 @@ struct socket_data
 		unsigned char eof : 1;
 		unsigned char server : 1;
 		unsigned char ping : 2;
+		unsigned char batched : 1; // in the batch list (see batch_write)
 	} flag;
 
 	uint32 client_addr; // remote client address
@@ -85,6 +86,10 @@ struct socket_data
 	size_t max_rdata, max_wdata;
 	size_t rdata_size, wdata_size;
 	size_t rdata_pos;
+	uint8 *bdata; // batched packets, moved to wdata by batch_flush
+	size_t max_bdata, bdata_size;
+	struct batch_entry *bentry; // one entry per batched packet
+	int bentry_count, max_bentry;
 	time_t rdata_tick; // time of last recv (for detecting timeouts); zero when timeout is disabled
 
 	RecvFunc func_recv;
@@ -124,6 +129,10 @@ void do_close(int fd);
 void socket_init(void);
 void socket_final(void);
 
+void batch_write(int fd, const uint8* buf, size_t len, int id, uint32 key);
+void batch_flush(int fd);
+void batch_flush_all(void);
+
 extern void flush_fifo(int fd);
 extern void flush_fifos(void);
 extern void set_nonblocking(int fd, unsigned long yes);
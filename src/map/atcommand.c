@@ -190,12 +190,12 @@ ACMD_FUNC(send)
 		int off, end;
 
 		if(len) { // Show packet length
-			sprintf(atcmd_output, msg_txt(904), type, packet_db[sd->packet_ver][type].len); // Packet 0x%x length: %d
+			sprintf(atcmd_output, msg_txt(904), type, sd->packet_db[type].len); // Packet 0x%x length: %d
 			clif_displaymessage(fd, atcmd_output);
 			return 0;
 		}
 
-		len = packet_db[sd->packet_ver][type].len;
+		len = sd->packet_db[type].len;
 		off = 2;
 		if(len == 0) { // Unknown packet - ERROR
 			sprintf(atcmd_output, msg_txt(905), type); // Unknown packet: 0x%x
@@ -335,7 +335,7 @@ ACMD_FUNC(send)
 			SKIP_VALUE(message);
 		}
 
-		if(packet_db[sd->packet_ver][type].len == -1) { // Send dynamic packet
+		if(sd->packet_db[type].len == -1) { // Send dynamic packet
 			WFIFOW(sd->fd,2) = TOW(off);
 			WFIFOSET(sd->fd,off);
 		} else { // Send static packet
@@ -6284,7 +6284,7 @@ ACMD_FUNC(mobsearch)
 			continue;
 
 		++number;
-		if( md->spawn_timer == INVALID_TIMER )
+		if( !md->spawn_pending )
 			snprintf(atcmd_output, sizeof(atcmd_output), "%2d[%3d:%3d] %s", number, md->bl.x, md->bl.y, md->name);
 		else
 			snprintf(atcmd_output, sizeof(atcmd_output), "%2d[%s] %s", number, "dead", md->name);
@@ -6662,6 +6662,106 @@ ACMD_FUNC(uptime)
 	return 0;
 }
 
+/*==========================================
+ * @xystats
+ * Shows the traffic of the party/guild minimap updates
+ *------------------------------------------*/
+ACMD_FUNC(xystats)
+{
+	struct s_xy_stats *stats[2];
+	const char *name[2] = { "Party", "Guild" };
+	int i;
+
+	nullpo_retr(-1, sd);
+
+	stats[0] = party_get_xy_stats();
+	stats[1] = guild_get_xy_stats();
+	for( i = 0; i < ARRAYLENGTH(stats); i++ ) {
+		snprintf(atcmd_output, sizeof(atcmd_output), "%s updates: %u runs, %u members, %u writes, %"PRIu64" packets (%"PRIu64" bytes). Last run: %u packets (%u bytes).",
+			name[i], stats[i]->intervals, stats[i]->members, stats[i]->writes, stats[i]->packets, stats[i]->bytes, stats[i]->last_packets, stats[i]->last_bytes);
+		clif_displaymessage(fd, atcmd_output);
+	}
+
+	return 0;
+}
+
+/*==========================================
+ * @pathstats
+ * Shows the hits and misses of the walk path cache
+ *------------------------------------------*/
+ACMD_FUNC(pathstats)
+{
+	uint64 hits, misses;
+
+	nullpo_retr(-1, sd);
+
+	path_cache_stats(&hits, &misses);
+	snprintf(atcmd_output, sizeof(atcmd_output), "Walk path cache: %"PRIu64" hits, %"PRIu64" misses (%.1f%% hits).",
+		hits, misses, (hits + misses) ? hits * 100. / (hits + misses) : 0.);
+	clif_displaymessage(fd, atcmd_output);
+
+	return 0;
+}
+
+/*==========================================
+ * @calcstats [reset]
+ * Shows how often battle statuses were recalculated
+ *------------------------------------------*/
+ACMD_FUNC(calcstats)
+{
+	uint64 calls, stats, skipped;
+	unsigned int start;
+	double seconds;
+
+	nullpo_retr(-1, sd);
+
+	if( message && *message && strcmpi(message, "reset") == 0 ) {
+		status_calc_stats_reset();
+		clif_displaymessage(fd, "Status recalculation counters reset.");
+		return 0;
+	}
+
+	status_calc_stats(&calls, &stats, &skipped, &start);
+	seconds = DIFF_TICK(gettick(), start) / 1000.;
+	if( seconds < 1. )
+		seconds = 1.;
+	snprintf(atcmd_output, sizeof(atcmd_output), "Status recalculations: %"PRIu64" (%.1f/s), %"PRIu64" stats recalculated (%.1f/s), %"PRIu64" dependent stats skipped (%.1f/s).",
+		calls, calls / seconds, stats, stats / seconds, skipped, skipped / seconds);
+	clif_displaymessage(fd, atcmd_output);
+
+	return 0;
+}
+
+/*==========================================
+ * @damagequeue [reset]
+ * Shows how many delayed hits were queued and how many timers drained them
+ *------------------------------------------*/
+ACMD_FUNC(damagequeue)
+{
+	uint64 hits, timers;
+	unsigned int start;
+	int peak;
+	double seconds;
+
+	nullpo_retr(-1, sd);
+
+	if( message && *message && strcmpi(message, "reset") == 0 ) {
+		battle_delay_damage_stats_reset();
+		clif_displaymessage(fd, "Delayed damage counters reset.");
+		return 0;
+	}
+
+	battle_delay_damage_stats(&hits, &timers, &peak, &start);
+	seconds = DIFF_TICK(gettick(), start) / 1000.;
+	if( seconds < 1. )
+		seconds = 1.;
+	snprintf(atcmd_output, sizeof(atcmd_output), "Delayed damage: %"PRIu64" hits queued (%.1f/s), %"PRIu64" timers armed (%.1f/s), peak of %d pending hits.",
+		hits, hits / seconds, timers, timers / seconds, peak);
+	clif_displaymessage(fd, atcmd_output);
+
+	return 0;
+}
+
 /*==========================================
  * @changesex <sex>
  * => Changes one's sex. Argument sex can be 0 or 1, m or f, male or female.
@@ -7074,7 +7174,7 @@ ACMD_FUNC(showmobs)
 			continue;
 		if (md->special_state.ai || md->master_id)
 			continue; // Hide slaves and player summoned mobs
-		if (md->spawn_timer != INVALID_TIMER)
+		if (md->spawn_pending)
 			continue; // Hide mobs waiting for respawn
 
 		++number;
@@ -9755,6 +9855,10 @@ void atcommand_basecommands(void) {
 		ACMD_DEF(unmute),
 		ACMD_DEF(clearweather),
 		ACMD_DEF(uptime),
+		ACMD_DEF(xystats),
+		ACMD_DEF(pathstats),
+		ACMD_DEF(calcstats),
+		ACMD_DEF(damagequeue),
 		ACMD_DEF(changesex),
 		ACMD_DEF(mute),
 		ACMD_DEF(refresh),
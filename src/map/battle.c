@@ -211,54 +211,208 @@ struct delay_damage {
 	unsigned short attack_type;
 	bool additional_effects;
 	enum bl_type src_type;
+	unsigned int tick; //When the damage is due
+	struct delay_damage *next; //Next hit in the same bucket
 };
 
-int battle_delay_damage_sub(int tid, unsigned int tick, int id, intptr_t data) {
-	struct delay_damage *dat = (struct delay_damage *)data;
+#define DELAY_DAMAGE_BUCKETS 2048 //Milliseconds covered by one round of the bucket ring (power of 2)
+
+/// Delayed hits, bucketed by the millisecond they are due and drained by a single timer.
+/// Buckets only hold hits due within DELAY_DAMAGE_BUCKETS of the cursor, so a bucket never mixes ticks;
+/// hits due further ahead wait in the later list until they come within range.
+static struct {
+	struct delay_damage *head[DELAY_DAMAGE_BUCKETS], *tail[DELAY_DAMAGE_BUCKETS];
+	uint32 used[DELAY_DAMAGE_BUCKETS / 32]; //Non-empty buckets
+	struct delay_damage *later, *later_tail; //Hits due a ring round or more ahead, in the order they were queued
+	unsigned int later_tick; //Earliest tick in later
+	unsigned int cursor; //First tick not drained yet
+	int count; //Pending hits
+	int timer; //Drain timer, armed for the earliest pending hit
+	unsigned int timer_tick;
+	bool draining;
+	uint64 hits, timers; //Hits queued and timers armed, see battle_delay_damage_stats
+	int peak; //Most hits pending at once
+	unsigned int stats_tick;
+} delay_damage_queue;
+
+/// Applies a delayed hit
+static void battle_delay_damage_sub(struct delay_damage *dat, unsigned int tick)
+{
+	struct block_list *src = NULL;
+	struct block_list *target = map_id2bl(dat->target_id);
 
-	if( dat ) {
-		struct block_list* src = NULL;
-		struct block_list* target = map_id2bl(dat->target_id);
+	if( !target || status_isdead(target) ) { /* Nothing we can do */
+		if( dat->src_type == BL_PC && (src = map_id2bl(dat->src_id)) &&
+			--((TBL_PC*)src)->delayed_damage == 0 && ((TBL_PC*)src)->state.hold_recalc ) {
+			((TBL_PC*)src)->state.hold_recalc = 0;
+			status_calc_pc(((TBL_PC*)src), SCO_FORCE);
+		}
+		return;
+	}
 
-		if( !target || status_isdead(target) ) { /* Nothing we can do */
-			if( dat->src_type == BL_PC && (src = map_id2bl(dat->src_id)) &&
-				--((TBL_PC*)src)->delayed_damage == 0 && ((TBL_PC*)src)->state.hold_recalc ) {
-				((TBL_PC*)src)->state.hold_recalc = 0;
-				status_calc_pc(((TBL_PC*)src), SCO_FORCE);
-			}
-			ers_free(delay_damage_ers, dat);
-			return 0;
+	src = map_id2bl(dat->src_id);
+
+	if( src &&
+		(target->type != BL_PC || ((TBL_PC*)target)->invincible_timer == INVALID_TIMER) &&
+		(dat->skill_id == MO_EXTREMITYFIST || (target->m == src->m && check_distance_bl(src, target, dat->distance))) )
+	{ //Check to see if you haven't teleported [Skotlex]
+		map_freeblock_lock();
+		status_fix_damage(src, target, dat->damage, dat->delay);
+		if( dat->attack_type && !status_isdead(target) && dat->additional_effects )
+			skill_additional_effect(src,target,dat->skill_id,dat->skill_lv,dat->attack_type,dat->dmg_lv,tick);
+		if( dat->dmg_lv > ATK_BLOCK && dat->attack_type )
+			skill_counter_additional_effect(src,target,dat->skill_id,dat->skill_lv,dat->attack_type,tick);
+		map_freeblock_unlock();
+	} else if( !src && dat->skill_id == CR_REFLECTSHIELD ) {
+		//It was monster reflected damage, and the monster died, we pass the damage to the character as expected
+		map_freeblock_lock();
+		status_fix_damage(target, target, dat->damage, dat->delay);
+		map_freeblock_unlock();
+	}
+
+	if( src && src->type == BL_PC && --((TBL_PC*)src)->delayed_damage == 0 && ((TBL_PC*)src)->state.hold_recalc ) {
+		((TBL_PC*)src)->state.hold_recalc = 0;
+		status_calc_pc(((TBL_PC*)src), SCO_FORCE);
+	}
+}
+
+/// Appends a hit to the bucket of the tick it is due, or to the later list when out of the ring's range
+static void battle_delay_damage_push(struct delay_damage *dat)
+{
+	int i = dat->tick&(DELAY_DAMAGE_BUCKETS - 1);
+
+	if( DIFF_TICK(dat->tick, delay_damage_queue.cursor) >= DELAY_DAMAGE_BUCKETS ) {
+		dat->next = NULL;
+		if( !delay_damage_queue.later ) {
+			delay_damage_queue.later = dat;
+			delay_damage_queue.later_tick = dat->tick;
+		} else {
+			delay_damage_queue.later_tail->next = dat;
+			if( DIFF_TICK(dat->tick, delay_damage_queue.later_tick) < 0 )
+				delay_damage_queue.later_tick = dat->tick;
 		}
+		delay_damage_queue.later_tail = dat;
+		return;
+	}
+	dat->next = NULL;
+	if( delay_damage_queue.tail[i] )
+		delay_damage_queue.tail[i]->next = dat;
+	else {
+		delay_damage_queue.head[i] = dat;
+		delay_damage_queue.used[i>>5] |= 1U<<(i&31);
+	}
+	delay_damage_queue.tail[i] = dat;
+}
+
+/// Moves the hits of the later list that came within the ring's range into their buckets
+static void battle_delay_damage_pull(void)
+{
+	struct delay_damage *dat = delay_damage_queue.later;
+
+	if( !dat || DIFF_TICK(delay_damage_queue.later_tick, delay_damage_queue.cursor) >= DELAY_DAMAGE_BUCKETS )
+		return;
+	delay_damage_queue.later = delay_damage_queue.later_tail = NULL;
+	while( dat ) { //Pushing again files every hit where it belongs now and recomputes later_tick
+		struct delay_damage *next = dat->next;
 
-		src = map_id2bl(dat->src_id);
+		battle_delay_damage_push(dat);
+		dat = next;
+	}
+}
+
+/// Finds when the earliest pending hit is due.
+/// The first non-empty bucket after the cursor holds it, else the later list does.
+static unsigned int battle_delay_damage_next(void)
+{
+	int start = delay_damage_queue.cursor&(DELAY_DAMAGE_BUCKETS - 1);
+	int w = start>>5, n;
+	uint32 bits = delay_damage_queue.used[w]&(~0U<<(start&31));
+
+	for( n = 0; n <= ARRAYLENGTH(delay_damage_queue.used); n++ ) {
+		if( bits ) {
+			int b = 0;
 
-		if( src &&
-			(target->type != BL_PC || ((TBL_PC*)target)->invincible_timer == INVALID_TIMER) &&
-			(dat->skill_id == MO_EXTREMITYFIST || (target->m == src->m && check_distance_bl(src, target, dat->distance))) )
-		{ //Check to see if you haven't teleported [Skotlex]
-			map_freeblock_lock();
-			status_fix_damage(src, target, dat->damage, dat->delay);
-			if( dat->attack_type && !status_isdead(target) && dat->additional_effects )
-				skill_additional_effect(src,target,dat->skill_id,dat->skill_lv,dat->attack_type,dat->dmg_lv,tick);
-			if( dat->dmg_lv > ATK_BLOCK && dat->attack_type )
-				skill_counter_additional_effect(src,target,dat->skill_id,dat->skill_lv,dat->attack_type,tick);
-			map_freeblock_unlock();
-		} else if( !src && dat->skill_id == CR_REFLECTSHIELD ) {
-			//It was monster reflected damage, and the monster died, we pass the damage to the character as expected
-			map_freeblock_lock();
-			status_fix_damage(target, target, dat->damage, dat->delay);
-			map_freeblock_unlock();
+			while( !(bits&(1U<<b)) ) //Lowest set bit
+				b++;
+			return delay_damage_queue.head[(w<<5) + b]->tick;
 		}
+		w = (w + 1)%ARRAYLENGTH(delay_damage_queue.used);
+		bits = delay_damage_queue.used[w];
+	}
+	return delay_damage_queue.later_tick;
+}
 
-		if( src && src->type == BL_PC && --((TBL_PC*)src)->delayed_damage == 0 && ((TBL_PC*)src)->state.hold_recalc ) {
-			((TBL_PC*)src)->state.hold_recalc = 0;
-			status_calc_pc(((TBL_PC*)src), SCO_FORCE);
+/// Arms the drain timer for a hit due at tick, unless it already fires earlier
+static void battle_delay_damage_arm(unsigned int tick)
+{
+	if( delay_damage_queue.draining )
+		return; //Armed once the drain finishes
+	if( delay_damage_queue.timer != INVALID_TIMER ) {
+		if( DIFF_TICK(delay_damage_queue.timer_tick, tick) <= 0 )
+			return;
+		delete_timer(delay_damage_queue.timer, battle_delay_damage_timer);
+	}
+	delay_damage_queue.timer = add_timer(tick, battle_delay_damage_timer, 0, 0);
+	delay_damage_queue.timer_tick = tick;
+	delay_damage_queue.timers++;
+}
+
+/// Applies every hit that became due, in the order they are due
+int battle_delay_damage_timer(int tid, unsigned int tick, int id, intptr_t data)
+{
+	if( tid != delay_damage_queue.timer )
+		return 0;
+	delay_damage_queue.timer = INVALID_TIMER;
+	delay_damage_queue.draining = true;
+	while( delay_damage_queue.count && DIFF_TICK(delay_damage_queue.cursor, tick) <= 0 ) {
+		unsigned int due;
+		int i;
+		struct delay_damage *dat;
+
+		due = delay_damage_queue.cursor++;
+		i = due&(DELAY_DAMAGE_BUCKETS - 1);
+		//Detach the bucket first, hits queued while applying these go to later ticks
+		dat = delay_damage_queue.head[i];
+		delay_damage_queue.head[i] = delay_damage_queue.tail[i] = NULL;
+		delay_damage_queue.used[i>>5] &= ~(1U<<(i&31));
+		//The ring moved a tick, file the hits that came within range before any new hit can be queued
+		battle_delay_damage_pull();
+		while( dat ) {
+			struct delay_damage *next = dat->next;
+
+			delay_damage_queue.count--;
+			battle_delay_damage_sub(dat, tick);
+			ers_free(delay_damage_ers, dat);
+			dat = next;
 		}
 	}
-	ers_free(delay_damage_ers, dat);
+	delay_damage_queue.draining = false;
+	if( delay_damage_queue.count )
+		battle_delay_damage_arm(battle_delay_damage_next());
 	return 0;
 }
 
+/// Reports how many delayed hits were queued and how many timers they needed
+/// @param hits Hits queued (a timer each before the queue)
+/// @param timers Drain timers armed
+/// @param peak Most hits pending at once
+/// @param tick When counting started
+void battle_delay_damage_stats(uint64 *hits, uint64 *timers, int *peak, unsigned int *tick)
+{
+	*hits = delay_damage_queue.hits;
+	*timers = delay_damage_queue.timers;
+	*peak = delay_damage_queue.peak;
+	*tick = delay_damage_queue.stats_tick;
+}
+
+/// Restarts the delayed damage counters
+void battle_delay_damage_stats_reset(void)
+{
+	delay_damage_queue.hits = delay_damage_queue.timers = 0;
+	delay_damage_queue.peak = delay_damage_queue.count;
+	delay_damage_queue.stats_tick = gettick();
+}
+
 int battle_delay_damage(unsigned int tick, int amotion, struct block_list *src, struct block_list *target, int attack_type, uint16 skill_id, uint16 skill_lv, int64 damage, enum damage_lv dmg_lv, int ddelay, bool additional_effects)
 {
 	struct delay_damage *dat;
@@ -305,7 +459,17 @@ int battle_delay_damage(unsigned int tick, int amotion, struct block_list *src,
 	if( src->type == BL_PC )
 		((TBL_PC*)src)->delayed_damage++;
 
-	add_timer(tick + amotion, battle_delay_damage_sub, 0, (intptr_t)dat);
+	if( !delay_damage_queue.count && !delay_damage_queue.draining )
+		delay_damage_queue.cursor = gettick();
+	dat->tick = tick + amotion;
+	if( DIFF_TICK(dat->tick, delay_damage_queue.cursor) < 0 )
+		dat->tick = delay_damage_queue.cursor; //Already drained past it, apply on the next drain
+	battle_delay_damage_push(dat);
+	delay_damage_queue.count++;
+	delay_damage_queue.hits++;
+	if( delay_damage_queue.peak < delay_damage_queue.count )
+		delay_damage_queue.peak = delay_damage_queue.count;
+	battle_delay_damage_arm(dat->tick);
 
 	return 0;
 }
@@ -464,8 +628,54 @@ int64 battle_attr_fix(struct block_list *src, struct block_list *target, int64 d
 	return max(damage,0);
 }
 
+/// Which part of battle_calc_cardfix a cached product belongs to
+enum e_cardfix_role {
+	CARDFIX_MAGIC_ATK = 1,
+	CARDFIX_MAGIC_DEF,
+	CARDFIX_WEAPON_ATK,
+	CARDFIX_WEAPON_DEF,
+	CARDFIX_MISC_DEF,
+};
+
+/// Appends the lowest 'bits' bits of 'value' to a cardfix cache key
+#define cardfix_key(key, value, bits) (((key)<<(bits))|((uint64)(value)&((1<<(bits)) - 1)))
+
+/// Looks up a card modifier product computed earlier for the same inputs
+static bool battle_cardfix_cache_get(struct map_session_data *sd, uint64 key, short *cardfix, short *cardfix_)
+{
+	struct s_cardfix_cache *cache = &sd->cardfix_cache;
+	int i;
+
+	ARR_FIND(0, cache->count, i, cache->key[i] == key);
+	if( i == cache->count )
+		return false;
+	*cardfix = cache->cardfix[i];
+	if( cardfix_ )
+		*cardfix_ = cache->cardfix_[i];
+	return true;
+}
+
+/// Remembers a card modifier product, replacing the oldest one when full
+static void battle_cardfix_cache_put(struct map_session_data *sd, uint64 key, short cardfix, short cardfix_)
+{
+	struct s_cardfix_cache *cache = &sd->cardfix_cache;
+	int i;
+
+	if( cache->count < MAX_CARDFIX_CACHE )
+		i = cache->count++;
+	else {
+		i = cache->next;
+		cache->next = (cache->next + 1)%MAX_CARDFIX_CACHE;
+	}
+	cache->key[i] = key;
+	cache->cardfix[i] = cardfix;
+	cache->cardfix_[i] = cardfix_;
+}
+
 /*==========================================
  * Calculates card bonuses damage adjustments.
+ * Products that only depend on equipment are remembered per player
+ * until the next bonus change, see battle_cardfix_cache_get.
  *------------------------------------------*/
 int battle_calc_cardfix(int attack_type, struct block_list *src, struct block_list *target, uint16 skill_id, int nk, int s_ele, int s_ele_, int64 damage, int left, int flag) {
 	struct map_session_data *sd, *tsd;
@@ -490,56 +700,81 @@ int battle_calc_cardfix(int attack_type, struct block_list *src, struct block_li
 	switch( attack_type ) {
 		case BF_MAGIC:
 			if( sd && !(nk&NK_NO_CARDFIX_ATK) ) {
-				cardfix = cardfix * (100 + sd->magic_addrace[tstatus->race] + sd->magic_addrace[RC_ALL]) / 100;
-				if( !(nk&NK_NO_ELEFIX) )
-					cardfix = cardfix * (100 + sd->magic_addele[tstatus->def_ele] + sd->magic_addele[ELE_ALL]) / 100;
-				cardfix = cardfix * (100 + sd->magic_addsize[tstatus->size] + sd->magic_addsize[SZ_ALL]) / 100;
-				cardfix = cardfix * (100 + sd->magic_addclass[tstatus->class_] + sd->magic_addclass[CLASS_ALL]) / 100;
-				cardfix = cardfix * (100 + sd->magic_atk_ele[s_ele] + sd->magic_atk_ele[ELE_ALL]) / 100;
-				for( i = 0; i < ARRAYLENGTH(sd->add_mdmg) && sd->add_mdmg[i].rate;i++ ) {
-					if( sd->add_mdmg[i].class_ == t_class ) {
-						cardfix = cardfix * (100 + sd->add_mdmg[i].rate) / 100;
-						break;
+				uint64 key = CARDFIX_MAGIC_ATK;
+
+				key = cardfix_key(key, tstatus->def_ele, 4);
+				key = cardfix_key(key, tstatus->race, 4);
+				key = cardfix_key(key, tstatus->size, 2);
+				key = cardfix_key(key, tstatus->class_, 3);
+				key = cardfix_key(key, s_ele, 4);
+				key = cardfix_key(key, t_class, 16);
+				key = cardfix_key(key, !!(nk&NK_NO_ELEFIX), 1);
+				if( !battle_cardfix_cache_get(sd, key, &cardfix, NULL) ) {
+					cardfix = cardfix * (100 + sd->magic_addrace[tstatus->race] + sd->magic_addrace[RC_ALL]) / 100;
+					if( !(nk&NK_NO_ELEFIX) )
+						cardfix = cardfix * (100 + sd->magic_addele[tstatus->def_ele] + sd->magic_addele[ELE_ALL]) / 100;
+					cardfix = cardfix * (100 + sd->magic_addsize[tstatus->size] + sd->magic_addsize[SZ_ALL]) / 100;
+					cardfix = cardfix * (100 + sd->magic_addclass[tstatus->class_] + sd->magic_addclass[CLASS_ALL]) / 100;
+					cardfix = cardfix * (100 + sd->magic_atk_ele[s_ele] + sd->magic_atk_ele[ELE_ALL]) / 100;
+					for( i = 0; i < ARRAYLENGTH(sd->add_mdmg) && sd->add_mdmg[i].rate;i++ ) {
+						if( sd->add_mdmg[i].class_ == t_class ) {
+							cardfix = cardfix * (100 + sd->add_mdmg[i].rate) / 100;
+							break;
+						}
 					}
+					battle_cardfix_cache_put(sd, key, cardfix, 1000);
 				}
 				if( cardfix != 1000 )
 					damage = damage * cardfix / 1000;
 			}
 			if( tsd && !(nk&NK_NO_CARDFIX_DEF) ) { //Target cards
+				uint64 key = CARDFIX_MAGIC_DEF;
+
 				cardfix = 1000; //Reset var for target
-				if( !(nk&NK_NO_ELEFIX) ) {
-					int ele_fix = tsd->subele[s_ele] + tsd->subele[ELE_ALL];
-
-					for( i = 0; ARRAYLENGTH(tsd->subele2) > i && tsd->subele2[i].rate != 0; i++ ) {
-						if( tsd->subele2[i].ele != s_ele )
-							continue;
-						if( !(((tsd->subele2[i].flag)&flag)&BF_WEAPONMASK &&
-							((tsd->subele2[i].flag)&flag)&BF_RANGEMASK &&
-							((tsd->subele2[i].flag)&flag)&BF_SKILLMASK) )
-							continue;
-						ele_fix += tsd->subele2[i].rate;
+				key = cardfix_key(key, s_ele, 4);
+				key = cardfix_key(key, sstatus->size, 2);
+				key = cardfix_key(key, s_race2, 3);
+				key = cardfix_key(key, sstatus->race, 4);
+				key = cardfix_key(key, sstatus->class_, 3);
+				key = cardfix_key(key, s_class, 16);
+				key = cardfix_key(key, flag, 10);
+				key = cardfix_key(key, !!(nk&NK_NO_ELEFIX), 1);
+				if( !battle_cardfix_cache_get(tsd, key, &cardfix, NULL) ) {
+					if( !(nk&NK_NO_ELEFIX) ) {
+						int ele_fix = tsd->subele[s_ele] + tsd->subele[ELE_ALL];
+
+						for( i = 0; ARRAYLENGTH(tsd->subele2) > i && tsd->subele2[i].rate != 0; i++ ) {
+							if( tsd->subele2[i].ele != s_ele )
+								continue;
+							if( !(((tsd->subele2[i].flag)&flag)&BF_WEAPONMASK &&
+								((tsd->subele2[i].flag)&flag)&BF_RANGEMASK &&
+								((tsd->subele2[i].flag)&flag)&BF_SKILLMASK) )
+								continue;
+							ele_fix += tsd->subele2[i].rate;
+						}
+						cardfix = cardfix * (100 - ele_fix) / 100;
 					}
-					cardfix = cardfix * (100 - ele_fix) / 100;
-				}
-				cardfix = cardfix * (100 - (tsd->subsize[sstatus->size] + tsd->subsize[SZ_ALL])) / 100;
-				cardfix = cardfix * (100 - tsd->subrace2[s_race2]) / 100;
-				cardfix = cardfix * (100 - (tsd->subrace[sstatus->race] + tsd->subrace[RC_ALL])) / 100;
-				cardfix = cardfix * (100 - (tsd->subclass[sstatus->class_] + tsd->subclass[CLASS_ALL])) / 100;
-				cardfix = cardfix * (100 - (tsd->magic_subrace[sstatus->race] + tsd->magic_subrace[RC_ALL])) / 100;
-				cardfix = cardfix * (100 - (tsd->magic_subclass[sstatus->class_] + tsd->magic_subclass[CLASS_ALL])) / 100;
-				for( i = 0; i < ARRAYLENGTH(tsd->add_mdef) && tsd->add_mdef[i].rate; i++ ) {
-					if( tsd->add_mdef[i].class_ == s_class ) {
-						cardfix = cardfix * (100 - tsd->add_mdef[i].rate) / 100;
-						break;
+					cardfix = cardfix * (100 - (tsd->subsize[sstatus->size] + tsd->subsize[SZ_ALL])) / 100;
+					cardfix = cardfix * (100 - tsd->subrace2[s_race2]) / 100;
+					cardfix = cardfix * (100 - (tsd->subrace[sstatus->race] + tsd->subrace[RC_ALL])) / 100;
+					cardfix = cardfix * (100 - (tsd->subclass[sstatus->class_] + tsd->subclass[CLASS_ALL])) / 100;
+					cardfix = cardfix * (100 - (tsd->magic_subrace[sstatus->race] + tsd->magic_subrace[RC_ALL])) / 100;
+					cardfix = cardfix * (100 - (tsd->magic_subclass[sstatus->class_] + tsd->magic_subclass[CLASS_ALL])) / 100;
+					for( i = 0; i < ARRAYLENGTH(tsd->add_mdef) && tsd->add_mdef[i].rate; i++ ) {
+						if( tsd->add_mdef[i].class_ == s_class ) {
+							cardfix = cardfix * (100 - tsd->add_mdef[i].rate) / 100;
+							break;
+						}
 					}
-				}
 #ifndef RENEWAL //It was discovered that ranged defense also counts vs magic! [Skotlex]
-				if( flag&BF_SHORT )
-					cardfix = cardfix * (100 - tsd->bonus.near_attack_def_rate) / 100;
-				else
-					cardfix = cardfix * (100 - tsd->bonus.long_attack_def_rate) / 100;
+					if( flag&BF_SHORT )
+						cardfix = cardfix * (100 - tsd->bonus.near_attack_def_rate) / 100;
+					else
+						cardfix = cardfix * (100 - tsd->bonus.long_attack_def_rate) / 100;
 #endif
-				cardfix = cardfix * (100 - tsd->bonus.magic_def_rate) / 100;
+					cardfix = cardfix * (100 - tsd->bonus.magic_def_rate) / 100;
+					battle_cardfix_cache_put(tsd, key, cardfix, 1000);
+				}
 				if( tsd->sc.data[SC_MDEF_RATE] )
 					cardfix = cardfix * (100 - tsd->sc.data[SC_MDEF_RATE]->val1) / 100;
 				if( cardfix != 1000 )
@@ -550,37 +785,26 @@ int battle_calc_cardfix(int attack_type, struct block_list *src, struct block_li
 			t_race2 = status_get_race2(target);
 			if( sd && !(nk&NK_NO_CARDFIX_ATK) && (left&2) ) { //Attacker cards should be checked
 				short cardfix_ = 1000;
-
-				if( sd->state.arrow_atk ) {
-					cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->arrow_addrace[tstatus->race] +
-						sd->right_weapon.addrace[RC_ALL] + sd->arrow_addrace[RC_ALL]) / 100;
-					if( !(nk&NK_NO_ELEFIX) ) {
-						int ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->arrow_addele[tstatus->def_ele] +
-							sd->right_weapon.addele[ELE_ALL] + sd->arrow_addele[ELE_ALL];
-
-						for( i = 0; ARRAYLENGTH(sd->right_weapon.addele2) > i && sd->right_weapon.addele2[i].rate != 0; i++ ) {
-							if( sd->right_weapon.addele2[i].ele != tstatus->def_ele )
-								continue;
-							if( !(((sd->right_weapon.addele2[i].flag)&flag)&BF_WEAPONMASK &&
-								((sd->right_weapon.addele2[i].flag)&flag)&BF_RANGEMASK &&
-								((sd->right_weapon.addele2[i].flag)&flag)&BF_SKILLMASK) )
-								continue;
-							ele_fix += sd->right_weapon.addele2[i].rate;
-						}
-						cardfix = cardfix * (100 + ele_fix) / 100;
-					}
-					cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->arrow_addsize[tstatus->size] +
-						sd->right_weapon.addsize[SZ_ALL] + sd->arrow_addsize[SZ_ALL]) / 100;
-					cardfix = cardfix * (100 + sd->right_weapon.addrace2[t_race2]) / 100;
-					cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->arrow_addclass[tstatus->class_] +
-						sd->right_weapon.addclass[CLASS_ALL] + sd->arrow_addclass[CLASS_ALL]) / 100;
-				} else { //Melee attack
-					int skill = 0;
-
-					if( !battle_config.left_cardfix_to_right ) {
-						cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->right_weapon.addrace[RC_ALL]) / 100;
+				uint64 key = CARDFIX_WEAPON_ATK;
+
+				key = cardfix_key(key, tstatus->def_ele, 4);
+				key = cardfix_key(key, tstatus->race, 4);
+				key = cardfix_key(key, tstatus->size, 2);
+				key = cardfix_key(key, tstatus->class_, 3);
+				key = cardfix_key(key, t_race2, 3);
+				key = cardfix_key(key, t_class, 16);
+				key = cardfix_key(key, !!(nk&NK_NO_ELEFIX), 1);
+				key = cardfix_key(key, flag, 10);
+				key = cardfix_key(key, left, 2);
+				key = cardfix_key(key, sd->state.arrow_atk, 1);
+				key = cardfix_key(key, !!battle_config.left_cardfix_to_right, 1);
+				if( !battle_cardfix_cache_get(sd, key, &cardfix, &cardfix_) ) {
+					if( sd->state.arrow_atk ) {
+						cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->arrow_addrace[tstatus->race] +
+							sd->right_weapon.addrace[RC_ALL] + sd->arrow_addrace[RC_ALL]) / 100;
 						if( !(nk&NK_NO_ELEFIX) ) {
-							int ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->right_weapon.addele[ELE_ALL];
+							int ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->arrow_addele[tstatus->def_ele] +
+								sd->right_weapon.addele[ELE_ALL] + sd->arrow_addele[ELE_ALL];
 
 							for( i = 0; ARRAYLENGTH(sd->right_weapon.addele2) > i && sd->right_weapon.addele2[i].rate != 0; i++ ) {
 								if( sd->right_weapon.addele2[i].ele != tstatus->def_ele )
@@ -593,14 +817,69 @@ int battle_calc_cardfix(int attack_type, struct block_list *src, struct block_li
 							}
 							cardfix = cardfix * (100 + ele_fix) / 100;
 						}
-						cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->right_weapon.addsize[SZ_ALL]) / 100;
+						cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->arrow_addsize[tstatus->size] +
+							sd->right_weapon.addsize[SZ_ALL] + sd->arrow_addsize[SZ_ALL]) / 100;
 						cardfix = cardfix * (100 + sd->right_weapon.addrace2[t_race2]) / 100;
-						cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->right_weapon.addclass[CLASS_ALL]) / 100;
-						if( left&1 ) {
-							cardfix_ = cardfix_ * (100 + sd->left_weapon.addrace[tstatus->race] + sd->left_weapon.addrace[RC_ALL]) / 100;
+						cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->arrow_addclass[tstatus->class_] +
+							sd->right_weapon.addclass[CLASS_ALL] + sd->arrow_addclass[CLASS_ALL]) / 100;
+					} else { //Melee attack
+						int skill = 0;
+
+						if( !battle_config.left_cardfix_to_right ) {
+							cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->right_weapon.addrace[RC_ALL]) / 100;
 							if( !(nk&NK_NO_ELEFIX) ) {
-								int ele_fix_lh = sd->left_weapon.addele[tstatus->def_ele] + sd->left_weapon.addele[ELE_ALL];
+								int ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->right_weapon.addele[ELE_ALL];
 
+								for( i = 0; ARRAYLENGTH(sd->right_weapon.addele2) > i && sd->right_weapon.addele2[i].rate != 0; i++ ) {
+									if( sd->right_weapon.addele2[i].ele != tstatus->def_ele )
+										continue;
+									if( !(((sd->right_weapon.addele2[i].flag)&flag)&BF_WEAPONMASK &&
+										((sd->right_weapon.addele2[i].flag)&flag)&BF_RANGEMASK &&
+										((sd->right_weapon.addele2[i].flag)&flag)&BF_SKILLMASK) )
+										continue;
+									ele_fix += sd->right_weapon.addele2[i].rate;
+								}
+								cardfix = cardfix * (100 + ele_fix) / 100;
+							}
+							cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->right_weapon.addsize[SZ_ALL]) / 100;
+							cardfix = cardfix * (100 + sd->right_weapon.addrace2[t_race2]) / 100;
+							cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->right_weapon.addclass[CLASS_ALL]) / 100;
+							if( left&1 ) {
+								cardfix_ = cardfix_ * (100 + sd->left_weapon.addrace[tstatus->race] + sd->left_weapon.addrace[RC_ALL]) / 100;
+								if( !(nk&NK_NO_ELEFIX) ) {
+									int ele_fix_lh = sd->left_weapon.addele[tstatus->def_ele] + sd->left_weapon.addele[ELE_ALL];
+
+									for( i = 0; ARRAYLENGTH(sd->left_weapon.addele2) > i && sd->left_weapon.addele2[i].rate != 0; i++ ) {
+										if( sd->left_weapon.addele2[i].ele != tstatus->def_ele )
+											continue;
+										if( !(((sd->left_weapon.addele2[i].flag)&flag)&BF_WEAPONMASK &&
+											((sd->left_weapon.addele2[i].flag)&flag)&BF_RANGEMASK &&
+											((sd->left_weapon.addele2[i].flag)&flag)&BF_SKILLMASK) )
+											continue;
+										ele_fix_lh += sd->left_weapon.addele2[i].rate;
+									}
+									cardfix_ = cardfix_ * (100 + ele_fix_lh) / 100;
+								}
+								cardfix_ = cardfix_ * (100 + sd->left_weapon.addsize[tstatus->size] + sd->left_weapon.addsize[SZ_ALL]) / 100;
+								cardfix_ = cardfix_ * (100 + sd->left_weapon.addrace2[t_race2]) / 100;
+								cardfix_ = cardfix_ * (100 + sd->left_weapon.addclass[tstatus->class_] + sd->left_weapon.addclass[CLASS_ALL]) / 100;
+							}
+						} else {
+							cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->left_weapon.addrace[tstatus->race] +
+								sd->right_weapon.addrace[RC_ALL] + sd->left_weapon.addrace[RC_ALL]) / 100;
+							if( !(nk&NK_NO_ELEFIX) ) {
+								int ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->left_weapon.addele[tstatus->def_ele] +
+									sd->right_weapon.addele[ELE_ALL] + sd->left_weapon.addele[ELE_ALL];
+
+								for( i = 0; ARRAYLENGTH(sd->right_weapon.addele2) > i && sd->right_weapon.addele2[i].rate != 0; i++ ) {
+									if( sd->right_weapon.addele2[i].ele != tstatus->def_ele )
+										continue;
+									if( !(((sd->right_weapon.addele2[i].flag)&flag)&BF_WEAPONMASK &&
+										((sd->right_weapon.addele2[i].flag)&flag)&BF_RANGEMASK &&
+										((sd->right_weapon.addele2[i].flag)&flag)&BF_SKILLMASK) )
+										continue;
+									ele_fix += sd->right_weapon.addele2[i].rate;
+								}
 								for( i = 0; ARRAYLENGTH(sd->left_weapon.addele2) > i && sd->left_weapon.addele2[i].rate != 0; i++ ) {
 									if( sd->left_weapon.addele2[i].ele != tstatus->def_ele )
 										continue;
@@ -608,116 +887,102 @@ int battle_calc_cardfix(int attack_type, struct block_list *src, struct block_li
 										((sd->left_weapon.addele2[i].flag)&flag)&BF_RANGEMASK &&
 										((sd->left_weapon.addele2[i].flag)&flag)&BF_SKILLMASK) )
 										continue;
-									ele_fix_lh += sd->left_weapon.addele2[i].rate;
+									ele_fix += sd->left_weapon.addele2[i].rate;
 								}
-								cardfix_ = cardfix_ * (100 + ele_fix_lh) / 100;
+								cardfix = cardfix * (100 + ele_fix) / 100;
 							}
-							cardfix_ = cardfix_ * (100 + sd->left_weapon.addsize[tstatus->size] + sd->left_weapon.addsize[SZ_ALL]) / 100;
-							cardfix_ = cardfix_ * (100 + sd->left_weapon.addrace2[t_race2]) / 100;
-							cardfix_ = cardfix_ * (100 + sd->left_weapon.addclass[tstatus->class_] + sd->left_weapon.addclass[CLASS_ALL]) / 100;
+							cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->left_weapon.addsize[tstatus->size] +
+								sd->right_weapon.addsize[SZ_ALL] + sd->left_weapon.addsize[SZ_ALL]) / 100;
+							cardfix = cardfix * (100 + sd->right_weapon.addrace2[t_race2] + sd->left_weapon.addrace2[t_race2]) / 100;
+							cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->left_weapon.addclass[tstatus->class_] +
+								sd->right_weapon.addclass[CLASS_ALL] + sd->left_weapon.addclass[CLASS_ALL]) / 100;
 						}
-					} else {
-						cardfix = cardfix * (100 + sd->right_weapon.addrace[tstatus->race] + sd->left_weapon.addrace[tstatus->race] +
-							sd->right_weapon.addrace[RC_ALL] + sd->left_weapon.addrace[RC_ALL]) / 100;
-						if( !(nk&NK_NO_ELEFIX) ) {
-							int ele_fix = sd->right_weapon.addele[tstatus->def_ele] + sd->left_weapon.addele[tstatus->def_ele] +
-								sd->right_weapon.addele[ELE_ALL] + sd->left_weapon.addele[ELE_ALL];
-
-							for( i = 0; ARRAYLENGTH(sd->right_weapon.addele2) > i && sd->right_weapon.addele2[i].rate != 0; i++ ) {
-								if( sd->right_weapon.addele2[i].ele != tstatus->def_ele )
-									continue;
-								if( !(((sd->right_weapon.addele2[i].flag)&flag)&BF_WEAPONMASK &&
-									((sd->right_weapon.addele2[i].flag)&flag)&BF_RANGEMASK &&
-									((sd->right_weapon.addele2[i].flag)&flag)&BF_SKILLMASK) )
-									continue;
-								ele_fix += sd->right_weapon.addele2[i].rate;
-							}
-							for( i = 0; ARRAYLENGTH(sd->left_weapon.addele2) > i && sd->left_weapon.addele2[i].rate != 0; i++ ) {
-								if( sd->left_weapon.addele2[i].ele != tstatus->def_ele )
-									continue;
-								if( !(((sd->left_weapon.addele2[i].flag)&flag)&BF_WEAPONMASK &&
-									((sd->left_weapon.addele2[i].flag)&flag)&BF_RANGEMASK &&
-									((sd->left_weapon.addele2[i].flag)&flag)&BF_SKILLMASK) )
-									continue;
-								ele_fix += sd->left_weapon.addele2[i].rate;
-							}
-							cardfix = cardfix * (100 + ele_fix) / 100;
-						}
-						cardfix = cardfix * (100 + sd->right_weapon.addsize[tstatus->size] + sd->left_weapon.addsize[tstatus->size] +
-							sd->right_weapon.addsize[SZ_ALL] + sd->left_weapon.addsize[SZ_ALL]) / 100;
-						cardfix = cardfix * (100 + sd->right_weapon.addrace2[t_race2] + sd->left_weapon.addrace2[t_race2]) / 100;
-						cardfix = cardfix * (100 + sd->right_weapon.addclass[tstatus->class_] + sd->left_weapon.addclass[tstatus->class_] +
-							sd->right_weapon.addclass[CLASS_ALL] + sd->left_weapon.addclass[CLASS_ALL]) / 100;
-					}
-					//Adv. Katar Mastery functions similar to a +%ATK card on official [helvetica]
-					if( sd->status.weapon == W_KATAR && (skill = pc_checkskill(sd,ASC_KATAR)) > 0 )
-						cardfix = cardfix * (100 + (10 + 2 * skill)) / 100;
-				}
-				for( i = 0; i < ARRAYLENGTH(sd->right_weapon.add_dmg) && sd->right_weapon.add_dmg[i].rate; i++ ) {
-					if( sd->right_weapon.add_dmg[i].class_ == t_class ) {
-						cardfix = cardfix * (100 + sd->right_weapon.add_dmg[i].rate) / 100;
-						break;
+						//Adv. Katar Mastery functions similar to a +%ATK card on official [helvetica]
+						if( sd->status.weapon == W_KATAR && (skill = pc_checkskill(sd,ASC_KATAR)) > 0 )
+							cardfix = cardfix * (100 + (10 + 2 * skill)) / 100;
 					}
-				}
-				if( left&1 ) {
-					for( i = 0; i < ARRAYLENGTH(sd->left_weapon.add_dmg) && sd->left_weapon.add_dmg[i].rate; i++ ) {
-						if( sd->left_weapon.add_dmg[i].class_ == t_class ) {
-							cardfix_ = cardfix_ * (100 + sd->left_weapon.add_dmg[i].rate) / 100;
+					for( i = 0; i < ARRAYLENGTH(sd->right_weapon.add_dmg) && sd->right_weapon.add_dmg[i].rate; i++ ) {
+						if( sd->right_weapon.add_dmg[i].class_ == t_class ) {
+							cardfix = cardfix * (100 + sd->right_weapon.add_dmg[i].rate) / 100;
 							break;
 						}
 					}
-				}
+					if( left&1 ) {
+						for( i = 0; i < ARRAYLENGTH(sd->left_weapon.add_dmg) && sd->left_weapon.add_dmg[i].rate; i++ ) {
+							if( sd->left_weapon.add_dmg[i].class_ == t_class ) {
+								cardfix_ = cardfix_ * (100 + sd->left_weapon.add_dmg[i].rate) / 100;
+								break;
+							}
+						}
+					}
 #ifndef RENEWAL
-				if( flag&BF_LONG )
-					cardfix = cardfix * (100 + sd->bonus.long_attack_atk_rate) / 100;
+					if( flag&BF_LONG )
+						cardfix = cardfix * (100 + sd->bonus.long_attack_atk_rate) / 100;
 #endif
+					battle_cardfix_cache_put(sd, key, cardfix, cardfix_);
+				}
 				if( (left&1) && cardfix_ != 1000 )
 					damage = damage * cardfix_ / 1000;
 				else if( cardfix != 1000 )
 					damage = damage * cardfix / 1000;
 			} else if( tsd && !(nk&NK_NO_CARDFIX_DEF) && !(left&2) ) { //Target cards should be checked
-				if( !(nk&NK_NO_ELEFIX) ) {
-					int ele_fix = tsd->subele[s_ele] + tsd->subele[ELE_ALL];
-
-					for( i = 0; ARRAYLENGTH(tsd->subele2) > i && tsd->subele2[i].rate != 0; i++ ) {
-						if( tsd->subele2[i].ele != s_ele )
-							continue;
-						if( !(((tsd->subele2[i].flag)&flag)&BF_WEAPONMASK &&
-							((tsd->subele2[i].flag)&flag)&BF_RANGEMASK &&
-							((tsd->subele2[i].flag)&flag)&BF_SKILLMASK) )
-							continue;
-						ele_fix += tsd->subele2[i].rate;
-					}
-					cardfix = cardfix * (100 - ele_fix) / 100;
-					if( left&1 && s_ele_ != s_ele ) {
-						int ele_fix_lh = tsd->subele[s_ele_] + tsd->subele[ELE_ALL];
+				uint64 key = CARDFIX_WEAPON_DEF;
+
+				key = cardfix_key(key, s_ele, 4);
+				key = cardfix_key(key, s_ele_, 4);
+				key = cardfix_key(key, left&1, 1);
+				key = cardfix_key(key, sstatus->size, 2);
+				key = cardfix_key(key, s_race2, 3);
+				key = cardfix_key(key, sstatus->race, 4);
+				key = cardfix_key(key, sstatus->class_, 3);
+				key = cardfix_key(key, s_class, 16);
+				key = cardfix_key(key, flag, 10);
+				key = cardfix_key(key, !!(nk&NK_NO_ELEFIX), 1);
+				if( !battle_cardfix_cache_get(tsd, key, &cardfix, NULL) ) {
+					if( !(nk&NK_NO_ELEFIX) ) {
+						int ele_fix = tsd->subele[s_ele] + tsd->subele[ELE_ALL];
 
 						for( i = 0; ARRAYLENGTH(tsd->subele2) > i && tsd->subele2[i].rate != 0; i++ ) {
-							if( tsd->subele2[i].ele != s_ele_ )
+							if( tsd->subele2[i].ele != s_ele )
 								continue;
 							if( !(((tsd->subele2[i].flag)&flag)&BF_WEAPONMASK &&
 								((tsd->subele2[i].flag)&flag)&BF_RANGEMASK &&
 								((tsd->subele2[i].flag)&flag)&BF_SKILLMASK) )
 								continue;
-							ele_fix_lh += tsd->subele2[i].rate;
+							ele_fix += tsd->subele2[i].rate;
+						}
+						cardfix = cardfix * (100 - ele_fix) / 100;
+						if( left&1 && s_ele_ != s_ele ) {
+							int ele_fix_lh = tsd->subele[s_ele_] + tsd->subele[ELE_ALL];
+
+							for( i = 0; ARRAYLENGTH(tsd->subele2) > i && tsd->subele2[i].rate != 0; i++ ) {
+								if( tsd->subele2[i].ele != s_ele_ )
+									continue;
+								if( !(((tsd->subele2[i].flag)&flag)&BF_WEAPONMASK &&
+									((tsd->subele2[i].flag)&flag)&BF_RANGEMASK &&
+									((tsd->subele2[i].flag)&flag)&BF_SKILLMASK) )
+									continue;
+								ele_fix_lh += tsd->subele2[i].rate;
+							}
+							cardfix = cardfix * (100 - ele_fix_lh) / 100;
 						}
-						cardfix = cardfix * (100 - ele_fix_lh) / 100;
 					}
-				}
-				cardfix = cardfix * (100 - (tsd->subsize[sstatus->size] + tsd->subsize[SZ_ALL])) / 100;
-				cardfix = cardfix * (100 - tsd->subrace2[s_race2]) / 100;
-				cardfix = cardfix * (100 - (tsd->subrace[sstatus->race] + tsd->subrace[RC_ALL])) / 100;
-				cardfix = cardfix * (100 - (tsd->subclass[sstatus->class_] + tsd->subclass[CLASS_ALL])) / 100;
-				for( i = 0; i < ARRAYLENGTH(tsd->add_def) && tsd->add_def[i].rate;i++ ) {
-					if( tsd->add_def[i].class_ == s_class ) {
-						cardfix = cardfix * (100 - tsd->add_def[i].rate) / 100;
-						break;
+					cardfix = cardfix * (100 - (tsd->subsize[sstatus->size] + tsd->subsize[SZ_ALL])) / 100;
+					cardfix = cardfix * (100 - tsd->subrace2[s_race2]) / 100;
+					cardfix = cardfix * (100 - (tsd->subrace[sstatus->race] + tsd->subrace[RC_ALL])) / 100;
+					cardfix = cardfix * (100 - (tsd->subclass[sstatus->class_] + tsd->subclass[CLASS_ALL])) / 100;
+					for( i = 0; i < ARRAYLENGTH(tsd->add_def) && tsd->add_def[i].rate;i++ ) {
+						if( tsd->add_def[i].class_ == s_class ) {
+							cardfix = cardfix * (100 - tsd->add_def[i].rate) / 100;
+							break;
+						}
 					}
+					if( flag&BF_SHORT )
+						cardfix = cardfix * (100 - tsd->bonus.near_attack_def_rate) / 100;
+					else
+						cardfix = cardfix * (100 - tsd->bonus.long_attack_def_rate) / 100;
+					battle_cardfix_cache_put(tsd, key, cardfix, 1000);
 				}
-				if( flag&BF_SHORT )
-					cardfix = cardfix * (100 - tsd->bonus.near_attack_def_rate) / 100;
-				else
-					cardfix = cardfix * (100 - tsd->bonus.long_attack_def_rate) / 100;
 				if( tsd->sc.data[SC_DEF_RATE] )
 					cardfix = cardfix * (100 - tsd->sc.data[SC_DEF_RATE]->val1) / 100;
 				if( cardfix != 1000 )
@@ -726,29 +991,41 @@ int battle_calc_cardfix(int attack_type, struct block_list *src, struct block_li
 			break;
 		case BF_MISC:
 			if( tsd && !(nk&NK_NO_CARDFIX_DEF) ) { //Misc damage reduction from equipment
-				if( !(nk&NK_NO_ELEFIX) ) {
-					int ele_fix = tsd->subele[s_ele] + tsd->subele[ELE_ALL];
-
-					for( i = 0; ARRAYLENGTH(tsd->subele2) > i && tsd->subele2[i].rate != 0; i++ ) {
-						if( tsd->subele2[i].ele != s_ele )
-							continue;
-						if( !(((tsd->subele2[i].flag)&flag)&BF_WEAPONMASK &&
-							((tsd->subele2[i].flag)&flag)&BF_RANGEMASK &&
-							((tsd->subele2[i].flag)&flag)&BF_SKILLMASK))
-							continue;
-						ele_fix += tsd->subele2[i].rate;
+				uint64 key = CARDFIX_MISC_DEF;
+
+				key = cardfix_key(key, s_ele, 4);
+				key = cardfix_key(key, sstatus->size, 2);
+				key = cardfix_key(key, s_race2, 3);
+				key = cardfix_key(key, sstatus->race, 4);
+				key = cardfix_key(key, sstatus->class_, 3);
+				key = cardfix_key(key, flag, 10);
+				key = cardfix_key(key, !!(nk&NK_NO_ELEFIX), 1);
+				if( !battle_cardfix_cache_get(tsd, key, &cardfix, NULL) ) {
+					if( !(nk&NK_NO_ELEFIX) ) {
+						int ele_fix = tsd->subele[s_ele] + tsd->subele[ELE_ALL];
+
+						for( i = 0; ARRAYLENGTH(tsd->subele2) > i && tsd->subele2[i].rate != 0; i++ ) {
+							if( tsd->subele2[i].ele != s_ele )
+								continue;
+							if( !(((tsd->subele2[i].flag)&flag)&BF_WEAPONMASK &&
+								((tsd->subele2[i].flag)&flag)&BF_RANGEMASK &&
+								((tsd->subele2[i].flag)&flag)&BF_SKILLMASK))
+								continue;
+							ele_fix += tsd->subele2[i].rate;
+						}
+						cardfix = cardfix * (100 - ele_fix) / 100;
 					}
-					cardfix = cardfix * (100 - ele_fix) / 100;
+					cardfix = cardfix * (100 - (tsd->subsize[sstatus->size] + tsd->subsize[SZ_ALL])) / 100;
+					cardfix = cardfix * (100 - tsd->subrace2[s_race2]) / 100;
+					cardfix = cardfix * (100 - (tsd->subrace[sstatus->race] + tsd->subrace[RC_ALL])) / 100;
+					cardfix = cardfix * (100 - (tsd->subclass[sstatus->class_] + tsd->subclass[CLASS_ALL])) / 100;
+					cardfix = cardfix * (100 - tsd->bonus.misc_def_rate) / 100;
+					if( flag&BF_SHORT )
+						cardfix = cardfix * (100 - tsd->bonus.near_attack_def_rate) / 100;
+					else
+						cardfix = cardfix * (100 - tsd->bonus.long_attack_def_rate) / 100;
+					battle_cardfix_cache_put(tsd, key, cardfix, 1000);
 				}
-				cardfix = cardfix * (100 - (tsd->subsize[sstatus->size] + tsd->subsize[SZ_ALL])) / 100;
-				cardfix = cardfix * (100 - tsd->subrace2[s_race2]) / 100;
-				cardfix = cardfix * (100 - (tsd->subrace[sstatus->race] + tsd->subrace[RC_ALL])) / 100;
-				cardfix = cardfix * (100 - (tsd->subclass[sstatus->class_] + tsd->subclass[CLASS_ALL])) / 100;
-				cardfix = cardfix * (100 - tsd->bonus.misc_def_rate) / 100;
-				if( flag&BF_SHORT )
-					cardfix = cardfix * (100 - tsd->bonus.near_attack_def_rate) / 100;
-				else
-					cardfix = cardfix * (100 - tsd->bonus.long_attack_def_rate) / 100;
 				if( cardfix != 10000 )
 					damage = damage * cardfix / 1000;
 			}
@@ -8391,6 +8668,12 @@ static const struct _battle_data {
 	{ "homunculus_evo_intimacy_need",       &battle_config.homunculus_evo_intimacy_need,    91100,  0,      INT_MAX,        },
 	{ "homunculus_evo_intimacy_reset",      &battle_config.homunculus_evo_intimacy_reset,   1000,   0,      INT_MAX,        },
 	{ "monster_loot_search_type",           &battle_config.monster_loot_search_type,        1,      0,      1,              },
+	{ "batch_area_packets",                 &battle_config.batch_area_packets,              0,      0,      2,              },
+	{ "area_char_budget",                   &battle_config.area_char_budget,                0,      0,      INT_MAX,        },
+	{ "area_char_interval",                 &battle_config.area_char_interval,              100,    10,     1000,           },
+	{ "mob_freeze_empty_maps",              &battle_config.mob_freeze_empty_maps,           0,      0,      1,              },
+	{ "walk_batch_interval",                &battle_config.walk_batch_interval,             0,      0,      100,            },
+	{ "status_calc_cache",                  &battle_config.status_calc_cache,               0,      0,      2,              },
 };
 #ifndef STATS_OPT_OUT
 /**
@@ -8681,7 +8964,9 @@ int battle_config_read(const char* cfgName)
 void do_init_battle(void)
 {
 	delay_damage_ers = ers_new(sizeof(struct delay_damage),"battle.c::delay_damage_ers",ERS_OPT_CLEAR);
-	add_timer_func_list(battle_delay_damage_sub, "battle_delay_damage_sub");
+	add_timer_func_list(battle_delay_damage_timer, "battle_delay_damage_timer");
+	delay_damage_queue.timer = INVALID_TIMER;
+	battle_delay_damage_stats_reset();
 	
 #ifndef STATS_OPT_OUT
 	add_timer_func_list(rAthena_report_timer, "rAthena_report_timer");
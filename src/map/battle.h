@@ -96,6 +96,9 @@ int64 battle_calc_gvg_damage(struct block_list *src, struct block_list *bl, int6
 int64 battle_calc_bg_damage(struct block_list *src, struct block_list *bl, int64 damage, uint16 skill_id, int flag);
 
 int battle_delay_damage(unsigned int tick, int amotion, struct block_list *src, struct block_list *target, int attack_type, uint16 skill_id, uint16 skill_lv, int64 damage, enum damage_lv dmg_lv, int ddelay, bool additional_effects);
+int battle_delay_damage_timer(int tid, unsigned int tick, int id, intptr_t data);
+void battle_delay_damage_stats(uint64 *hits, uint64 *timers, int *peak, unsigned int *tick);
+void battle_delay_damage_stats_reset(void);
 
 //Summary normal attack treatment (basic attack)
 enum damage_lv battle_weapon_attack(struct block_list *bl,struct block_list *target,unsigned int tick,int flag);
@@ -595,6 +598,12 @@ extern struct Battle_Config
 	int homunculus_evo_intimacy_need;
 	int homunculus_evo_intimacy_reset;
 	int monster_loot_search_type;
+	int batch_area_packets;
+	int area_char_budget;
+	int area_char_interval;
+	int mob_freeze_empty_maps;
+	int walk_batch_interval;
+	int status_calc_cache;
 } battle_config;
 
 void do_init_battle(void);
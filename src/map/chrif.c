@@ -970,9 +970,7 @@ int chrif_changedsex(int fd) {
 	if ((sd = map_id2sd(acc)) != NULL) {
 		int i;
 
-		for (i = 0; i < SC_MAX; i++) {
-			if (!sd->sc.data[i])
-				continue;
+		for (i = status_change_next(&sd->sc, 0); i < SC_MAX; i = status_change_next(&sd->sc, i + 1)) {
 			switch (i) {
 				case SC_MOONSTAR:	case SC_SUPER_STAR:
 				case SC_STRANGELIGHTS:	case SC_DECORATION_OF_MUSIC:
@@ -1282,7 +1280,6 @@ int chrif_save_scdata(struct map_session_data *sd) {
 	unsigned int tick;
 	struct status_change_data data;
 	struct status_change *sc = &sd->sc;
-	const struct TimerData *timer;
 
 	chrif_check(-1);
 	tick = gettick();
@@ -1292,15 +1289,10 @@ int chrif_save_scdata(struct map_session_data *sd) {
 	WFIFOL(char_fd,4) = sd->status.account_id;
 	WFIFOL(char_fd,8) = sd->status.char_id;
 
-	for (i = 0; i < SC_MAX; i++) {
-		if (!sc->data[i])
-			continue;
+	for (i = status_change_next(sc, 0); i < SC_MAX; i = status_change_next(sc, i + 1)) {
 		if (sc->data[i]->timer != INVALID_TIMER) {
-			timer = get_timer(sc->data[i]->timer);
-			if (timer == NULL || timer->func != status_change_timer)
-				continue;
-			if (DIFF_TICK(timer->tick,tick) > 0)
-				data.tick = DIFF_TICK(timer->tick,tick); //Duration that is left before ending
+			if (DIFF_TICK(sc->data[i]->tick,tick) > 0)
+				data.tick = DIFF_TICK(sc->data[i]->tick,tick); //Duration that is left before ending
 			else
 				data.tick = 0; //Negative tick does not necessarily mean that sc has expired
 		} else
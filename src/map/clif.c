@@ -64,6 +64,7 @@ struct clif_config {
 } clif_config;
 
 struct s_packet_db packet_db[MAX_PACKET_VER + 1][MAX_PACKET_DB + 1];
+uint32 packet_db_mask[MAX_PACKET_VER + 1][(MAX_PACKET_DB + 32) / 32]; //Packets with a length in packet_db, one bit per packet
 int packet_db_ack[MAX_PACKET_VER + 1][MAX_ACK_FUNC + 1];
 #ifdef PACKET_OBFUSCATION
 	static struct s_packet_keys *packet_keys[MAX_PACKET_VER + 1];
@@ -268,6 +269,38 @@ static inline unsigned char clif_bl_type(struct block_list *bl) {
 }
 #endif
 
+/// Returns the key of an update that a newer packet of the same kind about the same unit
+/// supersedes (see batch_write), 0 if the packet must always reach the client.
+static uint32 clif_batch_key(const uint8* buf) {
+	uint16 cmd = RBUFW(buf,0);
+
+	switch (cmd) {
+		case 0x86:  //ZC_NOTIFY_PLAYERMOVE
+		case 0x88:  //ZC_STOPMOVE
+		case 0x106: //ZC_NOTIFY_HP_TO_GROUPM
+		case 0x80e: //ZC_NOTIFY_HP_TO_GROUPM_R2
+		case 0x977: //ZC_HP_INFO
+			return cmd;
+		case 0x196: //ZC_MSG_STATE_CHANGE
+		case 0x43f: //ZC_MSG_STATE_CHANGE2
+		case 0x983: //ZC_MSG_STATE_CHANGE3
+			return 0x196|(RBUFW(buf,2)<<16); //Per status icon
+	}
+	return 0;
+}
+
+/// Writes a packet that is sent to several clients to one of them.
+/// With batch_area_packets the packet is held until the end of the tick (see batch_write).
+static inline void clif_send_fifo(int fd, const uint8* buf, int len, struct block_list* src_bl) {
+	if (battle_config.batch_area_packets) {
+		batch_write(fd, buf, len, src_bl->id, (battle_config.batch_area_packets == 2 ? clif_batch_key(buf) : 0));
+		return;
+	}
+	WFIFOHEAD(fd,len);
+	memcpy(WFIFOP(fd,0), buf, len);
+	WFIFOSET(fd,len);
+}
+
 /*==========================================
  * sub process of clif_send
  * Called from a map_foreachinarea (grabs all players in specific area and subjects them to this function)
@@ -283,6 +316,7 @@ static int clif_send_sub(struct block_list *bl, va_list ap) {
 	struct map_session_data *sd;
 	unsigned char *buf;
 	int len, type, fd;
+	uint16 cmd;
 
 	nullpo_ret(bl);
 	nullpo_ret(sd = (struct map_session_data *)bl);
@@ -295,6 +329,7 @@ static int clif_send_sub(struct block_list *bl, va_list ap) {
 	len = va_arg(ap,int);
 	nullpo_ret(src_bl = va_arg(ap,struct block_list*));
 	type = va_arg(ap,int);
+	cmd = RBUFW(buf,0);
 
 	switch (type) {
 		case AREA_WOS:
@@ -335,7 +370,8 @@ static int clif_send_sub(struct block_list *bl, va_list ap) {
 	if (session[fd] == NULL)
 		return 0;
 
-	WFIFOHEAD(fd, len);
+	if (!battle_config.batch_area_packets)
+		WFIFOHEAD(fd, len);
 	if (WFIFOP(fd,0) == buf) {
 		ShowError("WARNING: Invalid use of clif_send function\n");
 		ShowError("         Packet x%4x use a WFIFO of a player instead of to use a buffer.\n", WBUFW(buf,0));
@@ -346,10 +382,8 @@ static int clif_send_sub(struct block_list *bl, va_list ap) {
 		return 0;
 	}
 
-	if (packet_db[sd->packet_ver][RBUFW(buf,0)].len) { //Packet must exist for the client version
-		memcpy(WFIFOP(fd,0), buf, len);
-		WFIFOSET(fd,len);
-	}
+	if (packet_exists(sd->packet_ver, cmd)) //Packet must exist for the client version
+		clif_send_fifo(fd, buf, len, src_bl);
 
 	return 0;
 }
@@ -366,6 +400,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 	struct battleground_data *bg = NULL;
 	int x0 = 0, x1 = 0, y0 = 0, y1 = 0, fd;
 	struct s_mapiterator* iter;
+	uint16 cmd = RBUFW(buf,0);
 
 	if (type != ALL_CLIENT)
 		nullpo_ret(bl);
@@ -376,7 +411,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 		case ALL_CLIENT: //All player clients
 			iter = mapit_getallusers();
 			while ((tsd = (TBL_PC*)mapit_next(iter)) != NULL) {
-				if (packet_db[tsd->packet_ver][RBUFW(buf,0)].len) { //Packet must exist for the client version
+				if (packet_exists(tsd->packet_ver, cmd)) { //Packet must exist for the client version
 					WFIFOHEAD(tsd->fd,len);
 					memcpy(WFIFOP(tsd->fd,0), buf, len);
 					WFIFOSET(tsd->fd,len);
@@ -388,7 +423,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 		case ALL_SAMEMAP: //All players on the same map
 			iter = mapit_getallusers();
 			while ((tsd = (TBL_PC*)mapit_next(iter)) != NULL) {
-				if (bl->m == tsd->bl.m && packet_db[tsd->packet_ver][RBUFW(buf,0)].len) { //Packet must exist for the client version
+				if (bl->m == tsd->bl.m && packet_exists(tsd->packet_ver, cmd)) { //Packet must exist for the client version
 					WFIFOHEAD(tsd->fd,len);
 					memcpy(WFIFOP(tsd->fd,0), buf, len);
 					WFIFOSET(tsd->fd,len);
@@ -426,7 +461,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 				for (i = 0; i < cd->users; i++) {
 					if (type == CHAT_WOS && cd->usersd[i] == sd)
 						continue;
-					if (packet_db[cd->usersd[i]->packet_ver][RBUFW(buf,0)].len) { //Packet must exist for the client version
+					if (packet_exists(cd->usersd[i]->packet_ver, cmd)) { //Packet must exist for the client version
 						if ((fd = cd->usersd[i]->fd) > 0 && session[fd]) { //Added check to see if session exists [PoW]
 							WFIFOHEAD(fd,len);
 							memcpy(WFIFOP(fd,0), buf, len);
@@ -462,17 +497,14 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 					if ((type == PARTY_AREA || type == PARTY_AREA_WOS) && (sd->bl.x < x0 || sd->bl.y < y0 ||
 						sd->bl.x > x1 || sd->bl.y > y1))
 						continue;
-					if (packet_db[sd->packet_ver][RBUFW(buf,0)].len) { //Packet must exist for the client version
-						WFIFOHEAD(fd,len);
-						memcpy(WFIFOP(fd,0), buf, len);
-						WFIFOSET(fd,len);
-					}
+					if (packet_exists(sd->packet_ver, cmd)) //Packet must exist for the client version
+						clif_send_fifo(fd, buf, len, bl);
 				}
 				if (!enable_spy) //Skip unnecessary parsing [Skotlex]
 					break;
 				iter = mapit_getallusers();
 				while ((tsd = (TBL_PC*)mapit_next(iter)) != NULL) { //Packet must exist for the client version
-					if (tsd->partyspy == p->party.party_id && packet_db[tsd->packet_ver][RBUFW(buf,0)].len) {
+					if (tsd->partyspy == p->party.party_id && packet_exists(tsd->packet_ver, cmd)) {
 						WFIFOHEAD(tsd->fd,len);
 						memcpy(WFIFOP(tsd->fd,0), buf, len);
 						WFIFOSET(tsd->fd,len);
@@ -491,7 +523,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 				if (type == DUEL_WOS && bl->id == tsd->bl.id)
 					continue;
 				//Packet must exist for the client version
-				if (sd->duel_group == tsd->duel_group && packet_db[tsd->packet_ver][RBUFW(buf,0)].len) {
+				if (sd->duel_group == tsd->duel_group && packet_exists(tsd->packet_ver, cmd)) {
 					WFIFOHEAD(tsd->fd,len);
 					memcpy(WFIFOP(tsd->fd,0), buf, len);
 					WFIFOSET(tsd->fd,len);
@@ -501,7 +533,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 			break;
 
 		case SELF: //Packet must exist for the client version
-			if (sd && (fd = sd->fd) && packet_db[sd->packet_ver][RBUFW(buf,0)].len) {
+			if (sd && (fd = sd->fd) && packet_exists(sd->packet_ver, cmd)) {
 				WFIFOHEAD(fd,len);
 				memcpy(WFIFOP(fd,0), buf, len);
 				WFIFOSET(fd,len);
@@ -536,7 +568,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 						if ((type == GUILD_AREA || type == GUILD_AREA_WOS) && (sd->bl.x < x0 || sd->bl.y < y0 ||
 							sd->bl.x > x1 || sd->bl.y > y1))
 							continue;
-						if (packet_db[sd->packet_ver][RBUFW(buf,0)].len) { //Packet must exist for the client version
+						if (packet_exists(sd->packet_ver, cmd)) { //Packet must exist for the client version
 							WFIFOHEAD(fd,len);
 							memcpy(WFIFOP(fd,0), buf, len);
 							WFIFOSET(fd,len);
@@ -547,7 +579,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 					break;
 				iter = mapit_getallusers();
 				while ((tsd = (TBL_PC*)mapit_next(iter)) != NULL) { //Packet must exist for the client version
-					if (tsd->guildspy == g->guild_id && packet_db[tsd->packet_ver][RBUFW(buf,0)].len) {
+					if (tsd->guildspy == g->guild_id && packet_exists(tsd->packet_ver, cmd)) {
 						WFIFOHEAD(tsd->fd,len);
 						memcpy(WFIFOP(tsd->fd,0), buf, len);
 						WFIFOSET(tsd->fd,len);
@@ -578,7 +610,7 @@ int clif_send(const uint8* buf, int len, struct block_list* bl, enum send_target
 					if ((type == BG_AREA || type == BG_AREA_WOS) && (sd->bl.x < x0 || sd->bl.y < y0 ||
 						sd->bl.x > x1 || sd->bl.y > y1))
 						continue;
-					if (packet_db[sd->packet_ver][RBUFW(buf,0)].len) { //Packet must exist for the client version
+					if (packet_exists(sd->packet_ver, cmd)) { //Packet must exist for the client version
 						WFIFOHEAD(fd,len);
 						memcpy(WFIFOP(fd,0), buf, len);
 						WFIFOSET(fd,len);
@@ -891,8 +923,9 @@ static int clif_setlevel(struct block_list* bl) {
 
 /*==========================================
  * Prepares 'unit standing/spawning' packet
+ * pos: if not NULL, receives the offset of the position in the packet
  *------------------------------------------*/
-static int clif_set_unit_idle(struct block_list* bl, unsigned char* buffer, bool spawn) {
+static int clif_set_unit_idle(struct block_list* bl, unsigned char* buffer, bool spawn, unsigned short* pos) {
 	struct map_session_data* sd;
 	struct status_change* sc = status_get_sc(bl);
 	struct view_data* vd = status_get_viewdata(bl);
@@ -1042,6 +1075,8 @@ static int clif_set_unit_idle(struct block_list* bl, unsigned char* buffer, bool
 	WBUFB(buf,44) = (sd && sd->status.karma) ? 1 : 0;
 	WBUFB(buf,45) = vd->sex;
 	WBUFPOS(buf,46,bl->x,bl->y,unit_getdir(bl));
+	if (pos)
+		*pos = offset + 46;
 	WBUFB(buf,49) = (sd ? 5 : 0);
 	WBUFB(buf,50) = (sd ? 5 : 0);
 	if (!spawn) {
@@ -1129,7 +1164,7 @@ static int clif_spawn_unit(struct block_list* bl, unsigned char* buffer) {
 }
 
 
-static int clif_idle_unit(struct block_list* bl, unsigned char* buffer) {
+static int clif_idle_unit(struct block_list* bl, unsigned char* buffer, unsigned short* pos) {
 	struct map_session_data* sd;
 	struct status_change* sc = status_get_sc(bl);
 	struct view_data* vd = status_get_viewdata(bl);
@@ -1170,6 +1205,8 @@ static int clif_idle_unit(struct block_list* bl, unsigned char* buffer) {
 	WBUFB(buf,53) = (sd && sd->status.karma) ? 1 : 0;
 	WBUFB(buf,54) = vd->sex;
 	WBUFPOS(buf,55,bl->x,bl->y,unit_getdir(bl));
+	if (pos)
+		*pos = 55;
 	WBUFB(buf,58) = (sd ? 5 : 0);
 	WBUFB(buf,59) = (sd ? 5 : 0);
 	WBUFB(buf,60) = vd->dead_sit;
@@ -1388,6 +1425,8 @@ static void clif_setdisguise(struct block_list *bl, unsigned char *buf, int len)
 void clif_class_change(struct block_list *bl,int class_,int type) {
 	nullpo_retv(bl);
 
+	clif_clearviewcache(bl);
+
 	if(!pcdb_checkid(class_)) { //Player classes yield missing sprites
 		unsigned char buf[16];
 
@@ -1498,7 +1537,7 @@ int clif_spawn(struct block_list *bl)
 		return 0;
 
 #ifndef VISIBLE_MONSTER_HP
-	len = clif_set_unit_idle(bl,buf,true);
+	len = clif_set_unit_idle(bl,buf,true,NULL);
 #else
 	len = clif_spawn_unit(bl,buf);
 #endif
@@ -2054,7 +2093,7 @@ void clif_npc_market_open(struct map_session_data *sd, struct npc_data *nd)
 	if( sd->state.trading )
 		return;
 
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	if( !info || info->len == 0 )
 		return;
 
@@ -2102,7 +2141,7 @@ void clif_npc_market_purchase_ack(struct map_session_data *sd, uint8 res, uint8
 	nullpo_retv(sd);
 	nullpo_retv((nd = map_id2nd(sd->npc_shopid)));
 
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	if( !info || info->len == 0 )
 		return;
 
@@ -2146,7 +2185,7 @@ void clif_parse_NPCMarketPurchase(int fd, struct map_session_data *sd) {
 	if( !sd->npc_shopid )
 		return;
 
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	if( !info || info->len == 0 )
 		return;
 	len = RFIFOW(fd,info->pos[0]);
@@ -2974,17 +3013,76 @@ void clif_clearcart(int fd)
 
 /// Guild XY locators (ZC_NOTIFY_POSITION_TO_GUILDM) [Valaris]
 /// 01eb <account id>.L <x>.W <y>.W
+static int clif_guild_xy_sub(unsigned char *buf, struct map_session_data *sd)
+{
+	WBUFW(buf,0) = 0x1eb;
+	WBUFL(buf,2) = sd->status.account_id;
+	WBUFW(buf,6) = sd->bl.x;
+	WBUFW(buf,8) = sd->bl.y;
+	return packet_len(0x1eb);
+}
+
 void clif_guild_xy(struct map_session_data *sd)
 {
 	unsigned char buf[10];
 
 	nullpo_retv(sd);
 
-	WBUFW(buf,0) = 0x1eb;
-	WBUFL(buf,2) = sd->status.account_id;
-	WBUFW(buf,6) = sd->bl.x;
-	WBUFW(buf,8) = sd->bl.y;
-	clif_send(buf,packet_len(0x1eb),&sd->bl,GUILD_SAMEMAP_WOS);
+	clif_send(buf,clif_guild_xy_sub(buf,sd),&sd->bl,GUILD_SAMEMAP_WOS);
+}
+
+/// Queues the pending guild dots for one recipient with a single write.
+/// Members only see the members on their map, spies see everything.
+static void clif_guild_xy_batch_sub(struct map_session_data *sd, struct guild *g, const uint8 *flag, bool spy, struct s_xy_stats *stats)
+{
+	unsigned char buf[MAX_GUILD * 10];
+	int i, len = 0, count = 0, fd = sd->fd;
+
+	if( !packet_exists(sd->packet_ver, 0x1eb) )
+		return;
+
+	for( i = 0; i < g->max_member; i++ ) {
+		struct map_session_data *tsd = g->member[i].sd;
+
+		if( !flag[i] || !tsd || tsd == sd )
+			continue;
+		if( !spy && tsd->bl.m != sd->bl.m )
+			continue;
+		len += clif_guild_xy_sub(WBUFP(buf,len), tsd);
+		count++;
+	}
+	if( !len )
+		return;
+	WFIFOHEAD(fd,len);
+	memcpy(WFIFOP(fd,0), buf, len);
+	WFIFOSET(fd,len);
+	stats->writes++;
+	stats->packets += count;
+	stats->bytes += len;
+}
+
+/// Sends the minimap dots that changed since the last guild update (see guild_send_xy_timer_sub).
+/// flag[i] holds the e_xy_update entries of g->member[i]; every member gets its dots coalesced into one write.
+void clif_guild_xy_batch(struct guild *g, const uint8 *flag, struct s_xy_stats *stats)
+{
+	struct map_session_data *sd;
+	int i;
+
+	nullpo_retv(g);
+
+	for( i = 0; i < g->max_member; i++ ) {
+		if( (sd = g->member[i].sd) != NULL && sd->fd )
+			clif_guild_xy_batch_sub(sd, g, flag, false, stats);
+	}
+	if( enable_spy ) {
+		struct s_mapiterator *iter = mapit_getallusers();
+
+		while( (sd = (TBL_PC *)mapit_next(iter)) != NULL ) {
+			if( sd->guildspy == g->guild_id )
+				clif_guild_xy_batch_sub(sd, g, flag, true, stats);
+		}
+		mapit_free(iter);
+	}
 }
 
 /*==========================================
@@ -3335,6 +3433,7 @@ void clif_changelook(struct block_list *bl,int type,int val)
 	sd = BL_CAST(BL_PC, bl);
 	sc = status_get_sc(bl);
 	vd = status_get_viewdata(bl);
+	clif_clearviewcache(bl);
 
 	if(vd) { //Temp hack to let Warp Portal change appearance
 		switch(type) {
@@ -3702,7 +3801,7 @@ void clif_equipitemack(struct map_session_data *sd,int n,int pos,uint8 flag)
 	nullpo_retv(sd);
 
 	cmd = packet_db_ack[sd->packet_ver][ZC_WEAR_EQUIP_ACK];
-	if (!cmd || !(info = &packet_db[sd->packet_ver][cmd]) || !info->len)
+	if (!cmd || !(info = &sd->packet_db[cmd]) || !info->len)
 		return;
 
 	fd = sd->fd;
@@ -3818,6 +3917,7 @@ void clif_changeoption(struct block_list* bl)
 	if(!sc)
 		return; //How can an option change if there's no sc?
 	sd = BL_CAST(BL_PC, bl);
+	clif_clearviewcache(bl);
 	
 #if PACKETVER >= 7
 	WBUFW(buf,0) = 0x229;
@@ -3865,6 +3965,7 @@ void clif_changeoption2(struct block_list* bl)
 	sc = status_get_sc(bl);
 	if(!sc)
 		return; //How can an option change if there's no sc?
+	clif_clearviewcache(bl);
 
 	WBUFW(buf,0) = 0x28a;
 	WBUFL(buf,2) = bl->id;
@@ -4503,6 +4604,78 @@ static void clif_getareachar_pc(struct map_session_data* sd,struct map_session_d
 		clif_devotion(d_bl, sd);
 }
 
+/// Idle packet of a unit, built once and reused for every player that gets the unit in sight.
+/// Position, direction, sit/dead state (and hp) are written on each use, everything else
+/// is kept until clif_clearviewcache is called because the look of the unit changed.
+struct unit_viewcache {
+	bool valid;
+	unsigned short len; //Packet length
+	unsigned short pos; //Offset of the position in buf
+	int guild_id, emblem_id; //Not tracked by the look change notifications
+	short manner;
+	unsigned char karma, head_dir;
+	uint8 buf[128];
+};
+
+/// Invalidates the cached idle packet of a unit, it must be called on any change of
+/// the data that clif_set_unit_idle sends (view data, options, speed, level, name, ...).
+void clif_clearviewcache(struct block_list *bl) {
+	struct unit_data *ud = unit_bl2ud(bl);
+
+	if (ud && ud->viewcache)
+		ud->viewcache->valid = false;
+}
+
+/// Frees the cached idle packet of a unit.
+void clif_freeviewcache(struct unit_data *ud) {
+	if (ud->viewcache) {
+		aFree(ud->viewcache);
+		ud->viewcache = NULL;
+	}
+}
+
+/// Writes the idle packet of a unit to buffer, using the unit's cached copy when still valid.
+static int clif_set_unit_idle_cached(struct block_list* bl, struct unit_data* ud, unsigned char* buffer) {
+	struct unit_viewcache *vc = ud->viewcache;
+	struct map_session_data *sd = BL_CAST(BL_PC,bl);
+	int guild_id = status_get_guild_id(bl), emblem_id = status_get_emblem_id(bl);
+	short manner = (sd ? sd->status.manner : 0);
+	unsigned char karma = (sd ? sd->status.karma : 0), head_dir = (sd ? sd->head_dir : 0);
+
+	if (!vc) {
+		CREATE(ud->viewcache, struct unit_viewcache, 1);
+		vc = ud->viewcache;
+	}
+
+	if (!vc->valid || vc->guild_id != guild_id || vc->emblem_id != emblem_id || vc->manner != manner ||
+		vc->karma != karma || vc->head_dir != head_dir) {
+#ifndef VISIBLE_MONSTER_HP
+		vc->len = clif_set_unit_idle(bl,vc->buf,false,&vc->pos);
+#else
+		vc->len = clif_idle_unit(bl,vc->buf,&vc->pos);
+#endif
+		vc->guild_id = guild_id;
+		vc->emblem_id = emblem_id;
+		vc->manner = manner;
+		vc->karma = karma;
+		vc->head_dir = head_dir;
+		vc->valid = true;
+		memcpy(buffer, vc->buf, vc->len);
+		return vc->len;
+	}
+
+	memcpy(buffer, vc->buf, vc->len);
+	WBUFPOS(buffer,vc->pos,bl->x,bl->y,unit_getdir(bl));
+	WBUFB(buffer,vc->pos + 5) = status_get_viewdata(bl)->dead_sit;
+#ifdef VISIBLE_MONSTER_HP
+	if (bl->type == BL_MOB) {
+		WBUFL(buffer,vc->pos + 10) = status_get_max_hp(bl);
+		WBUFL(buffer,vc->pos + 14) = status_get_hp(bl);
+	}
+#endif
+	return vc->len;
+}
+
 void clif_getareachar_unit(struct map_session_data* sd,struct block_list *bl)
 {
 	uint8 buf[128];
@@ -4519,10 +4692,19 @@ void clif_getareachar_unit(struct map_session_data* sd,struct block_list *bl)
 		return;
 
 	ud = unit_bl2ud(bl);
+	if (ud && ud->walktimer != INVALID_TIMER)
 #ifndef VISIBLE_MONSTER_HP
-	len = (ud && ud->walktimer != INVALID_TIMER) ? clif_set_unit_walking(bl,ud,buf) : clif_set_unit_idle(bl,buf,false);
+		len = clif_set_unit_walking(bl,ud,buf);
 #else
-	len = (ud && ud->walktimer != INVALID_TIMER) ? clif_walking_unit(bl,ud,buf) : clif_idle_unit(bl,buf);
+		len = clif_walking_unit(bl,ud,buf);
+#endif
+	else if (ud)
+		len = clif_set_unit_idle_cached(bl,ud,buf);
+	else
+#ifndef VISIBLE_MONSTER_HP
+		len = clif_set_unit_idle(bl,buf,false,NULL);
+#else
+		len = clif_idle_unit(bl,buf,NULL);
 #endif
 	clif_send(buf,len,&sd->bl,SELF);
 
@@ -5030,18 +5212,10 @@ void clif_skillunit_update(struct block_list* bl)
 
 
 /*==========================================
- *
+ * Shows bl to sd
  *------------------------------------------*/
-static int clif_getareachar(struct block_list* bl,va_list ap)
+static void clif_getareachar_sub(struct map_session_data* sd, struct block_list* bl)
 {
-	struct map_session_data *sd;
-	nullpo_ret(bl);
-
-	sd = va_arg(ap,struct map_session_data*);
-
-	if (sd == NULL || !sd->fd)
-		return 0;
-
 	switch (bl->type) {
 		case BL_ITEM:
 			clif_getareachar_item(sd,(struct flooritem_data*) bl);
@@ -5055,9 +5229,153 @@ static int clif_getareachar(struct block_list* bl,va_list ap)
 			clif_getareachar_unit(sd,bl);
 			break;
 	}
+}
+
+static int clif_getareachar(struct block_list* bl,va_list ap)
+{
+	struct map_session_data *sd;
+	nullpo_ret(bl);
+
+	sd = va_arg(ap,struct map_session_data*);
+
+	if (sd == NULL || !sd->fd)
+		return 0;
+
+	clif_getareachar_sub(sd,bl);
+	return 0;
+}
+
+//Units around a player, ordered by clif_getareachar_priority (see clif_getareachar_all)
+struct s_areachar {
+	struct block_list *bl;
+	int priority;
+};
+static struct s_areachar *areachar_list = NULL;
+static int areachar_count = 0, areachar_max = 0;
+
+/// Order in which the units around sd are shown when the area budget is exceeded, lower first:
+/// party/guild members and own units, then units in combat or targeting sd, then the rest, each by distance.
+static int clif_getareachar_priority(struct map_session_data* sd, struct block_list* bl)
+{
+	struct unit_data *ud;
+	int tier = 2;
+
+	if (bl->type == BL_PC) {
+		TBL_PC *tsd = (TBL_PC*)bl;
+
+		if ((sd->status.party_id && tsd->status.party_id == sd->status.party_id) ||
+			(sd->status.guild_id && tsd->status.guild_id == sd->status.guild_id))
+			tier = 0;
+	} else if (battle_get_master(bl) == &sd->bl)
+		tier = 0;
+	if (tier == 2 && (ud = unit_bl2ud(bl)) != NULL && (ud->target == sd->bl.id || sd->ud.target == bl->id ||
+		ud->attacktimer != INVALID_TIMER || ud->skilltimer != INVALID_TIMER))
+		tier = 1;
+	return (tier<<16)|distance_bl(&sd->bl, bl);
+}
+
+static int clif_getareachar_collect(struct block_list* bl,va_list ap)
+{
+	struct map_session_data *sd = va_arg(ap,struct map_session_data*);
+
+	if (&sd->bl == bl)
+		return 0;
+	if (areachar_count == areachar_max) {
+		areachar_max += 256;
+		RECREATE(areachar_list, struct s_areachar, areachar_max);
+	}
+	areachar_list[areachar_count].bl = bl;
+	areachar_list[areachar_count].priority = clif_getareachar_priority(sd, bl);
+	areachar_count++;
+	return 1;
+}
+
+static int clif_getareachar_cmp(const void* a, const void* b)
+{
+	return ((const struct s_areachar*)a)->priority - ((const struct s_areachar*)b)->priority;
+}
+
+/// Drops the units still waiting to be shown to sd.
+void clif_getareachar_clear(struct map_session_data* sd)
+{
+	nullpo_retv(sd);
+
+	if (sd->areachar.timer != INVALID_TIMER) {
+		delete_timer(sd->areachar.timer, clif_getareachar_timer);
+		sd->areachar.timer = INVALID_TIMER;
+	}
+	if (sd->areachar.id) {
+		aFree(sd->areachar.id);
+		sd->areachar.id = NULL;
+	}
+	sd->areachar.count = sd->areachar.pos = 0;
+}
+
+/// Shows the next area_char_budget units waiting in sd->areachar, if they are still in sight.
+int clif_getareachar_timer(int tid, unsigned int tick, int id, intptr_t data)
+{
+	struct map_session_data *sd = map_id2sd(id);
+	int i = 0;
+
+	if (sd == NULL || sd->areachar.timer != tid)
+		return 0;
+	sd->areachar.timer = INVALID_TIMER;
+	if (!sd->fd || sd->bl.prev == NULL) { //Left the map, everything is sent again on arrival
+		clif_getareachar_clear(sd);
+		return 0;
+	}
+	while (i < battle_config.area_char_budget && sd->areachar.pos < sd->areachar.count) {
+		struct block_list *bl = map_id2bl(sd->areachar.id[sd->areachar.pos++]);
+
+		if (bl == NULL || bl->prev == NULL || bl->m != sd->bl.m ||
+			abs(bl->x - sd->bl.x) > AREA_SIZE || abs(bl->y - sd->bl.y) > AREA_SIZE)
+			continue; //Gone or out of sight meanwhile
+		clif_getareachar_sub(sd, bl);
+		i++;
+	}
+	if (sd->areachar.pos < sd->areachar.count)
+		sd->areachar.timer = add_timer(tick + battle_config.area_char_interval, clif_getareachar_timer, sd->bl.id, 0);
+	else
+		clif_getareachar_clear(sd);
 	return 0;
 }
 
+/*==========================================
+ * Shows everything around sd, on arrival on a map or on refresh.
+ * With area_char_budget only that many units are sent at once, the most relevant first,
+ * the others follow every area_char_interval ms.
+ *------------------------------------------*/
+void clif_getareachar_all(struct map_session_data* sd)
+{
+	int i, n;
+
+	nullpo_retv(sd);
+
+	clif_getareachar_clear(sd);
+	if (!sd->fd)
+		return;
+
+	//Must use foreachinarea (CIRCULAR_AREA interferes with foreachinrange)
+	if (!battle_config.area_char_budget) {
+		map_foreachinarea(clif_getareachar,sd->bl.m,sd->bl.x-AREA_SIZE,sd->bl.y-AREA_SIZE,sd->bl.x+AREA_SIZE,sd->bl.y+AREA_SIZE,BL_ALL,sd);
+		return;
+	}
+
+	areachar_count = 0;
+	map_foreachinarea(clif_getareachar_collect,sd->bl.m,sd->bl.x-AREA_SIZE,sd->bl.y-AREA_SIZE,sd->bl.x+AREA_SIZE,sd->bl.y+AREA_SIZE,BL_ALL,sd);
+	if (areachar_count > battle_config.area_char_budget)
+		qsort(areachar_list, areachar_count, sizeof(struct s_areachar), clif_getareachar_cmp);
+	for (i = 0; i < areachar_count && i < battle_config.area_char_budget; i++)
+		clif_getareachar_sub(sd, areachar_list[i].bl);
+	if ((n = areachar_count - i) <= 0)
+		return;
+	CREATE(sd->areachar.id, int, n);
+	for (n = 0; i < areachar_count; i++, n++)
+		sd->areachar.id[n] = areachar_list[i].bl->id;
+	sd->areachar.count = n;
+	sd->areachar.timer = add_timer(gettick() + battle_config.area_char_interval, clif_getareachar_timer, sd->bl.id, 0);
+}
+
 /*==========================================
  * tbl has gone out of view-size of bl
  *------------------------------------------*/
@@ -6699,7 +7017,7 @@ void clif_parse_BankOpen(int fd, struct map_session_data* sd) {
 		clif_colormes(sd,color_table[COLOR_RED],msg_txt(1512)); // Banking is disabled in this map
 		return;
 	} else {
-		struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+		struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 		int aid = RFIFOL(fd,info->pos[0]); //Unused should we check vs fd ?
 
 		if(sd->status.account_id == aid) {
@@ -6731,7 +7049,7 @@ void clif_bank_close(struct map_session_data *sd) {
  * 09B8 <aid>L ??? (Dunno just wild guess checkme)
  */
 void clif_parse_BankClose(int fd, struct map_session_data* sd) {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int aid = RFIFOL(fd,info->pos[0]); //Unused should we check vs fd?
 
 	nullpo_retv(sd);
@@ -6762,7 +7080,7 @@ void clif_Bank_Check(struct map_session_data* sd) {
 	cmd = packet_db_ack[sd->packet_ver][ZC_BANKING_CHECK];
 	if(!cmd)
 		cmd = 0x9a6; //Default
-	info = &packet_db[sd->packet_ver][cmd]; 
+	info = &sd->packet_db[cmd]; 
 	len = info->len;
 	if(!len)
 		return; //Version as packet disable
@@ -6787,7 +7105,7 @@ void clif_parse_BankCheck(int fd, struct map_session_data* sd) {
 		clif_colormes(sd,color_table[COLOR_RED],msg_txt(1512)); // Banking is disabled in this map
 		return;
 	} else {
-		struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+		struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 		int aid = RFIFOL(fd,info->pos[0]); //Unused should we check vs fd ?
 
 		if(sd->status.account_id == aid) //Since we have it let check it for extra security
@@ -6810,7 +7128,7 @@ void clif_bank_deposit(struct map_session_data *sd, enum e_BANKING_DEPOSIT_ACK r
 	cmd = packet_db_ack[sd->packet_ver][ZC_ACK_BANKING_DEPOSIT];
 	if(!cmd)
 		cmd = 0x9a8;
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	len = info->len;
 	if(!len)
 		return; //Version as packet disable
@@ -6836,7 +7154,7 @@ void clif_parse_BankDeposit(int fd, struct map_session_data* sd) {
 		clif_colormes(sd,color_table[COLOR_RED],msg_txt(1512)); // Banking is disabled in this map
 		return;
 	} else {
-		struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+		struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 		int aid = RFIFOL(fd,info->pos[0]); //Unused should we check vs fd ?
 		int money = RFIFOL(fd,info->pos[1]);
 
@@ -6863,7 +7181,7 @@ void clif_bank_withdraw(struct map_session_data *sd,enum e_BANKING_WITHDRAW_ACK
 	cmd = packet_db_ack[sd->packet_ver][ZC_ACK_BANKING_WITHDRAW];
 	if(!cmd)
 		cmd = 0x9aa;
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	len = info->len;
 	if(!len)
 		return; //Version as packet disable
@@ -6888,7 +7206,7 @@ void clif_parse_BankWithdraw(int fd, struct map_session_data* sd) {
 		clif_colormes(sd,color_table[COLOR_RED],msg_txt(1512)); // Banking is disabled in this map
 		return;
 	} else {
-		struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+		struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 		int aid = RFIFOL(fd,info->pos[0]); //Unused should we check vs fd ?
 		int money = RFIFOL(fd,info->pos[1]);
 
@@ -7400,17 +7718,22 @@ void clif_party_message(struct party_data* p, int account_id, const char* mes, i
 
 /// Updates the position of a party member on the minimap (ZC_NOTIFY_POSITION_TO_GROUPM).
 /// 0107 <account id>.L <x>.W <y>.W
+static int clif_party_xy_sub(unsigned char *buf, struct map_session_data *sd)
+{
+	WBUFW(buf,0) = 0x107;
+	WBUFL(buf,2) = sd->status.account_id;
+	WBUFW(buf,6) = sd->bl.x;
+	WBUFW(buf,8) = sd->bl.y;
+	return packet_len(0x107);
+}
+
 void clif_party_xy(struct map_session_data *sd)
 {
 	unsigned char buf[16];
 
 	nullpo_retv(sd);
 
-	WBUFW(buf,0) = 0x107;
-	WBUFL(buf,2) = sd->status.account_id;
-	WBUFW(buf,6) = sd->bl.x;
-	WBUFW(buf,8) = sd->bl.y;
-	clif_send(buf,packet_len(0x107),&sd->bl,PARTY_SAMEMAP_WOS);
+	clif_send(buf,clif_party_xy_sub(buf,sd),&sd->bl,PARTY_SAMEMAP_WOS);
 }
 
 
@@ -7433,17 +7756,14 @@ void clif_party_xy_single(int fd, struct map_session_data *sd)
 /// Updates HP bar of a party member.
 /// 0106 <account id>.L <hp>.W <max hp>.W (ZC_NOTIFY_HP_TO_GROUPM)
 /// 080e <account id>.L <hp>.L <max hp>.L (ZC_NOTIFY_HP_TO_GROUPM_R2)
-void clif_party_hp(struct map_session_data *sd)
+static int clif_party_hp_sub(unsigned char *buf, struct map_session_data *sd)
 {
-	unsigned char buf[16];
 #if PACKETVER < 20100126
 	const int cmd = 0x106;
 #else
 	const int cmd = 0x80e;
 #endif
 
-	nullpo_retv(sd);
-
 	WBUFW(buf,0) = cmd;
 	WBUFL(buf,2) = sd->status.account_id;
 #if PACKETVER < 20100126
@@ -7458,7 +7778,82 @@ void clif_party_hp(struct map_session_data *sd)
 	WBUFL(buf,6) = sd->battle_status.hp;
 	WBUFL(buf,10) = sd->battle_status.max_hp;
 #endif
-	clif_send(buf,packet_len(cmd),&sd->bl,PARTY_AREA_WOS);
+	return packet_len(cmd);
+}
+
+void clif_party_hp(struct map_session_data *sd)
+{
+	unsigned char buf[16];
+
+	nullpo_retv(sd);
+
+	clif_send(buf,clif_party_hp_sub(buf,sd),&sd->bl,PARTY_AREA_WOS);
+}
+
+
+/// Queues the pending party entries for one recipient with a single write.
+/// Members only see the members on their map (hp bars within their area), spies see everything.
+static void clif_party_xy_batch_sub(struct map_session_data *sd, struct party_data *p, const uint8 *flag, bool spy, struct s_xy_stats *stats)
+{
+	unsigned char buf[MAX_PARTY * 24];
+	int i, len = 0, count = 0, fd = sd->fd;
+
+	for( i = 0; i < MAX_PARTY; i++ ) {
+		struct map_session_data *tsd = p->data[i].sd;
+		int n;
+
+		if( !flag[i] || !tsd || tsd == sd )
+			continue;
+		if( !spy && tsd->bl.m != sd->bl.m )
+			continue;
+		if( flag[i]&XY_UPDATE_POS ) {
+			n = clif_party_xy_sub(WBUFP(buf,len), tsd);
+			if( packet_exists(sd->packet_ver, RBUFW(buf,len)) ) {
+				len += n;
+				count++;
+			}
+		}
+		if( (flag[i]&XY_UPDATE_HP) && (spy || (abs(tsd->bl.x - sd->bl.x) <= AREA_SIZE && abs(tsd->bl.y - sd->bl.y) <= AREA_SIZE)) ) {
+			n = clif_party_hp_sub(WBUFP(buf,len), tsd);
+			if( packet_exists(sd->packet_ver, RBUFW(buf,len)) ) {
+				len += n;
+				count++;
+			}
+		}
+	}
+	if( !len )
+		return;
+	WFIFOHEAD(fd,len);
+	memcpy(WFIFOP(fd,0), buf, len);
+	WFIFOSET(fd,len);
+	stats->writes++;
+	stats->packets += count;
+	stats->bytes += len;
+}
+
+
+/// Sends the minimap dots and hp bars that changed since the last party update (see party_send_xy_timer).
+/// flag[i] holds the e_xy_update entries of p->data[i]; every member gets its entries coalesced into one write.
+void clif_party_xy_batch(struct party_data *p, const uint8 *flag, struct s_xy_stats *stats)
+{
+	struct map_session_data *sd;
+	int i;
+
+	nullpo_retv(p);
+
+	for( i = 0; i < MAX_PARTY; i++ ) {
+		if( (sd = p->data[i].sd) != NULL && sd->fd )
+			clif_party_xy_batch_sub(sd, p, flag, false, stats);
+	}
+	if( enable_spy ) {
+		struct s_mapiterator *iter = mapit_getallusers();
+
+		while( (sd = (TBL_PC *)mapit_next(iter)) != NULL ) {
+			if( sd->partyspy == p->party.party_id )
+				clif_party_xy_batch_sub(sd, p, flag, true, stats);
+		}
+		mapit_free(iter);
+	}
 }
 
 
@@ -7628,8 +8023,11 @@ void clif_send_petdata(struct map_session_data* sd, struct pet_data* pd, int typ
 	WBUFL(buf,7) = param;
 	if (sd)
 		clif_send(buf, packet_len(0x1a4), &sd->bl, SELF);
-	else
+	else {
+		if (type == 3) //Accessory changed
+			clif_clearviewcache(&pd->bl);
 		clif_send(buf, packet_len(0x1a4), &pd->bl, AREA);
+	}
 }
 
 
@@ -9155,7 +9553,7 @@ void clif_refresh(struct map_session_data *sd)
 	}
 	if( sd->ed )
 		clif_elemental_info(sd);
-	map_foreachinrange(clif_getareachar, &sd->bl, AREA_SIZE, BL_ALL, sd);
+	clif_getareachar_all(sd);
 	clif_weather_check(sd);
 	if( sd->chatID )
 		chat_leavechat(sd, 0);
@@ -9190,6 +9588,9 @@ void clif_charnameack(int fd, struct block_list *bl)
 
 	nullpo_retv(bl);
 
+	if (fd == 0) //Name changed
+		clif_clearviewcache(bl);
+
 	WBUFW(buf,0) = cmd;
 	WBUFL(buf,2) = bl->id;
 
@@ -9693,7 +10094,7 @@ static bool clif_process_message(struct map_session_data* sd, int format, char**
 	char *text, *name, *message;
 	unsigned int packetlen, textlen, namelen, messagelen;
 	int fd = sd->fd;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	*name_ = NULL;
 	*namelen_ = 0;
@@ -9920,8 +10321,8 @@ void clif_parse_WantToConnection(int fd, struct map_session_data* sd)
 	}
 
 	CREATE(sd, TBL_PC, 1);
+	pc_init_data(sd, packet_ver);
 	sd->fd = fd;
-	sd->packet_ver = packet_ver;
 #ifdef PACKET_OBFUSCATION
 	sd->cryptKey = (((((clif_cryptKey[0] * clif_cryptKey[1]) + clif_cryptKey[2])&0xFFFFFFFF) * clif_cryptKey[1]) + clif_cryptKey[2])&0xFFFFFFFF;
 #endif
@@ -10004,8 +10405,11 @@ void clif_parse_LoadEndAck(int fd,struct map_session_data *sd) {
 			pc_setinvincibletimer(sd,battle_config.pc_invincible_time);
 	}
 
-	if(map[sd->bl.m].users++ == 0 && battle_config.dynamic_mobs)
-		map_spawnmobs(sd->bl.m);
+	if(map[sd->bl.m].users++ == 0) {
+		if(battle_config.dynamic_mobs)
+			map_spawnmobs(sd->bl.m);
+		mob_thaw_map(sd->bl.m);
+	}
 
 	if(pc_has_permission(sd,PC_PERM_VIEW_HPMETER)) {
 		map[sd->bl.m].hpmeter_visible++;
@@ -10055,8 +10459,7 @@ void clif_parse_LoadEndAck(int fd,struct map_session_data *sd) {
 		clif_map_property(sd,MAPPROPERTY_AGITZONE);
 
 	//Info about nearby objects
-	//Must use foreachinarea (CIRCULAR_AREA interferes with foreachinrange)
-	map_foreachinarea(clif_getareachar,sd->bl.m,sd->bl.x-AREA_SIZE,sd->bl.y-AREA_SIZE,sd->bl.x+AREA_SIZE,sd->bl.y+AREA_SIZE,BL_ALL,sd);
+	clif_getareachar_all(sd);
 
 	//Pet
 	if(sd->pd) {
@@ -10343,7 +10746,7 @@ void clif_notify_time(struct map_session_data* sd, unsigned long time)
 /// There are various variants of this packet, some of them have padding between fields.
 void clif_parse_TickSend(int fd, struct map_session_data *sd)
 {
-	sd->client_tick = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	sd->client_tick = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	clif_notify_time(sd, gettick());
 }
@@ -10380,7 +10783,7 @@ void clif_hotkeys_send(struct map_session_data *sd) {
 void clif_parse_Hotkey(int fd, struct map_session_data *sd) {
 #ifdef HOTKEY_SAVING
 	unsigned short idx;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	idx = RFIFOW(fd,info->pos[0]);
 	if (idx >= MAX_HOTKEYS) return;
@@ -10455,7 +10858,7 @@ void clif_parse_WalkToXY(int fd, struct map_session_data *sd)
 	if(sd->sc.data[SC_RUN] || sd->sc.data[SC_WUGDASH])
 		return;
 
-	RFIFOPOS(fd, packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0], &x, &y, NULL);
+	RFIFOPOS(fd, sd->packet_db[RFIFOW(fd,0)].pos[0], &x, &y, NULL);
 
 	//A move command one cell west is only valid if the target cell is free
 	if(battle_config.official_cell_stack_limit && sd->bl.x == x + 1 && sd->bl.y == y &&
@@ -10498,7 +10901,7 @@ void clif_disconnect_ack(struct map_session_data* sd, short result)
 void clif_parse_QuitGame(int fd, struct map_session_data *sd)
 {
 	//Rovert's prevent logout option fixed [Valaris]
-	//int type = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	//int type = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	if( !sd->sc.data[SC_CLOAKING] && !sd->sc.data[SC_HIDING] && !sd->sc.data[SC_CHASEWALK] && !sd->sc.data[SC_CLOAKINGEXCEED] &&
 		(!battle_config.prevent_logout || DIFF_TICK(gettick(), sd->canlog_tick) > battle_config.prevent_logout) )
 	{
@@ -10516,7 +10919,7 @@ void clif_parse_QuitGame(int fd, struct map_session_data *sd)
 /// There are various variants of this packet, some of them have padding between fields.
 void clif_parse_GetCharNameRequest(int fd, struct map_session_data *sd)
 {
-	int id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	struct block_list* bl;
 	//struct status_change *sc;
 	
@@ -10556,7 +10959,7 @@ void clif_parse_GetCharNameRequest(int fd, struct map_session_data *sd)
 /// There are various variants of this packet.
 void clif_parse_GlobalMessage(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int textlen = RFIFOW(fd,info->pos[0]) - 4;
 	const char* text = (char*)RFIFOP(fd,info->pos[1]);
 
@@ -10666,7 +11069,7 @@ void clif_parse_MapMove(int fd, struct map_session_data *sd)
 {
 	char command[MAP_NAME_LENGTH_EXT+25];
 	char* map_name;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	map_name = (char*)RFIFOP(fd,info->pos[0]);
 	map_name[MAP_NAME_LENGTH_EXT - 1]='\0';
@@ -10718,7 +11121,7 @@ void clif_changed_dir(struct block_list *bl, enum send_target target)
 void clif_parse_ChangeDir(int fd, struct map_session_data *sd)
 {
 	unsigned char headdir, dir;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	headdir = RFIFOB(fd,info->pos[0]);
 	dir = RFIFOB(fd,info->pos[1]);
@@ -10734,7 +11137,7 @@ void clif_parse_ChangeDir(int fd, struct map_session_data *sd)
 ///     @see enum emotion_type
 void clif_parse_Emotion(int fd, struct map_session_data *sd)
 {
-	int emoticon = RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int emoticon = RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	if (battle_config.basic_skill_check == 0 || pc_checkskill(sd, NV_BASIC) >= 2) {
 		if (emoticon == E_MUTE) { // Prevent use of the mute emote [Valaris]
@@ -10880,7 +11283,7 @@ void clif_parse_ActionRequest_sub(struct map_session_data *sd, int action_type,
 /// There are various variants of this packet, some of them have padding between fields.
 void clif_parse_ActionRequest(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	clif_parse_ActionRequest_sub(sd,
 		RFIFOB(fd,info->pos[1]),
@@ -10897,7 +11300,7 @@ void clif_parse_ActionRequest(int fd, struct map_session_data *sd)
 ///     1 = char-select (disconnect)
 void clif_parse_Restart(int fd, struct map_session_data *sd)
 {
-	switch(RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0])) {
+	switch(RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[0])) {
 		case 0x00:
 			pc_respawn(sd, CLR_OUTSIGHT);
 			break;
@@ -11056,7 +11459,7 @@ void clif_parse_WisMessage(int fd, struct map_session_data* sd)
 /// 0099 <packet len>.W <text>.?B 00
 void clif_parse_Broadcast(int fd, struct map_session_data* sd) {
 	char command[CHAT_SIZE_MAX + 11];
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	unsigned int len = RFIFOW(fd,info->pos[0]) - 4;
 	char* msg = (char*)RFIFOP(fd,info->pos[1]);
 
@@ -11077,7 +11480,7 @@ void clif_parse_TakeItem(int fd, struct map_session_data *sd)
 	struct flooritem_data *fitem;
 	int map_object_id;
 
-	map_object_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	map_object_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	fitem = (struct flooritem_data*)map_id2bl(map_object_id);
 
 	do {
@@ -11108,7 +11511,7 @@ void clif_parse_TakeItem(int fd, struct map_session_data *sd)
 /// There are various variants of this packet, some of them have padding between fields.
 void clif_parse_DropItem(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int item_index  = RFIFOW(fd,info->pos[0]) - 2;
 	int item_amount = RFIFOW(fd,info->pos[1]);
 
@@ -11155,7 +11558,7 @@ void clif_parse_UseItem(int fd, struct map_session_data *sd)
 
 	//Whether the item is used or not is irrelevant, the char ain't idle [Skotlex]
 	sd->idletime = last_tick;
-	n = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]) - 2;
+	n = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]) - 2;
 
 	if (n < 0 || n >= MAX_INVENTORY)
 		return;
@@ -11171,7 +11574,7 @@ void clif_parse_UseItem(int fd, struct map_session_data *sd)
 void clif_parse_EquipItem(int fd,struct map_session_data *sd)
 {
 	int index;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if (pc_isdead(sd)) {
 		clif_clearunit_area(&sd->bl,CLR_DEAD);
@@ -11224,7 +11627,7 @@ void clif_parse_EquipItem(int fd,struct map_session_data *sd)
 void clif_parse_UnequipItem(int fd,struct map_session_data *sd)
 {
 	int index;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if (pc_isdead(sd)) {
 		clif_clearunit_area(&sd->bl,CLR_DEAD);
@@ -11251,7 +11654,7 @@ void clif_parse_UnequipItem(int fd,struct map_session_data *sd)
 void clif_parse_NpcClicked(int fd,struct map_session_data *sd)
 {
 	struct block_list *bl;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if (pc_isdead(sd)) {
 		clif_clearunit_area(&sd->bl,CLR_DEAD);
@@ -11285,7 +11688,7 @@ void clif_parse_NpcClicked(int fd,struct map_session_data *sd)
 ///     1 = sell
 void clif_parse_NpcBuySellSelected(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if (sd->state.trading)
 		return;
@@ -11315,7 +11718,7 @@ void clif_npc_buy_result(struct map_session_data* sd, unsigned char result)
 /// 00c8 <packet len>.W { <amount>.W <name id>.W }*
 void clif_parse_NpcBuyListSend(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	uint16 n = (RFIFOW(fd,info->pos[0]) - 4) / 4;
 	int result;
 
@@ -11351,7 +11754,7 @@ void clif_parse_NpcSellListSend(int fd,struct map_session_data *sd)
 {
 	int fail=0,n;
 	unsigned short *item_list;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	n = (RFIFOW(fd,info->pos[0]) - 4) / 4; //(pktlen - (cmd + len)) / listsize
 	item_list = (unsigned short*)RFIFOP(fd,info->pos[1]);
@@ -11374,7 +11777,7 @@ void clif_parse_NpcSellListSend(int fd,struct map_session_data *sd)
 ///     1 = public
 void clif_parse_CreateChatRoom(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int len = RFIFOW(fd,info->pos[0]) - 15;
 	int limit = RFIFOW(fd,info->pos[1]);
 	bool pub = (RFIFOB(fd,info->pos[2]) != 0);
@@ -11412,7 +11815,7 @@ void clif_parse_CreateChatRoom(int fd, struct map_session_data* sd)
 /// 00d9 <chat ID>.L <passwd>.8B
 void clif_parse_ChatAddMember(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int chatid = RFIFOL(fd,info->pos[0]);
 	const char* password = (char*)RFIFOP(fd,info->pos[1]); // not zero-terminated
 
@@ -11427,7 +11830,7 @@ void clif_parse_ChatAddMember(int fd, struct map_session_data* sd)
 ///     1 = public
 void clif_parse_ChatRoomStatusChange(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int len = RFIFOW(fd,info->pos[0]) - 15;
 	int limit = RFIFOW(fd,info->pos[1]);
 	bool pub = (RFIFOB(fd,info->pos[2]) != 0);
@@ -11453,8 +11856,8 @@ void clif_parse_ChatRoomStatusChange(int fd, struct map_session_data* sd)
 ///     1 = normal
 void clif_parse_ChangeChatOwner(int fd, struct map_session_data* sd)
 {
-	//int role = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
-	chat_changechatowner(sd,(char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[1]));
+	//int role = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
+	chat_changechatowner(sd,(char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[1]));
 }
 
 
@@ -11462,7 +11865,7 @@ void clif_parse_ChangeChatOwner(int fd, struct map_session_data* sd)
 /// 00e2 <name>.24B
 void clif_parse_KickFromChat(int fd,struct map_session_data *sd)
 {
-	chat_kickchat(sd,(char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	chat_kickchat(sd,(char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -11496,7 +11899,7 @@ void clif_parse_TradeRequest(int fd,struct map_session_data *sd)
 {
 	struct map_session_data *t_sd;
 	
-	t_sd = map_id2sd(RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	t_sd = map_id2sd(RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 
 	if(!sd->chatID && pc_cant_act(sd))
 		return; //You can trade while in a chatroom.
@@ -11523,7 +11926,7 @@ void clif_parse_TradeRequest(int fd,struct map_session_data *sd)
 ///     4 = rejected
 void clif_parse_TradeAck(int fd,struct map_session_data *sd)
 {
-	trade_tradeack(sd,RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	trade_tradeack(sd,RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -11531,7 +11934,7 @@ void clif_parse_TradeAck(int fd,struct map_session_data *sd)
 /// 00e8 <index>.W <amount>.L
 void clif_parse_TradeAddItem(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	short index = RFIFOW(fd,info->pos[0]);
 	int amount = RFIFOL(fd,info->pos[1]);
 
@@ -11578,7 +11981,7 @@ void clif_parse_StopAttack(int fd,struct map_session_data *sd)
 /// 0126 <index>.W <amount>.L
 void clif_parse_PutItemToCart(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if (pc_istrading(sd))
 		return;
@@ -11592,7 +11995,7 @@ void clif_parse_PutItemToCart(int fd,struct map_session_data *sd)
 /// 0127 <index>.W <amount>.L
 void clif_parse_GetItemFromCart(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if (!pc_iscarton(sd))
 		return;
@@ -11628,7 +12031,7 @@ void clif_parse_ChangeCart(int fd,struct map_session_data *sd)
 	if( pc_checkskill(sd, MC_CHANGECART) < 1 )
 		return;
 
-	type = (int)RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	type = (int)RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 #ifdef NEW_CARTS
 	if( (type == 9 && sd->status.base_level > 131) ||
 		(type == 8 && sd->status.base_level > 121) ||
@@ -11659,12 +12062,12 @@ void clif_parse_ChangeCart(int fd,struct map_session_data *sd)
 ///     Newer clients (2013-12-23 and newer) send the correct amount.
 void clif_parse_StatusUp(int fd,struct map_session_data *sd)
 {
-	int increase_amount = RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[1]);
+	int increase_amount = RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[1]);
 
 	if( increase_amount < 0 )
 		ShowDebug("clif_parse_StatusUp: Negative 'increase' value sent by client! (fd: %d, value: %d)\n",fd,increase_amount);
 
-	pc_statusup(sd,RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]),increase_amount);
+	pc_statusup(sd,RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]),increase_amount);
 }
 
 
@@ -11672,7 +12075,7 @@ void clif_parse_StatusUp(int fd,struct map_session_data *sd)
 /// 0112 <skill id>.W
 void clif_parse_SkillUp(int fd,struct map_session_data *sd)
 {
-	pc_skillup(sd,RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	pc_skillup(sd,RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 static void clif_parse_UseSkillToId_homun(struct homun_data *hd, struct map_session_data *sd, unsigned int tick, uint16 skill_id, uint16 skill_lv, int target_id)
@@ -11787,7 +12190,7 @@ void clif_parse_UseSkillToId(int fd, struct map_session_data *sd)
 	uint16 skill_id, skill_lv;
 	int tmp, target_id;
 	unsigned int tick = gettick();
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	skill_lv = RFIFOW(fd,info->pos[0]);
 	skill_id = RFIFOW(fd,info->pos[1]);
@@ -11973,7 +12376,7 @@ static void clif_parse_UseSkillToPosSub(int fd, struct map_session_data *sd, uin
 /// There are various variants of this packet, some of them have padding between fields.
 void clif_parse_UseSkillToPos(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	if (pc_cant_act(sd))
 		return;
 	if (pc_issit(sd))
@@ -11995,7 +12398,7 @@ void clif_parse_UseSkillToPos(int fd, struct map_session_data *sd)
 /// There are various variants of this packet, some of them have padding between fields.
 void clif_parse_UseSkillToPosMoreInfo(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	if (pc_cant_act(sd))
 		return;
 	if (pc_issit(sd))
@@ -12015,7 +12418,7 @@ void clif_parse_UseSkillToPosMoreInfo(int fd, struct map_session_data *sd)
 /// 011b <skill id>.W <map name>.16B
 void clif_parse_UseSkillMap(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	uint16 skill_id = RFIFOW(fd,info->pos[0]);
 	char map_name[MAP_NAME_LENGTH];
 
@@ -12048,7 +12451,7 @@ void clif_parse_RequestMemo(int fd, struct map_session_data *sd)
 /// 018e <name id>.W { <material id>.W }*3
 void clif_parse_ProduceMix(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	unsigned short nameid = RFIFOW(fd,info->pos[0]);
 	int slot1  = RFIFOW(fd,info->pos[1]);
 	int slot2  = RFIFOW(fd,info->pos[2]);
@@ -12085,7 +12488,7 @@ void clif_parse_ProduceMix(int fd, struct map_session_data *sd)
 ///     5 = GN_MAKEBOMB
 ///     6 = GN_S_PHARMACY
 void clif_parse_Cooking(int fd, struct map_session_data *sd) {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int type = RFIFOW(fd,info->pos[0]);
 	unsigned short nameid = RFIFOW(fd,info->pos[1]);
 	int amount = (sd->menuskill_val2 ? sd->menuskill_val2 : 1);
@@ -12119,11 +12522,11 @@ void clif_parse_RepairItem(int fd, struct map_session_data *sd)
 		clif_menuskill_clear(sd);
 		return;
 	}
-	skill_repairweapon(sd,RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
-	//nameid = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[1]);
-	//refine = RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[2]);
+	skill_repairweapon(sd,RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
+	//nameid = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[1]);
+	//refine = RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[2]);
 	//for(i = 0; i < MAX_SLOTS; i++)
-	//	card[i] = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[3+i]);
+	//	card[i] = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[3+i]);
 	clif_menuskill_clear(sd);
 }
 
@@ -12142,7 +12545,7 @@ void clif_parse_WeaponRefine(int fd, struct map_session_data *sd)
 		clif_menuskill_clear(sd);
 		return;
 	}
-	idx = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	idx = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	skill_weaponrefine(sd, idx - 2);
 	clif_menuskill_clear(sd);
 }
@@ -12157,7 +12560,7 @@ void clif_parse_WeaponRefine(int fd, struct map_session_data *sd)
 ///     overflows to choice%256.
 void clif_parse_NpcSelectMenu(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int npc_id = RFIFOL(fd,info->pos[0]);
 	uint8 select = RFIFOB(fd,info->pos[1]);
 
@@ -12183,7 +12586,7 @@ void clif_parse_NpcSelectMenu(int fd,struct map_session_data *sd)
 /// 00b9 <npc id>.L
 void clif_parse_NpcNextClicked(int fd,struct map_session_data *sd)
 {
-	npc_scriptcont(sd,RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]), false);
+	npc_scriptcont(sd,RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]), false);
 }
 
 
@@ -12191,7 +12594,7 @@ void clif_parse_NpcNextClicked(int fd,struct map_session_data *sd)
 /// 0143 <npc id>.L <value>.L
 void clif_parse_NpcAmountInput(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int npcid = RFIFOL(fd,info->pos[0]);
 	int amount = (int)RFIFOL(fd,info->pos[1]);
 
@@ -12204,7 +12607,7 @@ void clif_parse_NpcAmountInput(int fd,struct map_session_data *sd)
 /// 01d5 <packet len>.W <npc id>.L <string>.?B
 void clif_parse_NpcStringInput(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int message_len = RFIFOW(fd,info->pos[0])-8;
 	int npcid = RFIFOL(fd,info->pos[1]);
 	const char* message = (char*)RFIFOP(fd,info->pos[2]);
@@ -12223,7 +12626,7 @@ void clif_parse_NpcCloseClicked(int fd, struct map_session_data *sd)
 {
 	if (!sd->npc_id) //Avoid parsing anything when the script was done with. [Skotlex]
 		return;
-	npc_scriptcont(sd, RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]), true);
+	npc_scriptcont(sd, RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]), true);
 }
 
 
@@ -12233,7 +12636,7 @@ void clif_parse_NpcCloseClicked(int fd, struct map_session_data *sd)
 ///     -1 = cancel
 void clif_parse_ItemIdentify(int fd, struct map_session_data *sd)
 {
-	short idx = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	short idx = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	if (sd->menuskill_id != MC_IDENTIFY)
 		return;
@@ -12250,7 +12653,7 @@ void clif_parse_ItemIdentify(int fd, struct map_session_data *sd)
 /// 01ae <name id>.W
 void clif_parse_SelectArrow(int fd, struct map_session_data *sd)
 {
-	unsigned short nameid = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	unsigned short nameid = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	if (pc_istrading(sd)) {
 		//Make it fail to avoid shop exploits where you sell something different than you see.
@@ -12287,7 +12690,7 @@ void clif_parse_AutoSpell(int fd,struct map_session_data *sd)
 {
 	if (sd->menuskill_id != SA_AUTOSPELL)
 		return;
-	skill_autospell(sd,RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	skill_autospell(sd,RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 	clif_menuskill_clear(sd);
 }
 
@@ -12298,7 +12701,7 @@ void clif_parse_UseCard(int fd,struct map_session_data *sd)
 {
 	if (sd->state.trading != 0)
 		return;
-	clif_use_card(sd,RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0])-2);
+	clif_use_card(sd,RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0])-2);
 }
 
 
@@ -12306,7 +12709,7 @@ void clif_parse_UseCard(int fd,struct map_session_data *sd)
 /// 017c <card index>.W <equip index>.W
 void clif_parse_InsertCard(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	if (sd->state.trading != 0)
 		return;
 	pc_insert_card(sd,RFIFOW(fd,info->pos[0])-2,RFIFOW(fd,info->pos[1])-2);
@@ -12321,7 +12724,7 @@ void clif_parse_SolveCharName(int fd, struct map_session_data *sd)
 {
 	int charid;
 
-	charid = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	charid = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	map_reqnickdb(sd, charid);
 }
 
@@ -12335,7 +12738,7 @@ void clif_parse_SolveCharName(int fd, struct map_session_data *sd)
 void clif_parse_ResetChar(int fd, struct map_session_data *sd) {
 	char cmd[15];
 
-	if( RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]) )
+	if( RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]) )
 		safesnprintf(cmd, sizeof(cmd), "%cresetskill", atcommand_symbol);
 	else
 		safesnprintf(cmd, sizeof(cmd), "%cresetstat", atcommand_symbol);
@@ -12349,7 +12752,7 @@ void clif_parse_ResetChar(int fd, struct map_session_data *sd) {
 /// 019c <packet len>.W <text>.?B
 void clif_parse_LocalBroadcast(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	char command[CHAT_SIZE_MAX+16];
 	unsigned int len = RFIFOW(fd,info->pos[0]) - 4;
 	char* msg = (char*)RFIFOP(fd,info->pos[1]);
@@ -12369,7 +12772,7 @@ void clif_parse_LocalBroadcast(int fd, struct map_session_data* sd)
 void clif_parse_MoveToKafra(int fd, struct map_session_data *sd)
 {
 	int item_index, item_amount;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if (pc_istrading(sd))
 		return;
@@ -12393,7 +12796,7 @@ void clif_parse_MoveToKafra(int fd, struct map_session_data *sd)
 void clif_parse_MoveFromKafra(int fd,struct map_session_data *sd)
 {
 	int item_index, item_amount;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	item_index = RFIFOW(fd,info->pos[0])-1;
 	item_amount = RFIFOL(fd,info->pos[1]);
@@ -12409,7 +12812,7 @@ void clif_parse_MoveFromKafra(int fd,struct map_session_data *sd)
 /// 0129 <index>.W <amount>.L
 void clif_parse_MoveToKafraFromCart(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	int idx = RFIFOW(fd,info->pos[0]) - 2;
 	int amount = RFIFOL(fd,info->pos[1]);
@@ -12430,7 +12833,7 @@ void clif_parse_MoveToKafraFromCart(int fd, struct map_session_data *sd)
 /// 0128 <index>.W <amount>.L
 void clif_parse_MoveFromKafraToCart(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int idx = RFIFOW(fd,info->pos[0]) - 1;
 	int amount = RFIFOL(fd,info->pos[1]);
 
@@ -12485,7 +12888,7 @@ void clif_storagepassword(struct map_session_data* sd, short info)
 void clif_parse_StoragePassword(int fd, struct map_session_data *sd)
 {
 //@TODO
-//	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+//	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 //	int type = RFIFOW(fd,info->pos[0]);
 //	char* password = RFIFOP(fd,info->pos[1]);
 //	char* new_password = RFIFOP(fd,info->pos[2]);
@@ -12519,7 +12922,7 @@ void clif_storagepassword_result(struct map_session_data* sd, short result, shor
 /// 00f9 <party name>.24B (CZ_MAKE_GROUP)
 void clif_parse_CreateParty(int fd, struct map_session_data *sd)
 {
-	char* name = (char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	char* name = (char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	name[NAME_LENGTH-1] = '\0';
 
 	if( map[sd->bl.m].flag.partylock ) { // Party locked.
@@ -12537,7 +12940,7 @@ void clif_parse_CreateParty(int fd, struct map_session_data *sd)
 /// 01e8 <party name>.24B <item pickup rule>.B <item share rule>.B (CZ_MAKE_GROUP2)
 void clif_parse_CreateParty2(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	char* name = (char*)RFIFOP(fd,info->pos[0]);
 	int item1 = RFIFOB(fd,info->pos[1]);
 	int item2 = RFIFOB(fd,info->pos[2]);
@@ -12567,7 +12970,7 @@ void clif_parse_PartyInvite(int fd, struct map_session_data *sd)
 		return;
 	}
 
-	t_sd = map_id2sd(RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	t_sd = map_id2sd(RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 
 	if(t_sd && t_sd->state.noask) { // @noask [LuzZza]
 		clif_noask_sub(sd, t_sd, 1);
@@ -12581,7 +12984,7 @@ void clif_parse_PartyInvite(int fd, struct map_session_data *sd)
 void clif_parse_PartyInvite2(int fd, struct map_session_data *sd)
 {
 	struct map_session_data *t_sd;
-	char *name = (char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	char *name = (char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	name[NAME_LENGTH-1] = '\0';
 
 	if(map[sd->bl.m].flag.partylock) { // Party locked.
@@ -12608,14 +13011,14 @@ void clif_parse_PartyInvite2(int fd, struct map_session_data *sd)
 ///     1 = accept
 void clif_parse_ReplyPartyInvite(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	party_reply_invite(sd,RFIFOL(fd,info->pos[0]),
 	    RFIFOL(fd,info->pos[1]));
 }
 //(CZ_PARTY_JOIN_REQ_ACK)
 void clif_parse_ReplyPartyInvite2(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	party_reply_invite(sd,RFIFOL(fd,info->pos[0]),
 	    RFIFOB(fd,info->pos[1]));
 }
@@ -12637,7 +13040,7 @@ void clif_parse_LeaveParty(int fd, struct map_session_data *sd)
 /// 0103 <account id>.L <char name>.24B
 void clif_parse_RemovePartyMember(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	if(map[sd->bl.m].flag.partylock) { //Party locked.
 		clif_displaymessage(fd, msg_txt(227));
 		return;
@@ -12655,7 +13058,7 @@ void clif_parse_PartyChangeOption(int fd, struct map_session_data *sd)
 	struct party_data *p;
 	int i,expflag;
 	int cmd = RFIFOW(fd,0);
-	struct s_packet_db* info = &packet_db[sd->packet_ver][cmd];
+	struct s_packet_db* info = &sd->packet_db[cmd];
 
 	if( !sd->status.party_id )
 		return;
@@ -12683,7 +13086,7 @@ void clif_parse_PartyChangeOption(int fd, struct map_session_data *sd)
 /// 0108 <packet len>.W <text>.?B (<name> : <message>) 00
 void clif_parse_PartyMessage(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int textlen = RFIFOW(fd,info->pos[0]) - 4;
 	const char* text = (char*)RFIFOP(fd,info->pos[1]);
 
@@ -12717,7 +13120,7 @@ void clif_parse_PartyMessage(int fd, struct map_session_data* sd)
 /// 07da <account id>.L
 void clif_parse_PartyChangeLeader(int fd, struct map_session_data* sd)
 {
-	party_changeleader(sd, map_id2sd(RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0])), NULL);
+	party_changeleader(sd, map_id2sd(RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0])), NULL);
 }
 
 void clif_PartyLeaderChanged(struct map_session_data *sd, int prev_leader_aid, int new_leader_aid)
@@ -12740,7 +13143,7 @@ void clif_PartyLeaderChanged(struct map_session_data *sd, int prev_leader_aid, i
 /// 0802 <level>.W <map id>.W { <job>.W }*6
 void clif_parse_PartyBookingRegisterReq(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	short level = RFIFOW(fd,info->pos[0]);
 	short mapid = RFIFOW(fd,info->pos[1]);
 	int idxpbj = info->pos[2];
@@ -12775,7 +13178,7 @@ void clif_PartyBookingRegisterAck(struct map_session_data *sd, int flag)
 /// 0804 <level>.W <map id>.W <job>.W <last index>.L <result count>.W
 void clif_parse_PartyBookingSearchReq(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	short level = RFIFOW(fd,info->pos[0]);
 	short mapid = RFIFOW(fd,info->pos[1]);
 	short job = RFIFOW(fd,info->pos[2]);
@@ -12847,7 +13250,7 @@ void clif_parse_PartyBookingUpdateReq(int fd, struct map_session_data* sd)
 {
 	short job[PARTY_BOOKING_JOBS];
 	int i;
-	int idxpbu = packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0];
+	int idxpbu = sd->packet_db[RFIFOW(fd,0)].pos[0];
 	
 	for(i = 0; i < PARTY_BOOKING_JOBS; i++)
 		job[i] = RFIFOW(fd,idxpbu + i * 2);
@@ -12923,7 +13326,7 @@ void clif_parse_VendingListReq(int fd, struct map_session_data* sd)
 	if( sd->npc_id ) // Using an NPC
 		return;
 
-	vending_vendinglistreq(sd,RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	vending_vendinglistreq(sd,RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -12931,7 +13334,7 @@ void clif_parse_VendingListReq(int fd, struct map_session_data* sd)
 /// 0134 <packet len>.W <account id>.L { <amount>.W <index>.W }*
 void clif_parse_PurchaseReq(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int len = (int)RFIFOW(fd,info->pos[0]) - 8;
 	int id = (int)RFIFOL(fd,info->pos[1]);
 	const uint8* data = (uint8*)RFIFOP(fd,info->pos[2]);
@@ -12947,7 +13350,7 @@ void clif_parse_PurchaseReq(int fd, struct map_session_data* sd)
 /// 0801 <packet len>.W <account id>.L <unique id>.L { <amount>.W <index>.W }*
 void clif_parse_PurchaseReq2(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int len = (int)RFIFOW(fd,info->pos[0]) - 12;
 	int aid = (int)RFIFOL(fd,info->pos[1]);
 	int uid = (int)RFIFOL(fd,info->pos[2]);
@@ -12969,7 +13372,7 @@ void clif_parse_PurchaseReq2(int fd, struct map_session_data* sd)
 void clif_parse_OpenVending(int fd, struct map_session_data* sd)
 {
 	int cmd = RFIFOW(fd,0);
-	struct s_packet_db* info = &packet_db[sd->packet_ver][cmd];
+	struct s_packet_db* info = &sd->packet_db[cmd];
 	short len = (short)RFIFOW(fd,info->pos[0]);
 	const char* message = (char*)RFIFOP(fd,info->pos[1]);
 	const uint8* data = (uint8*)RFIFOP(fd,info->pos[3]);
@@ -13005,8 +13408,8 @@ void clif_parse_OpenVending(int fd, struct map_session_data* sd)
 /// 0165 <char id>.L <guild name>.24B
 void clif_parse_CreateGuild(int fd,struct map_session_data *sd)
 {
-	//int charid = RFIFOL(fd,packet_db[sd->packet_ver][cmd].pos[0]);
-	char* name = (char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[1]);
+	//int charid = RFIFOL(fd,sd->packet_db[cmd].pos[0]);
+	char* name = (char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[1]);
 	name[NAME_LENGTH-1] = '\0';
 
 	if(map[sd->bl.m].flag.guildlock) { //Guild locked.
@@ -13038,7 +13441,7 @@ void clif_parse_GuildCheckMaster(int fd, struct map_session_data *sd)
 ///     6 = notice
 void clif_parse_GuildRequestInfo(int fd, struct map_session_data *sd)
 {
-	int type = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int type = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	if( !sd->status.guild_id && !sd->bg_id )
 		return;
 
@@ -13073,7 +13476,7 @@ void clif_parse_GuildRequestInfo(int fd, struct map_session_data *sd)
 void clif_parse_GuildChangePositionInfo(int fd, struct map_session_data *sd)
 {
 	int i;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int len = RFIFOW(fd,info->pos[0]);
 	int idxgpos = info->pos[1];
 
@@ -13090,7 +13493,7 @@ void clif_parse_GuildChangePositionInfo(int fd, struct map_session_data *sd)
 void clif_parse_GuildChangeMemberPosition(int fd, struct map_session_data *sd)
 {
 	int i;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int len = RFIFOW(fd,info->pos[0]);
 	int idxgpos = info->pos[1];
 	
@@ -13107,7 +13510,7 @@ void clif_parse_GuildChangeMemberPosition(int fd, struct map_session_data *sd)
 void clif_parse_GuildRequestEmblem(int fd,struct map_session_data *sd)
 {
 	struct guild* g;
-	int guild_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int guild_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	if( (g = guild_search(guild_id)) != NULL )
 		clif_guild_emblem(sd,g);
@@ -13147,7 +13550,7 @@ static bool clif_validate_emblem(const uint8* emblem, unsigned long emblem_len)
 /// Request to update the guild emblem (CZ_REGISTER_GUILD_EMBLEM_IMG).
 /// 0153 <packet len>.W <emblem data>.?B
 void clif_parse_GuildChangeEmblem(int fd,struct map_session_data *sd) {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	unsigned long emblem_len = RFIFOW(fd,info->pos[0]) - 4;
 	const uint8* emblem = RFIFOP(fd,info->pos[1]);
 	int emb_val = 0;
@@ -13179,7 +13582,7 @@ void clif_parse_GuildChangeEmblem(int fd,struct map_session_data *sd) {
 /// 016e <guild id>.L <msg1>.60B <msg2>.120B
 void clif_parse_GuildChangeNotice(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int guild_id = RFIFOL(fd,info->pos[0]);
 	char* msg1 = (char*)RFIFOP(fd,info->pos[1]);
 	char* msg2 = (char*)RFIFOP(fd,info->pos[2]);
@@ -13221,7 +13624,7 @@ int clif_sub_guild_invite(int fd, struct map_session_data *sd, struct map_sessio
 /// 0168 <account id>.L <inviter account id>.L <inviter char id>.L
 void clif_parse_GuildInvite(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	struct map_session_data *t_sd = map_id2sd(RFIFOL(fd,info->pos[0]));
 //	int inv_aid = RFIFOL(fd,info->pos[1]);
 //	int inv_cid = RFIFOL(fd,info->pos[2]);
@@ -13235,7 +13638,7 @@ void clif_parse_GuildInvite(int fd,struct map_session_data *sd)
 /// 0916 <char name>.24B (CZ_REQ_JOIN_GUILD2)
 void clif_parse_GuildInvite2(int fd, struct map_session_data *sd)
 {
-	struct map_session_data *t_sd = map_nick2sd((char *)RFIFOP(fd, packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	struct map_session_data *t_sd = map_nick2sd((char *)RFIFOP(fd, sd->packet_db[RFIFOW(fd,0)].pos[0]));
 
 	if (clif_sub_guild_invite(fd, sd, t_sd))
 		return;
@@ -13249,7 +13652,7 @@ void clif_parse_GuildInvite2(int fd, struct map_session_data *sd)
 ///     1 = accept
 void clif_parse_GuildReplyInvite(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	guild_reply_invite(sd,RFIFOL(fd,info->pos[0]),
 	    RFIFOL(fd,info->pos[1]));
 }
@@ -13259,7 +13662,7 @@ void clif_parse_GuildReplyInvite(int fd,struct map_session_data *sd)
 /// 0159 <guild id>.L <account id>.L <char id>.L <reason>.40B
 void clif_parse_GuildLeave(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	if(map[sd->bl.m].flag.guildlock) { //Guild locked
 		clif_displaymessage(fd, msg_txt(228));
 		return;
@@ -13280,7 +13683,7 @@ void clif_parse_GuildLeave(int fd,struct map_session_data *sd)
 /// 015b <guild id>.L <account id>.L <char id>.L <reason>.40B
 void clif_parse_GuildExpulsion(int fd,struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	if( map[sd->bl.m].flag.guildlock || sd->bg_id ) { // Guild locked.
 		clif_displaymessage(fd, msg_txt(228));
 		return;
@@ -13296,7 +13699,7 @@ void clif_parse_GuildExpulsion(int fd,struct map_session_data *sd)
 /// 017e <packet len>.W <text>.?B (<name> : <message>) 00
 void clif_parse_GuildMessage(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int textlen = RFIFOW(fd,info->pos[0]) - 4;
 	const char* text = (char*)RFIFOP(fd,info->pos[1]);
 
@@ -13343,9 +13746,9 @@ void clif_parse_GuildRequestAlliance(int fd, struct map_session_data *sd)
 		return;
 	}
 
-	t_sd = map_id2sd(RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
-	//inv_aid = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[1]);
-	//inv_cid = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[2]);
+	t_sd = map_id2sd(RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
+	//inv_aid = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[1]);
+	//inv_cid = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[2]);
 
 	// @noask [LuzZza]
 	if(t_sd && t_sd->state.noask) {
@@ -13364,7 +13767,7 @@ void clif_parse_GuildRequestAlliance(int fd, struct map_session_data *sd)
 ///     1 = accept
 void clif_parse_GuildReplyAlliance(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	guild_reply_reqalliance(sd,
 	    RFIFOL(fd,info->pos[0]),
 	    RFIFOL(fd,info->pos[1]));
@@ -13378,7 +13781,7 @@ void clif_parse_GuildReplyAlliance(int fd, struct map_session_data *sd)
 ///     1 = Enemy
 void clif_parse_GuildDelAlliance(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if(!sd->state.gmaster_flag)
 		return;
@@ -13406,7 +13809,7 @@ void clif_parse_GuildOpposition(int fd, struct map_session_data *sd)
 		return;
 	}
 
-	t_sd = map_id2sd(RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	t_sd = map_id2sd(RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 
 	// @noask [LuzZza]
 	if(t_sd && t_sd->state.noask) {
@@ -13429,7 +13832,7 @@ void clif_parse_GuildBreak(int fd, struct map_session_data *sd)
 		clif_displaymessage(fd, msg_txt(228));
 		return;
 	}
-	guild_break(sd,(char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	guild_break(sd,(char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -13446,7 +13849,7 @@ void clif_parse_GuildBreak(int fd, struct map_session_data *sd)
 ///     4 = unequip accessory
 void clif_parse_PetMenu(int fd, struct map_session_data *sd)
 {
-	pet_menu(sd,RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	pet_menu(sd,RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -13454,7 +13857,7 @@ void clif_parse_PetMenu(int fd, struct map_session_data *sd)
 /// 019f <id>.L
 void clif_parse_CatchPet(int fd, struct map_session_data *sd)
 {
-	pet_catch_process2(sd,RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	pet_catch_process2(sd,RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -13464,7 +13867,7 @@ void clif_parse_SelectEgg(int fd, struct map_session_data *sd)
 {
 	if (sd->menuskill_id != SA_TAMINGMONSTER || sd->menuskill_val != -1)
 		return;
-	pet_select_egg(sd,RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]) - 2);
+	pet_select_egg(sd,RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]) - 2);
 	clif_menuskill_clear(sd);
 }
 
@@ -13496,7 +13899,7 @@ void clif_parse_SelectEgg(int fd, struct map_session_data *sd)
 void clif_parse_SendEmotion(int fd, struct map_session_data *sd)
 {
 	if(sd->pd)
-		clif_pet_emotion(sd->pd,RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+		clif_pet_emotion(sd->pd,RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -13504,7 +13907,7 @@ void clif_parse_SendEmotion(int fd, struct map_session_data *sd)
 /// 01a5 <name>.24B
 void clif_parse_ChangePetName(int fd, struct map_session_data *sd)
 {
-	pet_change_name(sd,(char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	pet_change_name(sd,(char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -13517,7 +13920,7 @@ void clif_parse_GMKick(int fd, struct map_session_data *sd)
 	struct block_list *target;
 	int tid;
 
-	tid = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	tid = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	target = map_id2bl(tid);
 	if (!target) {
 		clif_GM_kickack(sd, 0);
@@ -13589,7 +13992,7 @@ void clif_parse_GMShift(int fd, struct map_session_data *sd)
 	char *player_name;
 	char command[NAME_LENGTH + 8];
 
-	player_name = (char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	player_name = (char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	player_name[NAME_LENGTH - 1] = '\0';
 	
 	safesnprintf(command, sizeof(command), "%cjumpto %s", atcommand_symbol, player_name);
@@ -13605,7 +14008,7 @@ void clif_parse_GMRemove2(int fd, struct map_session_data* sd)
 	int account_id;
 	struct map_session_data* pl_sd;
 
-	account_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	account_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	if( (pl_sd = map_id2sd(account_id)) != NULL ) {
 		char command[NAME_LENGTH + 8];
 
@@ -13627,7 +14030,7 @@ void clif_parse_GMRecall(int fd, struct map_session_data *sd)
 	char *player_name;
 	char command [NAME_LENGTH + 8];
 
-	player_name = (char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	player_name = (char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	player_name[NAME_LENGTH - 1] = '\0';
 
 	safesnprintf(command, sizeof(command), "%crecall %s", atcommand_symbol, player_name);
@@ -13643,7 +14046,7 @@ void clif_parse_GMRecall2(int fd, struct map_session_data* sd)
 	int account_id;
 	struct map_session_data* pl_sd;
 
-	account_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	account_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	if( (pl_sd = map_id2sd(account_id)) != NULL ) {
 		char command[NAME_LENGTH + 8];
 
@@ -13668,7 +14071,7 @@ void clif_parse_GMRecall2(int fd, struct map_session_data* sd)
 /// 09ce <item/mob name>.100B [Ind/Yommy]
 void clif_parse_GM_Item_Monster(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int mob_id = 0;
 	struct item_data *id = NULL;
 	struct mob_db *mob = NULL;
@@ -13737,7 +14140,7 @@ void clif_parse_GM_Item_Monster(int fd, struct map_session_data *sd)
 ///     @TODO: Any OPTION_* ?
 void clif_parse_GMHide(int fd, struct map_session_data *sd) {
 	char cmd[6];
-	//int eff_st = RFIFOL(packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	//int eff_st = RFIFOL(sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	safesnprintf(cmd, sizeof(cmd), "%chide", atcommand_symbol);	
 	is_atcommand(fd, sd, cmd, 1);
@@ -13755,7 +14158,7 @@ void clif_parse_GMReqNoChat(int fd,struct map_session_data *sd)
 	int id, type, value;
 	struct map_session_data *dstsd;
 	char command[NAME_LENGTH + 15];
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	id = RFIFOL(fd,info->pos[0]);
 	type = RFIFOB(fd,info->pos[1]);
@@ -13784,7 +14187,7 @@ void clif_parse_GMReqNoChat(int fd,struct map_session_data *sd)
 void clif_parse_GMRc(int fd, struct map_session_data* sd)
 {
 	char command[NAME_LENGTH + 15];
-	char *name = (char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	char *name = (char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	name[NAME_LENGTH - 1] = '\0';
 	safesnprintf(command, sizeof(command), "%cmute %d %s", atcommand_symbol, 60, name);
@@ -13812,7 +14215,7 @@ void clif_parse_GMReqAccountName(int fd, struct map_session_data *sd)
 {
 	if( sd->bl.type&BL_PC ) { //Only show for players
 		char command[30];
-		int account_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+		int account_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 		//Tmp get all display
 		safesnprintf(command, sizeof(command), "%caccinfo %d", atcommand_symbol, account_id);
@@ -13831,7 +14234,7 @@ void clif_parse_GMReqAccountName(int fd, struct map_session_data *sd)
 void clif_parse_GMChangeMapType(int fd, struct map_session_data *sd)
 {
 	int x,y,type;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if( !pc_has_permission(sd, PC_PERM_USE_CHANGEMAPTYPE) )
 		return;
@@ -13857,7 +14260,7 @@ void clif_parse_PMIgnore(int fd, struct map_session_data* sd)
 	char* nick;
 	uint8 type;
 	int i;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	nick = (char*)RFIFOP(fd,info->pos[0]);
 	nick[NAME_LENGTH - 1] = '\0'; // To be sure that the player name has at most 23 characters
@@ -13908,7 +14311,7 @@ void clif_parse_PMIgnore(int fd, struct map_session_data* sd)
 ///     1 = (/inall) allow all speech
 void clif_parse_PMIgnoreAll(int fd, struct map_session_data *sd)
 {
-	int type = RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]), flag;
+	int type = RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]), flag;
 
 	if( type == 0 ) { // Deny all
 		if( sd->state.ignoreAll ) {
@@ -14124,7 +14527,7 @@ void clif_parse_FriendsListAdd(int fd, struct map_session_data *sd)
 	struct map_session_data *f_sd;
 	int i;
 
-	f_sd = map_nick2sd((char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	f_sd = map_nick2sd((char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 
 	// ensure that the request player's friend list is not full
 	ARR_FIND(0, MAX_FRIENDS, i, sd->status.friends[i].char_id == 0);
@@ -14176,7 +14579,7 @@ void clif_parse_FriendsListReply(int fd, struct map_session_data *sd)
 	struct map_session_data *f_sd;
 	int account_id;
 	char reply;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	account_id = RFIFOL(fd,info->pos[0]);
 	//char_id = RFIFOL(fd,info->pos[1]);
@@ -14240,7 +14643,7 @@ void clif_parse_FriendsListRemove(int fd, struct map_session_data *sd)
 	struct map_session_data *f_sd = NULL;
 	int account_id, char_id;
 	int i, j;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	account_id = RFIFOL(fd,info->pos[0]);
 	char_id = RFIFOL(fd,info->pos[1]);
@@ -14320,8 +14723,8 @@ void clif_PVPInfo(struct map_session_data* sd)
 void clif_parse_PVPInfo(int fd,struct map_session_data *sd)
 {
 	//@TODO: Is there a way to use this on an another player (char/acc id)?
-	//int cid = RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
-	//int aid = RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[1]);
+	//int cid = RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
+	//int aid = RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[1]);
 	clif_PVPInfo(sd);
 }
 
@@ -14511,7 +14914,7 @@ void clif_parse_RankingPk(int fd,struct map_session_data *sd)
 void clif_parse_FeelSaveOk(int fd,struct map_session_data *sd)
 {
 	int i;
-	//int wich = RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	//int wich = RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	if (sd->menuskill_id != SG_FEEL)
 		return;
@@ -14552,7 +14955,7 @@ void clif_feel_req(int fd, struct map_session_data *sd, uint16 skill_lv)
 /// 0231 <name>.24B
 void clif_parse_ChangeHomunculusName(int fd, struct map_session_data *sd)
 {
-	hom_change_name(sd,(char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	hom_change_name(sd,(char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 }
 
 
@@ -14560,7 +14963,7 @@ void clif_parse_ChangeHomunculusName(int fd, struct map_session_data *sd)
 /// 0234 <id>.L
 void clif_parse_HomMoveToMaster(int fd, struct map_session_data *sd)
 {
-	int id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]); // Mercenary or Homunculus
+	int id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]); // Mercenary or Homunculus
 	struct block_list *bl = NULL;
 	struct unit_data *ud = NULL;
 
@@ -14581,7 +14984,7 @@ void clif_parse_HomMoveToMaster(int fd, struct map_session_data *sd)
 /// 0232 <id>.L <position data>.3B
 void clif_parse_HomMoveTo(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int id = RFIFOL(fd,info->pos[0]); // Mercenary or Homunculus
 	struct block_list *bl = NULL;
 	short x, y;
@@ -14606,7 +15009,7 @@ void clif_parse_HomMoveTo(int fd, struct map_session_data *sd)
 void clif_parse_HomAttack(int fd,struct map_session_data *sd)
 {
 	struct block_list *bl = NULL;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int id = RFIFOL(fd,info->pos[0]);
 	int target_id = RFIFOL(fd,info->pos[1]);
 	int action_type = RFIFOB(fd,info->pos[2]);
@@ -14634,12 +15037,12 @@ void clif_parse_HomAttack(int fd,struct map_session_data *sd)
 void clif_parse_HomMenu(int fd, struct map_session_data *sd)
 { //[orn]
 	int cmd = RFIFOW(fd,0);
-	//int type = RFIFOW(fd,packet_db[sd->packet_ver][cmd].pos[0]);
+	//int type = RFIFOW(fd,sd->packet_db[cmd].pos[0]);
 
 	if(!hom_is_active(sd->hd))
 		return;
 
-	hom_menu(sd, RFIFOB(fd,packet_db[sd->packet_ver][cmd].pos[1]));
+	hom_menu(sd, RFIFOB(fd,sd->packet_db[cmd].pos[1]));
 }
 
 
@@ -14725,7 +15128,7 @@ void clif_parse_Check(int fd, struct map_session_data *sd)
 	if(!pc_has_permission(sd, PC_PERM_USE_CHECK))
 		return;
 
-	safestrncpy(charname, (const char*)RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]), sizeof(charname));
+	safestrncpy(charname, (const char*)RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]), sizeof(charname));
 
 	if( ( pl_sd = map_nick2sd(charname) ) == NULL || pc_get_group_level(sd) < pc_get_group_level(pl_sd) )
 	{
@@ -14964,7 +15367,7 @@ void clif_Mail_read(struct map_session_data *sd, int mail_id)
 /// 0241 <mail id>.L
 void clif_parse_Mail_read(int fd, struct map_session_data *sd)
 {
-	int mail_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int mail_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	if( mail_id <= 0 )
 		return;
@@ -14979,7 +15382,7 @@ void clif_parse_Mail_read(int fd, struct map_session_data *sd)
 /// 0244 <mail id>.L
 void clif_parse_Mail_getattach(int fd, struct map_session_data *sd)
 {
-	int mail_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int mail_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	int i;
 	bool fail = false;
 
@@ -15046,7 +15449,7 @@ void clif_parse_Mail_getattach(int fd, struct map_session_data *sd)
 /// 0243 <mail id>.L
 void clif_parse_Mail_delete(int fd, struct map_session_data *sd)
 {
-	int mail_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int mail_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	int i;
 
 	if( !chrif_isconnected() )
@@ -15074,8 +15477,8 @@ void clif_parse_Mail_delete(int fd, struct map_session_data *sd)
 /// 0273 <mail id>.L <receive name>.24B
 void clif_parse_Mail_return(int fd, struct map_session_data *sd)
 {
-	int mail_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
-	//char *rec_name = RFIFOP(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[1]);
+	int mail_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
+	//char *rec_name = RFIFOP(fd,sd->packet_db[RFIFOW(fd,0)].pos[1]);
 	int i;
 
 	if( mail_id <= 0 )
@@ -15095,7 +15498,7 @@ void clif_parse_Mail_return(int fd, struct map_session_data *sd)
 /// 0247 <index>.W <amount>.L
 void clif_parse_Mail_setattach(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int idx = RFIFOW(fd,info->pos[0]);
 	int amount = RFIFOL(fd,info->pos[1]);
 	unsigned char flag;
@@ -15118,7 +15521,7 @@ void clif_parse_Mail_setattach(int fd, struct map_session_data *sd)
 ///     2 = remove zeny
 void clif_parse_Mail_winopen(int fd, struct map_session_data *sd)
 {
-	int type = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int type = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	if( type == 0 || type == 1 )
 		mail_removeitem(sd, 0);
@@ -15131,7 +15534,7 @@ void clif_parse_Mail_winopen(int fd, struct map_session_data *sd)
 /// 0248 <packet len>.W <recipient>.24B <title>.40B <body len>.B <body>.?B
 void clif_parse_Mail_send(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if( !chrif_isconnected() )
 		return;
@@ -15240,7 +15643,7 @@ static void clif_Auction_setitem(int fd, int index, bool fail)
 ///     ? = junk, uninitialized value (ex. when switching between list filters)
 void clif_parse_Auction_cancelreg(int fd, struct map_session_data *sd)
 {
-	//int type = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	//int type = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	if( sd->auction.amount > 0 )
 		clif_additem(sd, sd->auction.index, sd->auction.amount, 0);
 
@@ -15252,7 +15655,7 @@ void clif_parse_Auction_cancelreg(int fd, struct map_session_data *sd)
 /// 024c <index>.W <count>.L
 void clif_parse_Auction_setitem(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int idx = RFIFOW(fd,info->pos[0]) - 2;
 	int amount = RFIFOL(fd,info->pos[1]); //Always 1
 	struct item_data *item;
@@ -15338,7 +15741,7 @@ void clif_parse_Auction_register(int fd, struct map_session_data *sd)
 {
 	struct auction_data auction;
 	struct item_data *item;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	if( !battle_config.feature_auction )
 		return;
@@ -15420,7 +15823,7 @@ void clif_parse_Auction_register(int fd, struct map_session_data *sd)
 /// 024e <auction id>.L
 void clif_parse_Auction_cancel(int fd, struct map_session_data *sd)
 {
-	unsigned int auction_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	unsigned int auction_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	intif_Auction_cancel(sd->status.char_id, auction_id);
 }
@@ -15430,7 +15833,7 @@ void clif_parse_Auction_cancel(int fd, struct map_session_data *sd)
 /// 025d <auction id>.L
 void clif_parse_Auction_close(int fd, struct map_session_data *sd)
 {
-	unsigned int auction_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	unsigned int auction_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	intif_Auction_close(sd->status.char_id, auction_id);
 }
@@ -15440,7 +15843,7 @@ void clif_parse_Auction_close(int fd, struct map_session_data *sd)
 /// 024f <auction id>.L <money>.L
 void clif_parse_Auction_bid(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	unsigned int auction_id = RFIFOL(fd,info->pos[0]);
 	int bid = RFIFOL(fd,info->pos[1]);
 
@@ -15473,7 +15876,7 @@ void clif_parse_Auction_bid(int fd, struct map_session_data *sd)
 void clif_parse_Auction_search(int fd, struct map_session_data* sd)
 {
 	char search_text[NAME_LENGTH];
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	short type = RFIFOW(fd,info->pos[0]);
 	int price = RFIFOL(fd,info->pos[1]);  // FIXME: bug #5071
 	int page = RFIFOW(fd,info->pos[3]);
@@ -15495,7 +15898,7 @@ void clif_parse_Auction_search(int fd, struct map_session_data* sd)
 ///     1 = buy (own bids)
 void clif_parse_Auction_buysell(int fd, struct map_session_data* sd)
 {
-	short type = RFIFOW(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]) + 6;
+	short type = RFIFOW(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]) + 6;
 
 	if( !battle_config.feature_auction )
 		return;
@@ -15532,7 +15935,7 @@ void clif_parse_cashshop_close(int fd, struct map_session_data* sd) {
 //0846 <tabid>.W (CZ_REQ_SE_CASH_TAB_CODE))
 //08c0 <len>.W <openIdentity>.L <itemcount>.W (ZC_ACK_SE_CASH_ITEM_LIST2)
 void clif_parse_CashShopReqTab(int fd, struct map_session_data *sd) {
-	short tab = RFIFOW(fd, packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	short tab = RFIFOW(fd, sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	int j;
 
 	if( tab < 0 || tab > CASHSHOP_TAB_SEARCH )
@@ -15674,7 +16077,7 @@ void clif_parse_cashshop_buy(int fd, struct map_session_data *sd)
 
 	nullpo_retv(sd);
 
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 
 	if( map[sd->bl.m].flag.nocashshop ) {
 		clif_colormes(sd,color_table[COLOR_RED],msg_txt(1511)); // Cash Shop is disabled in this map
@@ -15752,7 +16155,7 @@ void clif_Adopt_request(struct map_session_data *sd, struct map_session_data *sr
 /// 01f9 <account id>.L
 void clif_parse_Adopt_request(int fd, struct map_session_data *sd)
 {
-	TBL_PC *tsd = map_id2sd(RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]));
+	TBL_PC *tsd = map_id2sd(RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]));
 	TBL_PC *p_sd = map_charid2sd(sd->status.partner_id);
 
 	if( pc_can_Adopt(sd, p_sd, tsd) ) {
@@ -15769,7 +16172,7 @@ void clif_parse_Adopt_request(int fd, struct map_session_data *sd)
 ///     1 = accepted
 void clif_parse_Adopt_reply(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int p1_id = RFIFOL(fd,info->pos[0]);
 	int p2_id = RFIFOL(fd,info->pos[1]);
 	int result = RFIFOL(fd,info->pos[2]);
@@ -15813,12 +16216,11 @@ void clif_bossmapinfo(int fd, struct mob_data *md, short flag)
 				WFIFOL(fd,7) = md->bl.y;
 			} else
 				WFIFOB(fd,2) = 2; // First Time
-		} else if( md->spawn_timer != INVALID_TIMER ) { // Boss is Dead
-			const struct TimerData * timer_data = get_timer(md->spawn_timer);
+		} else if( md->spawn_pending ) { // Boss is Dead
 			unsigned int seconds;
 			int hours, minutes;
 
-			seconds = DIFF_TICK(timer_data->tick, gettick()) / 1000 + 60;
+			seconds = max(DIFF_TICK(md->spawn_tick, gettick()), 0) / 1000 + 60;
 			hours = seconds / (60 * 60);
 			seconds = seconds - (60 * 60 * hours);
 			minutes = seconds / 60;
@@ -15838,7 +16240,7 @@ void clif_bossmapinfo(int fd, struct mob_data *md, short flag)
 /// 02d6 <account id>.L
 void clif_parse_ViewPlayerEquip(int fd, struct map_session_data* sd)
 {
-	int aid = RFIFOL(fd, packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int aid = RFIFOL(fd, sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	struct map_session_data* tsd = map_id2sd(aid);
 	
 	if (!tsd)
@@ -15860,8 +16262,8 @@ void clif_parse_ViewPlayerEquip(int fd, struct map_session_data* sd)
 ///     1 = enabled
 void clif_parse_EquipTick(int fd, struct map_session_data* sd)
 {
-	//int type = RFIFOL(fd,packet_db[sd->packet_ver][cmd].pos[0]);
-	bool flag = (bool)RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[1]);
+	//int type = RFIFOL(fd,sd->packet_db[cmd].pos[0]);
+	bool flag = (bool)RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[1]);
 	sd->status.show_equip = flag;
 	clif_equiptickack(sd, flag);
 }
@@ -16007,7 +16409,7 @@ void clif_quest_update_objective(struct map_session_data *sd, struct quest *qd)
 /// 02b6 <quest id>.L <active>.B
 void clif_parse_questStateAck(int fd, struct map_session_data *sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	quest_update_status(sd, RFIFOL(fd,info->pos[0]),
 	    RFIFOB(fd,info->pos[1]) ? Q_ACTIVE : Q_INACTIVE);
@@ -16223,7 +16625,7 @@ void clif_mercenary_skillblock(struct map_session_data *sd)
 ///     2 = delete
 void clif_parse_mercenary_action(int fd, struct map_session_data* sd)
 {
-	int option = RFIFOB(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int option = RFIFOB(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	if( sd->md == NULL )
 		return;
@@ -16368,7 +16770,7 @@ void clif_bg_message(struct battleground_data *bg, int src_id, const char *name,
 /// 0x2db <packet len>.W <text>.?B (<name> : <message>) 00
 void clif_parse_BattleChat(int fd, struct map_session_data* sd)
 {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int textlen = RFIFOW(fd,info->pos[0]) - 4;
 	const char* text = (char*)RFIFOP(fd,info->pos[1]);
 
@@ -16467,6 +16869,7 @@ void clif_font(struct map_session_data *sd)
 
 	nullpo_retv(sd);
 
+	clif_clearviewcache(&sd->bl);
 	WBUFW(buf,0) = 0x2ef;
 	WBUFL(buf,2) = sd->bl.id;
 	WBUFW(buf,6) = sd->status.font;
@@ -16638,13 +17041,13 @@ void clif_showdigit(struct map_session_data* sd, unsigned char type, int value)
 ///         Graffiti.
 void clif_parse_LessEffect(int fd, struct map_session_data* sd)
 {
-	int isLess = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	int isLess = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 	sd->state.lesseffect = ( isLess != 0 );
 }
 
 /// S 07e4 <length>.w <option>.l <val>.l {<index>.w <amount>.w).4b*
 void clif_parse_ItemListWindowSelected(int fd, struct map_session_data* sd) {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int n = (RFIFOW(fd,info->pos[0]) - 12) / 4;
 	int type = RFIFOL(fd,info->pos[1]);
 	int flag = RFIFOL(fd,info->pos[2]); // Button clicked: 0 = Cancel, 1 = OK
@@ -16761,7 +17164,7 @@ static void clif_parse_ReqOpenBuyingStore(int fd, struct map_session_data* sd)
 	unsigned char result;
 	int zenylimit;
 	unsigned int count, packet_len;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	packet_len = RFIFOW(fd,info->pos[0]);
 
@@ -16892,7 +17295,7 @@ static void clif_parse_ReqClickBuyingStore(int fd, struct map_session_data* sd)
 {
 	int account_id;
 
-	account_id = RFIFOL(fd,packet_db[sd->packet_ver][RFIFOW(fd,0)].pos[0]);
+	account_id = RFIFOL(fd,sd->packet_db[RFIFOW(fd,0)].pos[0]);
 
 	buyingstore_open(sd, account_id);
 }
@@ -16931,7 +17334,7 @@ static void clif_parse_ReqTradeBuyingStore(int fd, struct map_session_data* sd)
 	uint8* itemlist;
 	int account_id;
 	unsigned int count, packet_len, buyer_id;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	packet_len = RFIFOW(fd,info->pos[0]);
 
@@ -17046,7 +17449,7 @@ static void clif_parse_SearchStoreInfo(int fd, struct map_session_data* sd)
 	const uint8* cardlist;
 	unsigned char type;
 	unsigned int min_price, max_price, packet_len, count, item_count, card_count;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	packet_len = RFIFOW(fd,info->pos[0]);
 
@@ -17191,7 +17594,7 @@ static void clif_parse_SearchStoreInfoListItemClick(int fd, struct map_session_d
 {
 	unsigned short nameid;
 	int account_id, store_id;
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 
 	account_id = RFIFOL(fd,info->pos[0]);
 	store_id   = RFIFOL(fd,info->pos[1]);
@@ -17224,7 +17627,7 @@ void clif_parse_debug(int fd,struct map_session_data *sd)
 	cmd = RFIFOW(fd,0);
 
 	if( sd ) {
-		packet_len = packet_db[sd->packet_ver][cmd].len;
+		packet_len = sd->packet_db[cmd].len;
 
 		if( packet_len == 0 ) { // unknown
 			packet_len = RFIFOREST(fd);
@@ -17487,7 +17890,7 @@ void clif_msgtable_num(int fd, int line, int num) {
  * RFIFOL(fd,2) - type (currently not used)
  *------------------------------------------*/
 void clif_parse_SkillSelectMenu(int fd, struct map_session_data *sd) {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	//int type = RFIFOL(fd,info->pos[0]); //WHY_LOWERVER_COMPATIBILITY = 0x0, WHY_SC_AUTOSHADOWSPELL = 0x1,
 
 	if( sd->menuskill_id != SC_AUTOSHADOWSPELL )
@@ -17529,7 +17932,7 @@ void clif_spiritcharm(struct map_session_data *sd) {
 /// 	1 = move item to normal tab
 void clif_parse_MoveItem(int fd, struct map_session_data *sd) {
 #if PACKETVER >= 20111122
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd,0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd,0)];
 	int index = RFIFOW(fd,info->pos[0]) - 2;
 	int type = RFIFOB(fd,info->pos[1]);
 
@@ -17714,7 +18117,7 @@ void clif_ranklist(struct map_session_data *sd, int16 rankingType) {
  *  3: /pk
  */
 void clif_parse_ranklist(int fd,struct map_session_data *sd) {
-	struct s_packet_db* info = &packet_db[sd->packet_ver][RFIFOW(fd, 0)];
+	struct s_packet_db* info = &sd->packet_db[RFIFOW(fd, 0)];
 	int16 rankingtype = RFIFOW(fd, info->pos[0]); //Type
 
 	if(rankingtype != 3)
@@ -17876,7 +18279,7 @@ void clif_display_pinfo(struct map_session_data *sd, int cmdtype) {
 		/* End - Penalty set*/
 
 		cmd = packet_db_ack[sd->packet_ver][cmdtype];
-		info = &packet_db[sd->packet_ver][cmd];
+		info = &sd->packet_db[cmd];
 		len = info->len; //This is the base len without details
 		if(!len)
 			return; //Version as packet disable
@@ -17952,7 +18355,7 @@ void clif_scriptclear(struct map_session_data *sd, int npcid) {
 	cmd = packet_db_ack[sd->packet_ver][ZC_CLEAR_DIALOG];
 	if( !cmd )
 		cmd = 0x8d6; //Default
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	len = info->len;
 	fd = sd->fd;
 
@@ -17981,7 +18384,7 @@ void clif_crimson_marker(struct map_session_data *sd, struct block_list *bl, uin
 	if( !cmd )
 		cmd = 0x9c1; //Default
 
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	if( !(len = info->len) )
 		return;
 
@@ -18016,7 +18419,7 @@ void clif_crimson_marker_single(struct map_session_data *sd, struct block_list *
 	if( !cmd )
 		cmd = 0x9c1; //Default
 
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	if( !(len = info->len) )
 		return;
 
@@ -18038,7 +18441,7 @@ void clif_notify_bindOnEquip(struct map_session_data *sd, int n) {
 	nullpo_retv(sd);
 
 	cmd = packet_db_ack[sd->packet_ver][ZC_NOTIFY_BIND_ON_EQUIP];
-	info = &packet_db[sd->packet_ver][cmd];
+	info = &sd->packet_db[cmd];
 	if( !cmd || !info->len )
 		return;
 
@@ -18134,6 +18537,7 @@ void DumpUnknow(int fd,TBL_PC *sd,int cmd,int packet_len) {
 static int clif_parse(int fd)
 {
 	int cmd, packet_ver, packet_len, err;
+	struct s_packet_db* info;
 	TBL_PC* sd;
 	int pnum;
 
@@ -18202,7 +18606,7 @@ static int clif_parse(int fd)
 		}
 
 		//Filter out invalid / unsupported packets
-		if( cmd > MAX_PACKET_DB || cmd < MIN_PACKET_DB || packet_db[packet_ver][cmd].len == 0 ) {
+		if( cmd > MAX_PACKET_DB || cmd < MIN_PACKET_DB || !packet_exists(packet_ver, cmd) ) {
 			ShowWarning("clif_parse: Received unsupported packet (packet 0x%04x, %d bytes received), disconnecting session #%d.\n", cmd, RFIFOREST(fd), fd);
 #ifdef DUMP_INVALID_PACKET
 			ShowDump(RFIFOP(fd,0), RFIFOREST(fd));
@@ -18211,8 +18615,10 @@ static int clif_parse(int fd)
 			return 0;
 		}
 
+		info = &packet_db[packet_ver][cmd];
+
 		//Determine real packet length
-		packet_len = packet_db[packet_ver][cmd].len;
+		packet_len = info->len;
 		if( packet_len == -1 ) { //Variable-length packet
 			if( RFIFOREST(fd) < 4 )
 				return 0;
@@ -18237,15 +18643,15 @@ static int clif_parse(int fd)
 			sd->cryptKey = ((sd->cryptKey * clif_cryptKey[1]) + clif_cryptKey[2])&0xFFFFFFFF; //Update key for the next packet
 #endif
 
-		if( packet_db[packet_ver][cmd].func == clif_parse_debug )
-			packet_db[packet_ver][cmd].func(fd, sd);
-		else if( packet_db[packet_ver][cmd].func != NULL ) {
-			if( !sd && packet_db[packet_ver][cmd].func != clif_parse_WantToConnection )
+		if( info->func == clif_parse_debug )
+			info->func(fd, sd);
+		else if( info->func != NULL ) {
+			if( !sd && info->func != clif_parse_WantToConnection )
 				; //Only valid packet when there is no session
-			else if( sd && sd->bl.prev == NULL && packet_db[packet_ver][cmd].func != clif_parse_LoadEndAck )
+			else if( sd && sd->bl.prev == NULL && info->func != clif_parse_LoadEndAck )
 				; //Only valid packet when player is not on a map
 			else
-				packet_db[packet_ver][cmd].func(fd, sd); 
+				info->func(fd, sd); 
 		}
 #ifdef DUMP_UNKNOWN_PACKET
 		else DumpUnknow(fd, sd, cmd, packet_len);
@@ -18929,6 +19335,13 @@ void packetdb_readdb(bool reload)
 		ShowWarning("Found packets up to 0x%X, ignored 0x%X and above.\n",max_cmd,MAX_PACKET_DB);
 		ShowWarning("Please increase MAX_PACKET_DB and recompile.\n");
 	}
+	memset(packet_db_mask,0,sizeof(packet_db_mask));
+	for( i = 0; i <= MAX_PACKET_VER; i++ ) {
+		for( cmd = 0; cmd <= MAX_PACKET_DB; cmd++ ) {
+			if( packet_db[i][cmd].len )
+				packet_db_mask[i][cmd>>5] |= 1U<<(cmd&31);
+		}
+	}
 	if( !clif_config.connect_cmd[clif_config.packet_db_ver] ) { //Locate the nearest version that we still support [Skotlex]
 		for( j = clif_config.packet_db_ver; j >= 0 && !clif_config.connect_cmd[j]; j-- );
 		clif_config.packet_db_ver = (j ? j : MAX_PACKET_VER);
@@ -18986,10 +19399,13 @@ void do_init_clif(void) {
 
 	add_timer_func_list(clif_clearunit_delayed_sub, "clif_clearunit_delayed_sub");
 	add_timer_func_list(clif_delayquit, "clif_delayquit");
+	add_timer_func_list(clif_getareachar_timer, "clif_getareachar_timer");
 	
 	delay_clearunit_ers = ers_new(sizeof(struct block_list),"clif.c::delay_clearunit_ers",ERS_OPT_CLEAR);
 }
 
 void do_final_clif(void) {
 	ers_destroy(delay_clearunit_ers);
+	if( areachar_list )
+		aFree(areachar_list);
 }
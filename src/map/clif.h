@@ -71,8 +71,27 @@ struct s_packet_db {
 #define SERVER 0
 #define packet_len(cmd) packet_db[SERVER][cmd].len
 extern struct s_packet_db packet_db[MAX_PACKET_VER + 1][MAX_PACKET_DB + 1];
+extern uint32 packet_db_mask[MAX_PACKET_VER + 1][(MAX_PACKET_DB + 32) / 32];
 extern int packet_db_ack[MAX_PACKET_VER + 1][MAX_ACK_FUNC + 1];
 
+//Whether the packet exists for the packet version, without touching packet_db (used when sending to many clients)
+#define packet_exists(ver, cmd) (packet_db_mask[(ver)][(cmd)>>5]&(1U<<((cmd)&31)))
+
+//Pending entries of a party/guild member for clif_party_xy_batch/clif_guild_xy_batch
+enum e_xy_update {
+	XY_UPDATE_POS = 0x1, //Minimap dot
+	XY_UPDATE_HP  = 0x2, //HP bar (party only)
+};
+
+//Traffic of the periodic party/guild member updates
+struct s_xy_stats {
+	unsigned int intervals; //Timer runs
+	unsigned int members; //Members with pending entries
+	unsigned int writes; //Writes to a client (one per recipient and run)
+	uint64 packets, bytes; //Queued since startup
+	unsigned int last_packets, last_bytes; //Queued by the last run
+};
+
 // Local define
 typedef enum send_target {
 	ALL_CLIENT,
@@ -450,6 +469,8 @@ void clif_clearunit_delayed(struct block_list* bl, clr_type type, unsigned int t
 int clif_spawn(struct block_list *bl); //Area
 void clif_walkok(struct map_session_data *sd); //Self
 void clif_move(struct unit_data *ud); //Area
+void clif_clearviewcache(struct block_list *bl);
+void clif_freeviewcache(struct unit_data *ud);
 void clif_changemap(struct map_session_data *sd, short m, int x, int y); //Self
 void clif_changemapserver(struct map_session_data* sd, unsigned short map_index, int x, int y, uint32 ip, uint16 port); //Self
 void clif_blown(struct block_list *src, struct block_list *bl); //Area
@@ -569,6 +590,9 @@ void clif_cooking_list(struct map_session_data *sd, int trigger, uint16 skill_id
 void clif_produceeffect(struct map_session_data* sd, int result, unsigned short nameid);
 
 void clif_getareachar_skillunit(struct block_list *bl, struct skill_unit *unit, enum send_target target, uint8 flag);
+void clif_getareachar_all(struct map_session_data* sd);
+void clif_getareachar_clear(struct map_session_data* sd);
+int clif_getareachar_timer(int tid, unsigned int tick, int id, intptr_t data);
 void clif_skill_delunit(struct skill_unit *unit);
 
 void clif_skillunit_update(struct block_list* bl);
@@ -641,6 +665,7 @@ void clif_party_message(struct party_data* p, int account_id, const char* mes, i
 void clif_party_xy(struct map_session_data *sd);
 void clif_party_xy_single(int fd, struct map_session_data *sd);
 void clif_party_hp(struct map_session_data *sd);
+void clif_party_xy_batch(struct party_data *p, const uint8 *flag, struct s_xy_stats *stats);
 void clif_hpmeter_single(int fd, int id, unsigned int hp, unsigned int maxhp);
 
 // Guild
@@ -671,6 +696,7 @@ void clif_guild_broken(struct map_session_data *sd,int flag);
 void clif_guild_xy(struct map_session_data *sd);
 void clif_guild_xy_single(int fd, struct map_session_data *sd);
 void clif_guild_xy_remove(struct map_session_data *sd);
+void clif_guild_xy_batch(struct guild *g, const uint8 *flag, struct s_xy_stats *stats);
 
 // Battleground
 void clif_bg_hp(struct map_session_data *sd);
@@ -65,6 +65,7 @@ struct{
 
 int guild_payexp_timer(int tid, unsigned int tick, int id, intptr_t data);
 static int guild_send_xy_timer(int tid, unsigned int tick, int id, intptr_t data);
+static struct s_xy_stats guild_xy_stats; // Traffic of guild_send_xy_timer
 
 /* guild flags cache */
 struct npc_data **guild_flags;
@@ -324,7 +325,8 @@ int guild_payexp_timer(int tid, unsigned int tick, int id, intptr_t data)
 int guild_send_xy_timer_sub(DBKey key, DBData *data, va_list ap)
 {
 	struct guild *g = db_data2ptr(data);
-	int i;
+	uint8 flag[MAX_GUILD];
+	int i, changed = 0;
 
 	nullpo_ret(g);
 
@@ -334,22 +336,39 @@ int guild_send_xy_timer_sub(DBKey key, DBData *data, va_list ap)
 
 	for(i=0;i<g->max_member;i++) {
 		struct map_session_data* sd = g->member[i].sd;
+		flag[i] = 0;
 		if( sd != NULL && sd->fd && (sd->guild_x != sd->bl.x || sd->guild_y != sd->bl.y) && !sd->bg_id ) {
-			clif_guild_xy(sd);
+			flag[i] = XY_UPDATE_POS;
 			sd->guild_x = sd->bl.x;
 			sd->guild_y = sd->bl.y;
+			changed++;
 		}
 	}
+	if( changed ) { // one write per member for all the dots that moved
+		guild_xy_stats.members += changed;
+		clif_guild_xy_batch(g, flag, &guild_xy_stats);
+	}
 	return 0;
 }
 
 //Code from party_send_xy_timer [Skotlex]
 static int guild_send_xy_timer(int tid, unsigned int tick, int id, intptr_t data)
 {
+	uint64 packets = guild_xy_stats.packets, bytes = guild_xy_stats.bytes;
+
 	guild_db->foreach(guild_db,guild_send_xy_timer_sub,tick);
+	guild_xy_stats.intervals++;
+	guild_xy_stats.last_packets = (unsigned int)(guild_xy_stats.packets - packets);
+	guild_xy_stats.last_bytes = (unsigned int)(guild_xy_stats.bytes - bytes);
 	return 0;
 }
 
+/// Traffic of guild_send_xy_timer
+struct s_xy_stats* guild_get_xy_stats(void)
+{
+	return &guild_xy_stats;
+}
+
 int guild_send_dot_remove(struct map_session_data *sd)
 {
 	if (sd->status.guild_id)
@@ -12,6 +12,7 @@ struct guild_castle;
 #include "map.h" // NAME_LENGTH
 struct map_session_data;
 struct mob_data;
+struct s_xy_stats;
 
 /**
  * Guardian data
@@ -84,6 +85,7 @@ int guild_emblem_changed(int len,int guild_id,int emblem_id,const char *data);
 int guild_send_message(struct map_session_data *sd,const char *mes,int len);
 int guild_recv_message(int guild_id,int account_id,const char *mes,int len);
 int guild_send_dot_remove(struct map_session_data *sd);
+struct s_xy_stats* guild_get_xy_stats(void);
 int guild_skillupack(int guild_id,uint16 skill_id,int account_id);
 int guild_break(struct map_session_data *sd,char *name);
 int guild_broken(int guild_id,int flag);
@@ -1060,6 +1060,8 @@ static void itemdb_read_combos() {
 			id->combos[idx]->nameid = aMalloc(retcount * sizeof(unsigned short));
 			id->combos[idx]->count = retcount;
 			id->combos[idx]->script = parse_script(str[1], path, lines, 0);
+			if (id->combos[idx]->script)
+				script_compile_bonus(id->combos[idx]->script);
 			id->combos[idx]->id = count;
 			id->combos[idx]->isRef = false;
 			// Populate ->nameid field
@@ -1263,8 +1265,8 @@ static bool itemdb_parse_dbrow(char** str, const char* source, int line, int scr
 		id->unequip_script = NULL;
 	}
 
-	if (*str[19])
-		id->script = parse_script(str[19], source, line, scriptopt);
+	if (*str[19] && (id->script = parse_script(str[19], source, line, scriptopt)) != NULL)
+		script_compile_bonus(id->script);
 	if (*str[20])
 		id->equip_script = parse_script(str[20], source, line, scriptopt);
 	if (*str[21])
@@ -1507,16 +1509,36 @@ bool itemdb_is_item_usable(struct item_data *item) {
 	return (item->type == IT_HEALING || item->type == IT_USABLE || item->type == IT_CASH);
 }
 
+/**
+ * Counts the scripts of equipment and cards, and how many of them script_compile_bonus compiled
+ */
+static int itemdb_count_bonus_sub(DBKey key, DBData *data, va_list ap)
+{
+	struct item_data *id = db_data2ptr(data);
+	int *total = va_arg(ap, int *), *compiled = va_arg(ap, int *);
+
+	if (!id->script || !(itemdb_isequip2(id) || id->type == IT_CARD))
+		return 0;
+	(*total)++;
+	if (id->script->bonus)
+		(*compiled)++;
+	return 0;
+}
+
 /**
  * Read all item-related databases
  */
 static void itemdb_read(void) {
+	int total = 0, compiled = 0;
 
 	if (db_use_sqldbs)
 		itemdb_read_sqldb();
 	else
 		itemdb_readdb();
 
+	itemdb->foreach(itemdb, itemdb_count_bonus_sub, &total, &compiled);
+	ShowStatus("Compiled '"CL_WHITE"%d"CL_RESET"' of '"CL_WHITE"%d"CL_RESET"' equipment and card scripts into constant bonuses (%d%%).\n", compiled, total, total ? compiled * 100 / total : 0);
+
 	itemdb_read_combos();
 	itemdb_read_itemgroup();
 	sv_readdb(db_path, "item_avail.txt",         ',', 2, 2, -1, &itemdb_read_itemavail);
@@ -1643,6 +1665,9 @@ void itemdb_reload(void)
 		}
 	}
 
+	mob_drop_build(); //Relink the drop tables to the new item data
+	status_calc_cache_clear(); //Item scripts changed
+
 	//Read just itemdb pointer cache for each player
 	iter = mapit_geteachpc();
 	for( sd = (struct map_session_data*)mapit_first(iter); mapit_exists(iter); sd = (struct map_session_data*)mapit_next(iter) ) {
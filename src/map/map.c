@@ -104,7 +104,6 @@ static DBMap* bossid_db = NULL; // int id -> struct mob_data* (MVP db)
 static DBMap* map_db = NULL; // unsigned int mapindex -> struct map_data*
 static DBMap* nick_db = NULL; // int char_id -> struct charid2nick* (requested names of offline characters)
 static DBMap* charid_db = NULL; // int char_id -> struct map_session_data*
-static DBMap* regen_db = NULL; // int id -> struct block_list* (status_natural_heal processing)
 
 static int map_users = 0;
 
@@ -113,6 +112,16 @@ static int map_users = 0;
 struct block_list *block_free[block_free_max];
 static int block_free_count = 0, block_free_lock = 0;
 
+//Block lists of a map, each one only holds some object types (see map_blocks)
+enum e_blocklist {
+	BLOCK_UNIT, //map_data::block
+	BLOCK_OBJ, //map_data::block_obj
+	BLOCK_MOB, //map_data::block_mob
+	BLOCK_MAX
+};
+
+#define BL_OBJ (BL_ITEM|BL_SKILL) //Types kept in map_data::block_obj
+
 #define BL_LIST_MAX 1048576
 static struct block_list *bl_list[BL_LIST_MAX];
 static int bl_list_count = 0;
@@ -285,12 +294,34 @@ static void map_delblcell(struct block_list *bl)
 }
 #endif
 
+/*==========================================
+ * Returns the block list l of map m when it can hold any of
+ * the given types, NULL otherwise.
+ * Searches only walk the lists of the types they ask for,
+ * so looking for players skips the floor items and skill units.
+ *------------------------------------------*/
+static struct block_list **map_blocks(int16 m, enum e_blocklist l, int type)
+{
+	switch( l ) {
+		case BLOCK_MOB: return (type&BL_MOB) ? map[m].block_mob : NULL;
+		case BLOCK_OBJ: return (type&BL_OBJ) ? map[m].block_obj : NULL;
+		default:        return (type&~(BL_MOB|BL_OBJ)) ? map[m].block : NULL;
+	}
+}
+
+/// Returns the block list that holds bl
+static struct block_list **map_blocks_bl(struct block_list *bl)
+{
+	return map_blocks(bl->m, (bl->type == BL_MOB ? BLOCK_MOB : (bl->type&BL_OBJ ? BLOCK_OBJ : BLOCK_UNIT)), bl->type);
+}
+
 /*==========================================
  * Adds a block to the map.
  * Returns 0 on success, 1 on failure (illegal coordinates).
  *------------------------------------------*/
 int map_addblock(struct block_list* bl)
 {
+	struct block_list **blocks;
 	int16 m, x, y;
 	int pos;
 
@@ -314,20 +345,13 @@ int map_addblock(struct block_list* bl)
 	}
 
 	pos = x / BLOCK_SIZE + (y / BLOCK_SIZE) * map[m].bxs;
+	blocks = map_blocks_bl(bl);
 
-	if( bl->type == BL_MOB ) {
-		bl->next = map[m].block_mob[pos];
-		bl->prev = &bl_head;
-		if( bl->next )
-			bl->next->prev = bl;
-		map[m].block_mob[pos] = bl;
-	} else {
-		bl->next = map[m].block[pos];
-		bl->prev = &bl_head;
-		if( bl->next )
-			bl->next->prev = bl;
-		map[m].block[pos] = bl;
-	}
+	bl->next = blocks[pos];
+	bl->prev = &bl_head;
+	if( bl->next )
+		bl->next->prev = bl;
+	blocks[pos] = bl;
 
 #ifdef CELL_NOSTACK
 	map_addblcell(bl);
@@ -361,10 +385,7 @@ int map_delblock(struct block_list* bl)
 		bl->next->prev = bl->prev;
 	if (bl->prev == &bl_head) {
 		//Since the head of the list, update the block_list map of []
-		if (bl->type == BL_MOB)
-			map[bl->m].block_mob[pos] = bl->next;
-		else
-			map[bl->m].block[pos] = bl->next;
+		map_blocks_bl(bl)[pos] = bl->next;
 	} else
 		bl->prev->next = bl->next;
 	bl->next = NULL;
@@ -503,7 +524,7 @@ int map_moveblock(struct block_list *bl, int x1, int y1, unsigned int tick)
  *------------------------------------------*/
 int map_count_oncell(int16 m, int16 x, int16 y, int type, int flag)
 {
-	int bx,by;
+	int bx,by,l;
 	struct block_list *bl;
 	int count = 0;
 
@@ -513,29 +534,13 @@ int map_count_oncell(int16 m, int16 x, int16 y, int type, int flag)
 	bx = x / BLOCK_SIZE;
 	by = y / BLOCK_SIZE;
 
-	if (type&~BL_MOB) {
-		for (bl = map[m].block[bx + by * map[m].bxs]; bl != NULL; bl = bl->next) {
-			if (bl->x == x && bl->y == y && bl->type&type) {
-				if (flag&0x2) {
-					struct status_change *sc = status_get_sc(bl);
-
-					if (sc && (sc->option&OPTION_INVISIBLE))
-						continue;
-				}
-				if (flag&0x1) {
-					struct unit_data *ud = unit_bl2ud(bl);
+	for (l = 0; l < BLOCK_MAX; l++) {
+		struct block_list **blocks = map_blocks(m, l, type);
 
-					if (ud && ud->walktimer != INVALID_TIMER)
-						continue;
-				}
-				count++;
-			}
-		}
-	}
-
-	if (type&BL_MOB) {
-		for (bl = map[m].block_mob[bx + by * map[m].bxs]; bl != NULL; bl = bl->next) {
-			if (bl->x == x && bl->y == y) {
+		if (!blocks)
+			continue;
+		for (bl = blocks[bx + by * map[m].bxs]; bl != NULL; bl = bl->next) {
+			if (bl->x == x && bl->y == y && bl->type&type) {
 				if (flag&0x2) {
 					struct status_change *sc = status_get_sc(bl);
 
@@ -572,7 +577,7 @@ struct skill_unit* map_find_skill_unit_oncell(struct block_list* target,int16 x,
 	bx = x / BLOCK_SIZE;
 	by = y / BLOCK_SIZE;
 
-	for( bl = map[m].block[bx+by*map[m].bxs] ; bl != NULL ; bl = bl->next ) {
+	for( bl = map[m].block_obj[bx+by*map[m].bxs] ; bl != NULL ; bl = bl->next ) {
 		if( bl->x != x || bl->y != y || bl->type != BL_SKILL )
 			continue;
 
@@ -593,7 +598,7 @@ int map_foreachinrange(int (*func)(struct block_list*, va_list), struct block_li
 	int bx, by, m;
 	int returnCount = 0; //Total sum of returned values of func() [Skotlex]
 	struct block_list *bl;
-	int blockcount = bl_list_count, i;
+	int blockcount = bl_list_count, i, l;
 	int x0, x1, y0, y1;
 	va_list ap;
 
@@ -603,10 +608,14 @@ int map_foreachinrange(int (*func)(struct block_list*, va_list), struct block_li
 	x1 = min(center->x + range, map[ m ].xs - 1);
 	y1 = min(center->y + range, map[ m ].ys - 1);
 
-	if( type&~BL_MOB )
+	for( l = 0; l < BLOCK_MAX; l++ ) {
+		struct block_list **blocks = map_blocks(m, l, type);
+
+		if( !blocks )
+			continue;
 		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ ) {
 			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ ) {
-				for( bl = map[m].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
+				for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
 					if( bl->type&type
 						&& bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1
 #ifdef CIRCULAR_AREA
@@ -617,20 +626,7 @@ int map_foreachinrange(int (*func)(struct block_list*, va_list), struct block_li
 				}
 			}
 		}
-
-	if( type&BL_MOB )
-		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ ) {
-			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ ) {
-				for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
-					if( bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1
-#ifdef CIRCULAR_AREA
-						&& check_distance_bl(center, bl, range)
-#endif
-						&& bl_list_count < BL_LIST_MAX )
-						bl_list[ bl_list_count++ ] = bl;
-				}
-			}
-		}
+	}
 
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachinrange: block count too many!\n");
@@ -658,7 +654,7 @@ int map_foreachinshootrange(int (*func)(struct block_list*,va_list),struct block
 	int bx, by, m;
 	int returnCount = 0;	//total sum of returned values of func() [Skotlex]
 	struct block_list *bl;
-	int blockcount = bl_list_count, i;
+	int blockcount = bl_list_count, i, l;
 	int x0, x1, y0, y1;
 	va_list ap;
 
@@ -671,10 +667,14 @@ int map_foreachinshootrange(int (*func)(struct block_list*,va_list),struct block
 	x1 = min(center->x+range, map[m].xs-1);
 	y1 = min(center->y+range, map[m].ys-1);
 
-	if ( type&~BL_MOB )
+	for( l = 0; l < BLOCK_MAX; l++ ) {
+		struct block_list **blocks = map_blocks(m, l, type);
+
+		if( !blocks )
+			continue;
 		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ ) {
 			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ ) {
-				for( bl = map[ m ].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
+				for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
 					if( bl->type&type
 						&& bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1
 #ifdef CIRCULAR_AREA
@@ -686,20 +686,7 @@ int map_foreachinshootrange(int (*func)(struct block_list*,va_list),struct block
 				}
 			}
 		}
-	if( type&BL_MOB )
-		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ ) {
-			for( bx=x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ ) {
-				for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
-					if( bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1
-#ifdef CIRCULAR_AREA
-						&& check_distance_bl(center, bl, range)
-#endif
-						&& path_search_long(NULL, center->m, center->x, center->y, bl->x, bl->y, CELL_CHKWALL)
-						&& bl_list_count < BL_LIST_MAX )
-						bl_list[ bl_list_count++ ] = bl;
-				}
-			}
-		}
+	}
 
 	if( bl_list_count >= BL_LIST_MAX )
 			ShowWarning("map_foreachinrange: block count too many!\n");
@@ -729,7 +716,7 @@ int map_foreachinarea(int (*func)(struct block_list*,va_list), int16 m, int16 x0
 	int bx, by;
 	int returnCount = 0;	//total sum of returned values of func() [Skotlex]
 	struct block_list *bl;
-	int blockcount = bl_list_count, i;
+	int blockcount = bl_list_count, i, l;
 	va_list ap;
 
 	if ( m < 0 || m >= map_num )
@@ -744,19 +731,17 @@ int map_foreachinarea(int (*func)(struct block_list*,va_list), int16 m, int16 x0
 	y0 = max(y0, 0);
 	x1 = min(x1, map[ m ].xs - 1);
 	y1 = min(y1, map[ m ].ys - 1);
-	if ( type&~BL_MOB )
-		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ )
-			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ )
-				for( bl = map[ m ].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next )
-					if( bl->type&type && bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1 && bl_list_count < BL_LIST_MAX )
-						bl_list[ bl_list_count++ ] = bl;
+	for( l = 0; l < BLOCK_MAX; l++ ) {
+		struct block_list **blocks = map_blocks(m, l, type);
 
-	if( type&BL_MOB )
+		if( !blocks )
+			continue;
 		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ )
 			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ )
-				for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next )
-					if( bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1 && bl_list_count < BL_LIST_MAX )
+				for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next )
+					if( bl->type&type && bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1 && bl_list_count < BL_LIST_MAX )
 						bl_list[ bl_list_count++ ] = bl;
+	}
 
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachinarea: block count too many!\n");
@@ -783,7 +768,7 @@ int map_forcountinrange(int (*func)(struct block_list*,va_list), struct block_li
 	int bx, by, m;
 	int returnCount = 0;	//total sum of returned values of func() [Skotlex]
 	struct block_list *bl;
-	int blockcount = bl_list_count, i;
+	int blockcount = bl_list_count, i, l;
 	int x0, x1, y0, y1;
 	va_list ap;
 
@@ -793,10 +778,14 @@ int map_forcountinrange(int (*func)(struct block_list*,va_list), struct block_li
 	x1 = min(center->x + range, map[ m ].xs - 1);
 	y1 = min(center->y + range, map[ m ].ys - 1);
 
-	if ( type&~BL_MOB )
+	for( l = 0; l < BLOCK_MAX; l++ ) {
+		struct block_list **blocks = map_blocks(m, l, type);
+
+		if( !blocks )
+			continue;
 		for ( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ ) {
 			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ ) {
-				for( bl = map[ m ].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
+				for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
 					if( bl->type&type
 						&& bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1
 #ifdef CIRCULAR_AREA
@@ -807,19 +796,7 @@ int map_forcountinrange(int (*func)(struct block_list*,va_list), struct block_li
 				}
 			}
 		}
-	if( type&BL_MOB )
-		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ ) {
-			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ ){
-				for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
-					if( bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1
-#ifdef CIRCULAR_AREA
-						&& check_distance_bl(center, bl, range)
-#endif
-						&& bl_list_count < BL_LIST_MAX )
-						bl_list[ bl_list_count++ ] = bl;
-				}
-			}
-		}
+	}
 
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_forcountinrange: block count too many!\n");
@@ -845,7 +822,7 @@ int map_forcountinarea(int (*func)(struct block_list*,va_list), int16 m, int16 x
 	int bx, by;
 	int returnCount = 0;	//total sum of returned values of func() [Skotlex]
 	struct block_list *bl;
-	int blockcount = bl_list_count, i;
+	int blockcount = bl_list_count, i, l;
 	va_list ap;
 
 	if ( m < 0 )
@@ -861,19 +838,17 @@ int map_forcountinarea(int (*func)(struct block_list*,va_list), int16 m, int16 x
 	x1 = min(x1, map[ m ].xs - 1);
 	y1 = min(y1, map[ m ].ys - 1);
 
-	if ( type&~BL_MOB )
-		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ )
-			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ )
-				for( bl = map[ m ].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next )
-					if( bl->type&type && bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1 && bl_list_count < BL_LIST_MAX )
-						bl_list[ bl_list_count++ ] = bl;
+	for( l = 0; l < BLOCK_MAX; l++ ) {
+		struct block_list **blocks = map_blocks(m, l, type);
 
-	if( type&BL_MOB )
+		if( !blocks )
+			continue;
 		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ )
 			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ )
-				for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next )
-					if( bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1 && bl_list_count < BL_LIST_MAX )
+				for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next )
+					if( bl->type&type && bl->x >= x0 && bl->x <= x1 && bl->y >= y0 && bl->y <= y1 && bl_list_count < BL_LIST_MAX )
 						bl_list[ bl_list_count++ ] = bl;
+	}
 
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachinarea: block count too many!\n");
@@ -905,7 +880,7 @@ int map_foreachinmovearea(int (*func)(struct block_list*,va_list), struct block_
 	int bx, by, m;
 	int returnCount = 0;  //total sum of returned values of func() [Skotlex]
 	struct block_list *bl;
-	int blockcount = bl_list_count, i;
+	int blockcount = bl_list_count, i, l;
 	int x0, x1, y0, y1;
 	va_list ap;
 
@@ -945,8 +920,12 @@ int map_foreachinmovearea(int (*func)(struct block_list*,va_list), struct block_
 
 		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ ) {
 			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ ) {
-				if ( type&~BL_MOB ) {
-					for( bl = map[m].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
+				for( l = 0; l < BLOCK_MAX; l++ ) {
+					struct block_list **blocks = map_blocks(m, l, type);
+
+					if( !blocks )
+						continue;
+					for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
 						if( bl->type&type &&
 							bl->x >= x0 && bl->x <= x1 &&
 							bl->y >= y0 && bl->y <= y1 &&
@@ -954,14 +933,6 @@ int map_foreachinmovearea(int (*func)(struct block_list*,va_list), struct block_
 							bl_list[ bl_list_count++ ] = bl;
 					}
 				}
-				if ( type&BL_MOB ) {
-					for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
-						if( bl->x >= x0 && bl->x <= x1 &&
-							bl->y >= y0 && bl->y <= y1 &&
-							bl_list_count < BL_LIST_MAX )
-							bl_list[ bl_list_count++ ] = bl;
-					}
-				}
 			}
 		}
 	} else { // Diagonal movement
@@ -973,8 +944,12 @@ int map_foreachinmovearea(int (*func)(struct block_list*,va_list), struct block_
 
 		for( by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; by++ ) {
 			for( bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; bx++ ) {
-				if ( type & ~BL_MOB ) {
-					for( bl = map[ m ].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
+				for( l = 0; l < BLOCK_MAX; l++ ) {
+					struct block_list **blocks = map_blocks(m, l, type);
+
+					if( !blocks )
+						continue;
+					for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
 						if( bl->type&type &&
 							bl->x >= x0 && bl->x <= x1 &&
 							bl->y >= y0 && bl->y <= y1 &&
@@ -986,18 +961,6 @@ int map_foreachinmovearea(int (*func)(struct block_list*,va_list), struct block_
 							bl_list[ bl_list_count++ ] = bl;
 					}
 				}
-				if ( type&BL_MOB ) {
-					for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
-						if( bl->x >= x0 && bl->x <= x1 &&
-							bl->y >= y0 && bl->y <= y1 &&
-							bl_list_count < BL_LIST_MAX)
-						if( ( dx > 0 && bl->x < x0 + dx) ||
-							( dx < 0 && bl->x > x1 + dx) ||
-							( dy > 0 && bl->y < y0 + dy) ||
-							( dy < 0 && bl->y > y1 + dy) )
-							bl_list[ bl_list_count++ ] = bl;
-					}
-				}
 			}
 		}
 
@@ -1030,7 +993,7 @@ int map_foreachincell(int (*func)(struct block_list*,va_list), int16 m, int16 x,
 	int bx, by;
 	int returnCount = 0;  //total sum of returned values of func() [Skotlex]
 	struct block_list *bl;
-	int blockcount = bl_list_count, i;
+	int blockcount = bl_list_count, i, l;
 	va_list ap;
 
 	if ( x < 0 || y < 0 || x >= map[ m ].xs || y >= map[ m ].ys ) return 0;
@@ -1038,14 +1001,15 @@ int map_foreachincell(int (*func)(struct block_list*,va_list), int16 m, int16 x,
 	by = y / BLOCK_SIZE;
 	bx = x / BLOCK_SIZE;
 
-	if( type&~BL_MOB )
-		for( bl = map[ m ].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next )
+	for( l = 0; l < BLOCK_MAX; l++ ) {
+		struct block_list **blocks = map_blocks(m, l, type);
+
+		if( !blocks )
+			continue;
+		for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next )
 			if( bl->type&type && bl->x == x && bl->y == y && bl_list_count < BL_LIST_MAX )
 				bl_list[ bl_list_count++ ] = bl;
-	if( type&BL_MOB )
-		for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs]; bl != NULL; bl = bl->next )
-			if( bl->x == x && bl->y == y && bl_list_count < BL_LIST_MAX)
-				bl_list[ bl_list_count++ ] = bl;
+	}
 
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachincell: block count too many!\n");
@@ -1105,7 +1069,7 @@ int map_foreachinpath(int (*func)(struct block_list*,va_list),int16 m,int16 x0,i
 // kRO.
 
 	//Generic map_foreach* variables.
-	int i, blockcount = bl_list_count;
+	int i, l, blockcount = bl_list_count;
 	struct block_list *bl;
 	int bx, by;
 	//method specific variables
@@ -1160,10 +1124,14 @@ int map_foreachinpath(int (*func)(struct block_list*,va_list),int16 m,int16 x0,i
 
 	range *= range << 8; //Values are shifted later on for higher precision using int math.
 
-	if ( type&~BL_MOB )
+	for( l = 0; l < BLOCK_MAX; l++ ) {
+		struct block_list **blocks = map_blocks(m, l, type);
+
+		if( !blocks )
+			continue;
 		for ( by = my0 / BLOCK_SIZE; by <= my1 / BLOCK_SIZE; by++ ) {
 			for( bx = mx0 / BLOCK_SIZE; bx <= mx1 / BLOCK_SIZE; bx++ ) {
-				for( bl = map[ m ].block[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
+				for( bl = blocks[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
 					if( bl->prev && bl->type&type && bl_list_count < BL_LIST_MAX ) {
 						xi = bl->x;
 						yi = bl->y;
@@ -1194,37 +1162,7 @@ int map_foreachinpath(int (*func)(struct block_list*,va_list),int16 m,int16 x0,i
 				}
 			}
 		}
-	 if( type&BL_MOB )
-		for( by = my0 / BLOCK_SIZE; by <= my1 / BLOCK_SIZE; by++ ) {
-			for( bx = mx0 / BLOCK_SIZE; bx <= mx1 / BLOCK_SIZE; bx++ ) {
-				for( bl = map[ m ].block_mob[ bx + by * map[ m ].bxs ]; bl != NULL; bl = bl->next ) {
-					if( bl->prev && bl_list_count < BL_LIST_MAX ) {
-						xi = bl->x;
-						yi = bl->y;
-						k = ( xi - x0 ) * ( x1 - x0 ) + ( yi - y0 ) * ( y1 - y0 );
-
-						if ( k < 0 || k > len_limit )
-							continue;
-
-						if ( k > magnitude2 && !path_search_long(NULL, m, x0, y0, xi, yi, CELL_CHKWALL) )
-							continue; //Targets beyond the initial ending point need the wall check.
-
-						k  = ( k << 4 ) / magnitude2; //k will be between 1~16 instead of 0~1
-						xi <<= 4;
-						yi <<= 4;
-						xu = ( x0 << 4 ) + k * ( x1 - x0 );
-						yu = ( y0 << 4 ) + k * ( y1 - y0 );
-						k  = MAGNITUDE2(xi, yi, xu, yu);
-
-						//If all dot coordinates were <<4 the square of the magnitude is <<8
-						if ( k > range )
-							continue;
-
-						bl_list[ bl_list_count++ ] = bl;
-					}
-				}
-			}
-		}
+	}
 
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachinpath: block count too many!\n");
@@ -1251,22 +1189,21 @@ int map_foreachinmap(int (*func)(struct block_list*,va_list), int16 m, int type,
 	int b, bsize;
 	int returnCount = 0;  //total sum of returned values of func() [Skotlex]
 	struct block_list *bl;
-	int blockcount = bl_list_count, i;
+	int blockcount = bl_list_count, i, l;
 	va_list ap;
 
 	bsize = map[ m ].bxs * map[ m ].bys;
 
-	if( type&~BL_MOB )
-		for( b = 0; b < bsize; b++ )
-			for( bl = map[ m ].block[ b ]; bl != NULL; bl = bl->next )
-				if( bl->type&type && bl_list_count < BL_LIST_MAX )
-					bl_list[ bl_list_count++ ] = bl;
+	for( l = 0; l < BLOCK_MAX; l++ ) {
+		struct block_list **blocks = map_blocks(m, l, type);
 
-	if( type&BL_MOB )
+		if( !blocks )
+			continue;
 		for( b = 0; b < bsize; b++ )
-			for( bl = map[ m ].block_mob[ b ]; bl != NULL; bl = bl->next )
-				if( bl_list_count < BL_LIST_MAX )
+			for( bl = blocks[ b ]; bl != NULL; bl = bl->next )
+				if( bl->type&type && bl_list_count < BL_LIST_MAX )
 					bl_list[ bl_list_count++ ] = bl;
+	}
 
 	if( bl_list_count >= BL_LIST_MAX )
 		ShowWarning("map_foreachinmap: block count too many!\n");
@@ -1717,7 +1654,7 @@ void map_addiddb(struct block_list *bl)
 	}
 
 	if( bl->type & BL_REGEN )
-		idb_put(regen_db, bl->id, bl);
+		status_natural_heal_add(bl);
 
 	idb_put(id_db,bl->id,bl);
 }
@@ -1739,7 +1676,7 @@ void map_deliddb(struct block_list *bl)
 	}
 
 	if( bl->type & BL_REGEN )
-		idb_remove(regen_db,bl->id);
+		status_natural_heal_remove(bl);
 
 	idb_remove(id_db,bl->id);
 }
@@ -2128,28 +2065,6 @@ void map_foreachnpc(int (*func)(struct npc_data* nd, va_list args), ...)
 	dbi_destroy(iter);
 }
 
-/// Applies func to everything in the db.
-/// Stops iterating if func returns -1.
-void map_foreachregen(int (*func)(struct block_list* bl, va_list args), ...)
-{
-	DBIterator* iter;
-	struct block_list* bl;
-
-	iter = db_iterator(regen_db);
-	for( bl = (struct block_list*)dbi_first(iter); dbi_exists(iter); bl = (struct block_list*)dbi_next(iter) )
-	{
-		va_list args;
-		int ret;
-
-		va_start(args, func);
-		ret = func(bl, args);
-		va_end(args);
-		if( ret == -1 )
-			break;// stop iterating
-	}
-	dbi_destroy(iter);
-}
-
 /// Applies func to everything in the db.
 /// Stops iterating if func returns -1.
 void map_foreachiddb(int (*func)(struct block_list* bl, va_list args), ...)
@@ -2337,6 +2252,46 @@ bool map_addnpc(int16 m,struct npc_data *nd)
 	return true;
 }
 
+/*==========================================
+ * Cell storage
+ *------------------------------------------*/
+/// Allocates the cells of a map once its size is known, all of them walls
+static void map_alloccells(struct map_data *m)
+{
+	m->cell_stride = (m->xs + 63) / 64;
+	CREATE(m->cell, struct mapcell, m->xs * m->ys);
+	CREATE(m->cell_walkable, uint64, m->cell_stride * m->ys);
+	CREATE(m->cell_shootable, uint64, m->cell_stride * m->ys);
+	CREATE(m->cell_water, uint64, m->cell_stride * m->ys);
+}
+
+/// Copies the cells of map src to map dst, of the same size
+static void map_copycells(struct map_data *dst, struct map_data *src)
+{
+	memcpy(dst->cell, src->cell, src->xs * src->ys * sizeof(struct mapcell));
+	memcpy(dst->cell_walkable, src->cell_walkable, src->cell_stride * src->ys * sizeof(uint64));
+	memcpy(dst->cell_shootable, src->cell_shootable, src->cell_stride * src->ys * sizeof(uint64));
+	memcpy(dst->cell_water, src->cell_water, src->cell_stride * src->ys * sizeof(uint64));
+}
+
+static void map_freecells(struct map_data *m)
+{
+	if( m->cell ) {
+		aFree(m->cell);
+		m->cell = NULL;
+	}
+	if( m->cell_walkable ) {
+		aFree(m->cell_walkable);
+		aFree(m->cell_shootable);
+		aFree(m->cell_water);
+		m->cell_walkable = m->cell_shootable = m->cell_water = NULL;
+	}
+}
+
+/// Sets terrain flag 'plane' of cell (x,y) of map m
+#define map_setcellbit(m,plane,x,y,flag) \
+	( (flag) ? ((m)->plane[map_cellword(m,x,y)] |= map_cellmask(x)) : ((m)->plane[map_cellword(m,x,y)] &= ~map_cellmask(x)) )
+
 /*==========================================
  * Add an instance map
  *------------------------------------------*/
@@ -2345,7 +2300,7 @@ int map_addinstancemap(const char *name, int id)
 	int src_m = map_mapname2mapid(name);
 	int dst_m = -1, i;
 	char iname[MAP_NAME_LENGTH];
-	size_t num_cell, size;
+	size_t size;
 
 	if(src_m < 0)
 		return -1;
@@ -2394,12 +2349,13 @@ int map_addinstancemap(const char *name, int id)
 	map[dst_m].npc_num = 0;
 
 	// Reallocate cells
-	num_cell = map[dst_m].xs * map[dst_m].ys;
-	CREATE(map[dst_m].cell, struct mapcell, num_cell);
-	memcpy(map[dst_m].cell, map[src_m].cell, num_cell * sizeof(struct mapcell));
+	map_alloccells(&map[dst_m]);
+	map_copycells(&map[dst_m], &map[src_m]);
+	path_cache_clear(dst_m); // Paths of the map that used this id before
 
 	size = map[dst_m].bxs * map[dst_m].bys * sizeof(struct block_list*);
 	map[dst_m].block = (struct block_list **)aCalloc(1,size);
+	map[dst_m].block_obj = (struct block_list **)aCalloc(1,size);
 	map[dst_m].block_mob = (struct block_list **)aCalloc(1,size);
 
 	map[dst_m].index = mapindex_addmap(-1, map[dst_m].name);
@@ -2476,8 +2432,9 @@ int map_delinstancemap(int m)
 	mapindex_removemap( map[m].index );
 
 	// Free memory
-	aFree(map[m].cell);
+	map_freecells(&map[m]);
 	aFree(map[m].block);
+	aFree(map[m].block_obj);
 	aFree(map[m].block_mob);
 
 	map_removemapdb(&map[m]);
@@ -2541,7 +2498,7 @@ int map_removemobs_sub(struct block_list *bl, va_list ap)
 	if( md->spawn && !md->spawn->state.dynamic )
 		return 0;
 	// hasn't spawned yet
-	if( md->spawn_timer != INVALID_TIMER )
+	if( md->spawn_pending )
 		return 0;
 	// is damaged and mob_remove_damaged is off
 	if( !battle_config.mob_remove_damaged && md->status.hp < md->status.max_hp )
@@ -2773,33 +2730,34 @@ int map_random_dir(struct block_list *bl, int16 *x, int16 *y)
 }
 
 // gat system
-inline static struct mapcell map_gat2cell(int gat) {
-	struct mapcell cell;
-
-	memset(&cell,0,sizeof(struct mapcell));
+static void map_setgat(struct map_data *m, int16 x, int16 y, int gat)
+{
+	bool walkable = false, shootable = false, water = false;
 
 	switch(gat) {
-		case 0: cell.walkable = 1; cell.shootable = 1; cell.water = 0; break; //Walkable ground
-		case 1: cell.walkable = 0; cell.shootable = 0; cell.water = 0; break; //Non-walkable ground
-		case 2: cell.walkable = 1; cell.shootable = 1; cell.water = 0; break; //???
-		case 3: cell.walkable = 1; cell.shootable = 1; cell.water = 1; break; //Walkable water
-		case 4: cell.walkable = 1; cell.shootable = 1; cell.water = 0; break; //???
-		case 5: cell.walkable = 0; cell.shootable = 1; cell.water = 0; break; //Gap (snipable)
-		case 6: cell.walkable = 1; cell.shootable = 1; cell.water = 0; break; //???
+		case 0: walkable = true; shootable = true; break; //Walkable ground
+		case 1: break; //Non-walkable ground
+		case 2: walkable = true; shootable = true; break; //???
+		case 3: walkable = true; shootable = true; water = true; break; //Walkable water
+		case 4: walkable = true; shootable = true; break; //???
+		case 5: shootable = true; break; //Gap (snipable)
+		case 6: walkable = true; shootable = true; break; //???
 		default:
-			ShowWarning("map_gat2cell: unrecognized gat type '%d'\n", gat);
+			ShowWarning("map_setgat: unrecognized gat type '%d'\n", gat);
 			break;
 	}
 
-	return cell;
+	map_setcellbit(m, cell_walkable, x, y, walkable);
+	map_setcellbit(m, cell_shootable, x, y, shootable);
+	map_setcellbit(m, cell_water, x, y, water);
 }
 
-static int map_cell2gat(struct mapcell cell)
+static int map_cell2gat(bool walkable, bool shootable, bool water)
 {
-	if(cell.walkable == 1 && cell.shootable == 1 && cell.water == 0) return 0;
-	if(cell.walkable == 0 && cell.shootable == 0 && cell.water == 0) return 1;
-	if(cell.walkable == 1 && cell.shootable == 1 && cell.water == 1) return 3;
-	if(cell.walkable == 0 && cell.shootable == 1 && cell.water == 0) return 5;
+	if(walkable && shootable && !water) return 0;
+	if(!walkable && !shootable && !water) return 1;
+	if(walkable && shootable && water) return 3;
+	if(!walkable && shootable && !water) return 5;
 
 	ShowWarning("map_cell2gat: cell has no matching gat type\n");
 	return 1; //Default to 'wall'
@@ -2825,20 +2783,22 @@ int map_getcellp(struct map_data* m,int16 x,int16 y,cell_chk cellchk)
 
 	cell = m->cell[x + y * m->xs];
 
+#define walkable map_cellbit(m,cell_walkable,x,y)
+#define shootable map_cellbit(m,cell_shootable,x,y)
 	switch(cellchk) {
 		//Gat type retrieval
 		case CELL_GETTYPE:
-			return map_cell2gat(cell);
+			return map_cell2gat(walkable, shootable, map_cellbit(m,cell_water,x,y));
 
 		//Base gat type checks
 		case CELL_CHKWALL:
-			return (!cell.walkable && !cell.shootable);
+			return (!walkable && !shootable);
 
 		case CELL_CHKWATER:
-			return (cell.water);
+			return map_cellbit(m,cell_water,x,y);
 
 		case CELL_CHKCLIFF:
-			return (!cell.walkable && cell.shootable);
+			return (!walkable && shootable);
 
 
 		//Base cell type checks
@@ -2864,7 +2824,7 @@ int map_getcellp(struct map_data* m,int16 x,int16 y,cell_chk cellchk)
 				return 0;
 #endif
 		case CELL_CHKREACH:
-			return (cell.walkable);
+			return (walkable);
 
 		case CELL_CHKNOPASS:
 #ifdef CELL_NOSTACK
@@ -2872,7 +2832,7 @@ int map_getcellp(struct map_data* m,int16 x,int16 y,cell_chk cellchk)
 				return 1;
 #endif
 		case CELL_CHKNOREACH:
-			return (!cell.walkable);
+			return (!walkable);
 
 		case CELL_CHKSTACK:
 #ifdef CELL_NOSTACK
@@ -2884,6 +2844,8 @@ int map_getcellp(struct map_data* m,int16 x,int16 y,cell_chk cellchk)
 		default:
 			return 0;
 	}
+#undef walkable
+#undef shootable
 }
 
 /*==========================================
@@ -2901,9 +2863,13 @@ void map_setcell(int16 m, int16 x, int16 y, cell_t cell, bool flag)
 	j = x + y*map[m].xs;
 
 	switch( cell ) {
-		case CELL_WALKABLE:      map[m].cell[j].walkable = flag;      break;
-		case CELL_SHOOTABLE:     map[m].cell[j].shootable = flag;     break;
-		case CELL_WATER:         map[m].cell[j].water = flag;         break;
+		case CELL_WALKABLE:
+			if( map_cellbit(&map[m], cell_walkable, x, y) != flag )
+				path_cache_clear(m);
+			map_setcellbit(&map[m], cell_walkable, x, y, flag);
+			break;
+		case CELL_SHOOTABLE:     map_setcellbit(&map[m], cell_shootable, x, y, flag); break;
+		case CELL_WATER:         map_setcellbit(&map[m], cell_water, x, y, flag);     break;
 
 		case CELL_NPC:           map[m].cell[j].npc = flag;           break;
 		case CELL_BASILICA:      map[m].cell[j].basilica = flag;      break;
@@ -2921,18 +2887,15 @@ void map_setcell(int16 m, int16 x, int16 y, cell_t cell, bool flag)
 
 void map_setgatcell(int16 m, int16 x, int16 y, int gat)
 {
-	int j;
-	struct mapcell cell;
+	bool walkable;
 
 	if( m < 0 || m >= map_num || x < 0 || x >= map[m].xs || y < 0 || y >= map[m].ys )
 		return;
 
-	j = x + y*map[m].xs;
-
-	cell = map_gat2cell(gat);
-	map[m].cell[j].walkable = cell.walkable;
-	map[m].cell[j].shootable = cell.shootable;
-	map[m].cell[j].water = cell.water;
+	walkable = map_cellbit(&map[m], cell_walkable, x, y);
+	map_setgat(&map[m], x, y, gat);
+	if( map_cellbit(&map[m], cell_walkable, x, y) != walkable )
+		path_cache_clear(m);
 }
 
 /*==========================================
@@ -3206,11 +3169,10 @@ int map_readfromcache(struct map_data *m, char *buffer, char *decode_buffer)
 		// TO-DO: Maybe handle the scenario, if the decoded buffer isn't the same size as expected? [Shinryo]
 		decode_zip(decode_buffer, &size, p + sizeof(struct map_cache_map_info), info->len);
 
-		CREATE(m->cell, struct mapcell, size);
-
+		map_alloccells(m);
 
 		for( xy = 0; xy < size; ++xy )
-			m->cell[xy] = map_gat2cell(decode_buffer[xy]);
+			map_setgat(m, xy % m->xs, xy / m->xs, decode_buffer[xy]);
 
 		return 1;
 	}
@@ -3267,12 +3229,14 @@ void do_final_maps(void) {
 	int i, v = 0;
 
 	for( i = 0; i < map_num; i++ ) {
-		if( map[i].cell )
-			aFree(map[i].cell);
+		map_freecells(&map[i]);
 
 		if( map[i].block )
 			aFree(map[i].block);
 
+		if( map[i].block_obj )
+			aFree(map[i].block_obj);
+
 		if( map[i].block_mob )
 			aFree(map[i].block_mob);
 
@@ -3417,7 +3381,7 @@ int map_readgat (struct map_data* m)
 	m->xs = *(int32*)(gat+6);
 	m->ys = *(int32*)(gat+10);
 	num_cells = m->xs * m->ys;
-	CREATE(m->cell, struct mapcell, num_cells);
+	map_alloccells(m);
 
 	water_height = map_waterheight(m->name);
 
@@ -3433,7 +3397,7 @@ int map_readgat (struct map_data* m)
 		if( type == 0 && water_height != NO_WATER && height > water_height )
 			type = 3; // Cell is 0 (walkable) but under water level, set to 3 (walkable water)
 
-		m->cell[xy] = map_gat2cell(type);
+		map_setgat(m, xy % m->xs, xy / m->xs, type);
 	}
 	
 	aFree(gat);
@@ -3505,10 +3469,7 @@ int map_readallmaps (void)
 
 		if( uidb_get(map_db,(unsigned int)map_id2index(i)) != NULL ) {
 			ShowWarning("Map %s already loaded!"CL_CLL"\n", map[i].name);
-			if( map[i].cell ) {
-				aFree(map[i].cell);
-				map[i].cell = NULL;
-			}
+			map_freecells(&map[i]);
 			map_delmapid(i);
 			maps_removed++;
 			i--;
@@ -3526,6 +3487,7 @@ int map_readallmaps (void)
 
 		size = map[i].bxs * map[i].bys * sizeof(struct block_list*);
 		map[i].block = (struct block_list**)aCalloc(size, 1);
+		map[i].block_obj = (struct block_list**)aCalloc(size, 1);
 		map[i].block_mob = (struct block_list**)aCalloc(size, 1);
 	}
 
@@ -3566,7 +3528,7 @@ int parse_console(const char* buf) {
 	int n;
 	struct map_session_data sd;
 
-	memset(&sd, 0, sizeof(struct map_session_data));
+	pc_init_data(&sd, 0);
 	strcpy(sd.status.name, "console");
 
 	if( (n = sscanf(buf, "%63[^:]:%63[^:]:%63s %hd %hd[^\n]", type, command, map, &x, &y)) < 5 ) {
@@ -4161,7 +4123,6 @@ void do_final(void)
 	nick_db->destroy(nick_db, nick_db_final);
 	charid_db->destroy(charid_db, NULL);
 	iwall_db->destroy(iwall_db, NULL);
-	regen_db->destroy(regen_db, NULL);
 
 #ifdef ADJUST_SKILL_DAMAGE
 	ers_destroy(map_skill_damage_ers);
@@ -4252,6 +4213,12 @@ void do_shutdown(void)
 	}
 }
 
+#ifdef BATTLE_BENCH
+//Provided by src/test/test_battle.c
+void battle_bench_options(int *argc, char **argv);
+void battle_bench_run(void);
+#endif
+
 int do_init(int argc, char *argv[])
 {
 	runflag = MAPSERVER_ST_STARTING;
@@ -4273,6 +4240,9 @@ int do_init(int argc, char *argv[])
 	map_default.x = 156;
 	map_default.y = 191;
 
+#ifdef BATTLE_BENCH
+	battle_bench_options(&argc,argv);
+#endif
 	cli_get_options(argc,argv);
 
 	rnd_init();
@@ -4316,7 +4286,6 @@ int do_init(int argc, char *argv[])
 	map_db = uidb_alloc(DB_OPT_BASE);
 	nick_db = idb_alloc(DB_OPT_BASE);
 	charid_db = idb_alloc(DB_OPT_BASE);
-	regen_db = idb_alloc(DB_OPT_BASE); // efficient status_natural_heal processing
 
 	iwall_db = strdb_alloc(DB_OPT_RELEASE_DATA, 2 * NAME_LENGTH + 2 + 1); // [Zephyrus] Invisible Walls
 
@@ -4374,6 +4343,11 @@ int do_init(int argc, char *argv[])
 
 	Sql_HerculesUpdateCheck(mmysql_handle);
 
+#ifdef BATTLE_BENCH
+	battle_bench_run();
+	runflag = CORE_ST_STOP;
+#endif
+
 	ShowStatus("Server is '"CL_GREEN"ready"CL_RESET"' and listening on port '"CL_WHITE"%d"CL_RESET"'.\n\n", map_port);
 
 	if (runflag != CORE_ST_STOP) {
@@ -512,14 +512,10 @@ typedef enum {
 	CELL_CHKNOICEWALL      // Whether the cell isn't allowed to cast Ice Wall
 } cell_chk;
 
+// Terrain flags (walkable, shootable, water) are not here, each map keeps them
+// as bitmaps with one bit per cell (see map_cellbit).
 struct mapcell
 {
-	// Terrain flags
-	unsigned char
-		walkable : 1,
-		shootable : 1,
-		water : 1;
-
 	// Dynamic flags
 	unsigned char
 		npc : 1,
@@ -535,6 +531,12 @@ struct mapcell
 #endif
 };
 
+/// Terrain bitmap word and bit holding cell (x,y) of map md
+#define map_cellword(md,x,y) ((y) * (md)->cell_stride + ((x) >> 6))
+#define map_cellmask(x) (UINT64_C(1) << ((x) & 63))
+/// Reads terrain flag 'plane' (cell_walkable, cell_shootable, cell_water) of cell (x,y)
+#define map_cellbit(md,plane,x,y) (((md)->plane[map_cellword(md,x,y)] & map_cellmask(x)) != 0)
+
 struct iwall_data {
 	char wall_name[50];
 	short m, x, y, size;
@@ -575,7 +577,10 @@ struct map_data {
 	char name[MAP_NAME_LENGTH];
 	uint16 index; // The map index used by the mapindex* functions.
 	struct mapcell* cell; // Holds the information of each map cell (NULL if the map is not on this map-server).
-	struct block_list **block;
+	uint64 *cell_walkable, *cell_shootable, *cell_water; // Terrain flags, one bit per cell
+	int cell_stride; // Words per row in the terrain bitmaps
+	struct block_list **block; // Units other than mobs (see map_blocks)
+	struct block_list **block_obj; // Floor items and skill units
 	struct block_list **block_mob;
 	int16 m;
 	int16 xs,ys; // map dimensions (in cells)
@@ -810,7 +815,6 @@ void map_deliddb(struct block_list *bl);
 void map_foreachpc(int (*func)(struct map_session_data* sd, va_list args), ...);
 void map_foreachmob(int (*func)(struct mob_data* md, va_list args), ...);
 void map_foreachnpc(int (*func)(struct npc_data* nd, va_list args), ...);
-void map_foreachregen(int (*func)(struct block_list* bl, va_list args), ...);
 void map_foreachiddb(int (*func)(struct block_list* bl, va_list args), ...);
 struct map_session_data* map_nick2sd(const char*);
 struct mob_data * map_getmob_boss(int16 m);
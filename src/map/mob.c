@@ -43,6 +43,8 @@
 #include <math.h>
 
 #define ACTIVE_AI_RANGE 2 //Distance added on top of 'AREA_SIZE' at which mobs enter active AI mode
+#define ACTIVE_AI_SCAN (5 * MIN_MOBTHINKTIME) //Interval at which players standing still look for mobs to activate
+#define ACTIVE_AI_TIMEOUT (ACTIVE_AI_SCAN + MIN_MOBTHINKTIME) //Time a mob stays in the active set after a player last saw it
 
 #define IDLE_SKILL_INTERVAL 10 //Active idle skills should be triggered every 1 second (1000/MIN_MOBTHINKTIME)
 
@@ -94,6 +96,39 @@ struct s_mob_skill {
 };
 static DBMap *mob_skill_db; //Monster skill temporary db. s_mob_skill -> mobid
 
+//Mobs in active AI range of a player, per map (see mob_ai_hard)
+static struct s_mob_active {
+	struct mob_data **list;
+	int count, max;
+} mob_active[MAX_MAP_PER_SERVER];
+static struct mob_data **mob_ai_queue = NULL; //Mobs of a map due to think on the current tick (see mob_ai_sub_active)
+static int mob_ai_queue_max = 0;
+
+//Maps without players, with mob_freeze_empty_maps (see mob_freeze_map)
+static struct s_mob_frozen {
+	unsigned int tick; //When the last player left, 0 if none ever came
+	int *spawn; //Ids of the mobs whose respawn came due while frozen
+	int spawn_count, spawn_max;
+} mob_frozen[MAX_MAP_PER_SERVER];
+#define mob_map_isfrozen(m) (battle_config.mob_freeze_empty_maps && map[(m)].users == 0 && !map[(m)].instance_id)
+
+#define MOB_SPAWN_BUCKET 500 //Granularity of the respawn queues, respawns due in the same slice are done together
+
+//Respawns due in the same MOB_SPAWN_BUCKET slice of a map
+struct s_mob_spawn_bucket {
+	unsigned int tick; //End of the slice, when the respawns are done
+	int *id;
+	int count, max;
+};
+
+//Respawn queue of a map (see mob_setdelayspawn)
+static struct s_mob_spawnqueue {
+	struct s_mob_spawn_bucket *bucket; //Sorted by tick
+	int count, max;
+	int timer; //Set on the first bucket
+} mob_spawnqueue[MAX_MAP_PER_SERVER];
+static int mob_spawnqueue_timer(int tid, unsigned int tick, int id, intptr_t data);
+
 static struct eri *item_drop_ers; //For loot drops delay structures
 static struct eri *item_drop_list_ers;
 
@@ -302,9 +337,10 @@ struct mob_data* mob_spawn_dataset(struct spawn_data *data)
 		memcpy(md->npc_event, data->eventname, 50);
 	if (md->db->status.mode&MD_LOOTER)
 		md->lootitem = (struct item *)aCalloc(LOOTITEM_SIZE,sizeof(struct item));
-	md->spawn_timer = INVALID_TIMER;
+	md->spawn_pending = false;
 	md->deletetimer = INVALID_TIMER;
 	md->skill_idx = -1;
+	md->active_pos = -1;
 	status_set_viewdata(&md->bl, md->mob_id);
 	status_change_init(&md->bl);
 	unit_dataset(&md->bl);
@@ -828,24 +864,156 @@ int mob_linksearch(struct block_list *bl, va_list ap)
 }
 
 /*==========================================
- * mob spawn with delay (timer function)
+ * Queues the respawn of md at tick, in the queue of its spawn map
  *------------------------------------------*/
-int mob_delayspawn(int tid, unsigned int tick, int id, intptr_t data)
+static void mob_spawnqueue_add(struct mob_data *md, unsigned int tick)
 {
-	struct block_list* bl = map_id2bl(id);
-	struct mob_data* md = BL_CAST(BL_MOB, bl);
+	struct s_mob_spawnqueue *queue = &mob_spawnqueue[md->spawn->m];
+	struct s_mob_spawn_bucket *bucket;
+	unsigned int due = tick + MOB_SPAWN_BUCKET - 1;
+	int i;
 
-	if( md ) {
-		if( md->spawn_timer != tid ) {
-			ShowError("mob_delayspawn: Timer mismatch: %d != %d\n", tid, md->spawn_timer);
-			return 0;
+	due -= due % MOB_SPAWN_BUCKET;
+	md->spawn_tick = tick;
+	md->spawn_pending = true;
+
+	//Newer respawns usually go last, look from the end
+	for( i = queue->count; i > 0 && DIFF_TICK(queue->bucket[i - 1].tick, due) > 0; i-- );
+	if( i > 0 && queue->bucket[i - 1].tick == due )
+		bucket = &queue->bucket[i - 1];
+	else { //New slice
+		if( queue->count == queue->max ) {
+			queue->max += 8;
+			RECREATE(queue->bucket, struct s_mob_spawn_bucket, queue->max);
 		}
-		md->spawn_timer = INVALID_TIMER;
-		mob_spawn(md);
+		memmove(&queue->bucket[i + 1], &queue->bucket[i], (queue->count - i) * sizeof(queue->bucket[0]));
+		queue->count++;
+		bucket = &queue->bucket[i];
+		memset(bucket, 0, sizeof(*bucket));
+		bucket->tick = due;
+		if( i == 0 ) { //New first slice, move the timer up
+			if( queue->timer != INVALID_TIMER )
+				delete_timer(queue->timer, mob_spawnqueue_timer);
+			queue->timer = add_timer(due, mob_spawnqueue_timer, md->spawn->m, 0);
+		}
+	}
+	if( bucket->count == bucket->max ) {
+		bucket->max += 16;
+		RECREATE(bucket->id, int, bucket->max);
 	}
+	bucket->id[bucket->count++] = md->bl.id;
+}
+
+/*==========================================
+ * Respawns the mobs of the slices that came due on a map
+ * Entries of mobs freed, already spawned or queued again later are dropped here.
+ *------------------------------------------*/
+static int mob_spawnqueue_timer(int tid, unsigned int tick, int id, intptr_t data)
+{
+	struct s_mob_spawnqueue *queue = &mob_spawnqueue[id];
+
+	if( queue->timer != tid ) {
+		ShowError("mob_spawnqueue_timer: Timer mismatch: %d != %d\n", tid, queue->timer);
+		return 0;
+	}
+	queue->timer = INVALID_TIMER;
+
+	while( queue->count && DIFF_TICK(queue->bucket[0].tick, tick) <= 0 ) {
+		struct s_mob_spawn_bucket bucket = queue->bucket[0]; //Taken out first, failed spawns queue again
+		int i;
+
+		memmove(&queue->bucket[0], &queue->bucket[1], --queue->count * sizeof(queue->bucket[0]));
+		for( i = 0; i < bucket.count; i++ ) {
+			struct mob_data *md = map_id2md(bucket.id[i]);
+
+			if( !md || !md->spawn_pending || DIFF_TICK(md->spawn_tick, bucket.tick) > 0 )
+				continue;
+			if( mob_map_isfrozen(md->spawn->m) ) { //Wait for a player to come (see mob_thaw_map)
+				struct s_mob_frozen *frozen = &mob_frozen[md->spawn->m];
+
+				if( frozen->spawn_count == frozen->spawn_max ) {
+					frozen->spawn_max += 32;
+					RECREATE(frozen->spawn, int, frozen->spawn_max);
+				}
+				frozen->spawn[frozen->spawn_count++] = md->bl.id;
+				continue;
+			}
+			mob_spawn(md);
+		}
+		if( bucket.id )
+			aFree(bucket.id);
+	}
+
+	if( queue->count && queue->timer == INVALID_TIMER )
+		queue->timer = add_timer(queue->bucket[0].tick, mob_spawnqueue_timer, id, 0);
+	return 0;
+}
+
+static int mob_freeze_sub(struct block_list *bl, va_list ap)
+{
+	unit_stop_walking(bl, 0);
 	return 0;
 }
 
+/*==========================================
+ * Freezes a map left without players: its mobs stop walking, the lazy AI skips them
+ * and their respawns wait until a player arrives. [mob_freeze_empty_maps]
+ *------------------------------------------*/
+void mob_freeze_map(int16 m)
+{
+	if( !mob_map_isfrozen(m) )
+		return;
+	mob_frozen[m].tick = gettick();
+	map_foreachinmap(mob_freeze_sub, m, BL_MOB);
+}
+
+/*==========================================
+ * Relocates an idle mob of a frozen map inside its spawn area,
+ * as if it had kept walking around meanwhile.
+ *------------------------------------------*/
+static int mob_thaw_sub(struct block_list *bl, va_list ap)
+{
+	struct mob_data *md = (struct mob_data *)bl;
+	int16 x, y;
+
+	if( !md->spawn || md->master_id || md->target_id || md->status.hp < md->status.max_hp ||
+		!(status_get_mode(bl)&MD_CANMOVE) || !((md->spawn->x == 0 && md->spawn->y == 0) || md->spawn->xs || md->spawn->ys) )
+		return 0; //Fixed spawn point, slave, or busy
+	x = md->spawn->x;
+	y = md->spawn->y;
+	if( !map_search_freecell(NULL, bl->m, &x, &y, md->spawn->xs, md->spawn->ys, 1) )
+		return 0;
+	unit_movepos(bl, x, y, 0, false);
+	return 1;
+}
+
+/*==========================================
+ * Brings a frozen map up to date when the first player arrives:
+ * the respawns that came due are done and idle mobs are scattered in their spawn area.
+ *------------------------------------------*/
+void mob_thaw_map(int16 m)
+{
+	struct s_mob_frozen *frozen = &mob_frozen[m];
+	unsigned int tick = gettick();
+	int i, count;
+
+	if( !battle_config.mob_freeze_empty_maps || map[m].instance_id )
+		return;
+
+	count = frozen->spawn_count;
+	frozen->spawn_count = 0;
+	for( i = 0; i < count; i++ ) {
+		struct mob_data *md = map_id2md(frozen->spawn[i]);
+
+		if( md && md->bl.prev == NULL && md->spawn_pending )
+			mob_spawn(md);
+	}
+
+	if( !frozen->tick || DIFF_TICK(tick, frozen->tick) >= MIN_RANDOMWALKTIME )
+		map_foreachinmap(mob_thaw_sub, m, BL_MOB);
+	frozen->tick = 0;
+}
+
 /*==========================================
  * Spawn timing calculation
  *------------------------------------------*/
@@ -878,9 +1046,7 @@ int mob_setdelayspawn(struct mob_data *md)
 	if (spawntime < 5000) //Monsters should never respawn faster than within 5 seconds
 		spawntime = 5000;
 
-	if (md->spawn_timer != INVALID_TIMER)
-		delete_timer(md->spawn_timer, mob_delayspawn);
-	md->spawn_timer = add_timer(gettick() + spawntime, mob_delayspawn, md->bl.id, 0);
+	mob_spawnqueue_add(md, gettick() + spawntime);
 	return 0;
 }
 
@@ -925,16 +1091,12 @@ int mob_spawn(struct mob_data *md)
 		if( (md->bl.x == 0 && md->bl.y == 0) || md->spawn->xs || md->spawn->ys ) { //Monster can be spawned on an area
 			if( !map_search_freecell(&md->bl,-1,&md->bl.x,&md->bl.y,md->spawn->xs,md->spawn->ys,battle_config.no_spawn_on_player ? 4 : 0) ) {
 				//Retry again later
-				if( md->spawn_timer != INVALID_TIMER )
-					delete_timer(md->spawn_timer,mob_delayspawn);
-				md->spawn_timer = add_timer(tick + 5000,mob_delayspawn,md->bl.id,0);
+				mob_spawnqueue_add(md,tick + 5000);
 				return 1;
 			}
 		} else if( battle_config.no_spawn_on_player > 99 && map_foreachinrange(mob_count_sub,&md->bl,AREA_SIZE,BL_PC) ) {
 			//Retry again later (players on sight)
-			if( md->spawn_timer != INVALID_TIMER )
-				delete_timer(md->spawn_timer,mob_delayspawn);
-			md->spawn_timer = add_timer(tick + 5000,mob_delayspawn,md->bl.id,0);
+			mob_spawnqueue_add(md,tick + 5000);
 			return 1;
 		}
 	}
@@ -947,10 +1109,7 @@ int mob_spawn(struct mob_data *md)
 	md->ud.state.attack_continue = 0;
 	md->ud.target_to = 0;
 	md->ud.dir = 0;
-	if( md->spawn_timer != INVALID_TIMER ) {
-		delete_timer(md->spawn_timer,mob_delayspawn);
-		md->spawn_timer = INVALID_TIMER;
-	}
+	md->spawn_pending = false;
 
 	//md->master_id = 0;
 	md->master_dist = 0;
@@ -1125,8 +1284,9 @@ static int mob_ai_sub_hard_changechase(struct block_list *bl,va_list ap)
 		(*target) = bl;
 		md->target_id = bl->id;
 		md->min_chase = md->db->range3;
+		return 1; //Any target in attack range will do, stop the search
 	}
-	return 1;
+	return 0;
 }
 
 /*==========================================
@@ -1528,7 +1688,7 @@ static bool mob_ai_sub_hard(struct mob_data *md, unsigned int tick)
 		(md->sc.count && md->sc.data[SC_CONFUSION] && md->sc.data[SC_CONFUSION]->val4))) {
 		int search_size = (view_range < md->status.rhw.range ? view_range : md->status.rhw.range);
 
-		map_foreachinrange(mob_ai_sub_hard_changechase, &md->bl, search_size, DEFAULT_ENEMY_TYPE(md), md, &tbl);
+		map_forcountinrange(mob_ai_sub_hard_changechase, &md->bl, search_size, 1, DEFAULT_ENEMY_TYPE(md), md, &tbl);
 	}
 
 	if(!tbl) { //No targets available
@@ -1658,30 +1818,108 @@ static bool mob_ai_sub_hard(struct mob_data *md, unsigned int tick)
 	return true;
 }
 
-static int mob_ai_sub_hard_timer(struct block_list *bl,va_list ap)
+/*==========================================
+ * Adds the mob to the active set of its map, or refreshes it
+ *------------------------------------------*/
+static int mob_ai_activate(struct block_list *bl,va_list ap)
 {
 	struct mob_data *md = (struct mob_data*)bl;
-	unsigned int tick = va_arg(ap, unsigned int);
+	struct s_mob_active *active = &mob_active[bl->m];
 
-	if(mob_ai_sub_hard(md, tick)) { //Hard AI triggered
-		if(!md->state.spotted)
-			md->state.spotted = 1;
-		md->last_pcneartime = tick;
+	md->active_tick = va_arg(ap, unsigned int);
+	if(md->active_pos >= 0)
+		return 0;
+	if(active->count == active->max) {
+		active->max += 64;
+		RECREATE(active->list, struct mob_data*, active->max);
 	}
-	return 0;
+	md->active_pos = active->count;
+	active->list[active->count++] = md;
+	return 1;
+}
+
+/*==========================================
+ * Removes the mob from the active set of its map
+ *------------------------------------------*/
+void mob_ai_deactivate(struct mob_data *md)
+{
+	struct s_mob_active *active;
+
+	nullpo_retv(md);
+
+	if(md->active_pos < 0)
+		return;
+	active = &mob_active[md->bl.m];
+	if(md->active_pos < --active->count) {
+		active->list[md->active_pos] = active->list[active->count];
+		active->list[md->active_pos]->active_pos = md->active_pos;
+	}
+	md->active_pos = -1;
 }
 
 /*==========================================
- * Serious processing for mob in PC field of view (foreachclient)
+ * Activates the mobs around a player (foreachclient)
+ * Players standing still only look again every ACTIVE_AI_SCAN.
  *------------------------------------------*/
 static int mob_ai_sub_foreachclient(struct map_session_data *sd,va_list ap)
 {
 	unsigned int tick = va_arg(ap, unsigned int);
 
-	map_foreachinrange(mob_ai_sub_hard_timer, &sd->bl, AREA_SIZE + ACTIVE_AI_RANGE, BL_MOB, tick);
+	if(sd->bl.prev == NULL)
+		return 0;
+	if(sd->ai_scan.m == sd->bl.m && sd->ai_scan.x == sd->bl.x && sd->ai_scan.y == sd->bl.y &&
+		DIFF_TICK(tick, sd->ai_scan.tick) < ACTIVE_AI_SCAN)
+		return 0;
+	sd->ai_scan.tick = tick;
+	sd->ai_scan.m = sd->bl.m;
+	sd->ai_scan.x = sd->bl.x;
+	sd->ai_scan.y = sd->bl.y;
+	map_foreachinrange(mob_ai_activate, &sd->bl, AREA_SIZE + ACTIVE_AI_RANGE, BL_MOB, tick);
 	return 0;
 }
 
+/*==========================================
+ * Serious processing of the active mobs of a map, each one thinks once per tick
+ * 1. Selection: mobs not seen by any player for ACTIVE_AI_TIMEOUT leave the set, the ones
+ *    due to think are queued in set order. Nothing but the set is modified here.
+ * 2. Thinking: the queued mobs run mob_ai_sub_hard (target search, walk, attack, skills) in
+ *    queue order. This phase can't be split across threads: map_foreach* share one block
+ *    list buffer and rnd() one state, and the decisions of a mob change what the next sees.
+ *------------------------------------------*/
+static void mob_ai_sub_active(struct s_mob_active *active, unsigned int tick)
+{
+	int i = 0, count = 0;
+
+	while(i < active->count) {
+		struct mob_data *md = active->list[i];
+
+		if(DIFF_TICK(tick, md->active_tick) > ACTIVE_AI_TIMEOUT) {
+			mob_ai_deactivate(md); //Moves the last mob of the set into this slot
+			continue;
+		}
+		i++;
+		if(md->bl.prev == NULL || md->status.hp == 0 || DIFF_TICK(tick, md->last_thinktime) < MIN_MOBTHINKTIME)
+			continue; //Not due this tick
+		if(count == mob_ai_queue_max) {
+			mob_ai_queue_max += 64;
+			RECREATE(mob_ai_queue, struct mob_data*, mob_ai_queue_max);
+		}
+		mob_ai_queue[count++] = md;
+	}
+
+	map_freeblock_lock(); //Queued mobs may be killed and freed by the ones thinking before them
+	for(i = 0; i < count; i++) {
+		struct mob_data *md = mob_ai_queue[i];
+
+		if(mob_ai_sub_hard(md, tick)) { //Hard AI triggered
+			if(!md->state.spotted)
+				md->state.spotted = 1;
+			md->last_pcneartime = tick;
+		}
+	}
+	map_freeblock_unlock();
+}
+
 /*==========================================
  * Negligent mode MOB AI (PC is not in near)
  *------------------------------------------*/
@@ -1691,7 +1929,7 @@ static int mob_ai_sub_lazy(struct mob_data *md, va_list args)
 
 	nullpo_ret(md);
 
-	if(md->bl.prev == NULL)
+	if(md->bl.prev == NULL || mob_map_isfrozen(md->bl.m))
 		return 0;
 
 	tick = va_arg(args, unsigned int);
@@ -1740,9 +1978,22 @@ static int mob_ai_sub_lazy(struct mob_data *md, va_list args)
 /*==========================================
  * Negligent processing for mob outside PC field of view   (interval timer function)
  *------------------------------------------*/
+static int mob_ai_sub_lazy_bl(struct block_list *bl, va_list args)
+{
+	return mob_ai_sub_lazy((struct mob_data *)bl, args);
+}
+
 static int mob_ai_lazy(int tid, unsigned int tick, int id, intptr_t data)
 {
-	map_foreachmob(mob_ai_sub_lazy,tick);
+	if(battle_config.mob_freeze_empty_maps) { //Frozen maps cost nothing, only visit the others
+		int m;
+
+		for(m = 0; m < map_num; m++) {
+			if(!mob_map_isfrozen(m))
+				map_foreachinmap(mob_ai_sub_lazy_bl, m, BL_MOB, tick);
+		}
+	} else
+		map_foreachmob(mob_ai_sub_lazy,tick);
 	return 0;
 }
 
@@ -1753,8 +2004,15 @@ static int mob_ai_hard(int tid, unsigned int tick, int id, intptr_t data)
 {
 	if (battle_config.mob_ai&0x20)
 		map_foreachmob(mob_ai_sub_lazy,tick);
-	else
+	else {
+		int m;
+
 		map_foreachpc(mob_ai_sub_foreachclient,tick);
+		for (m = 0; m < map_num; m++) {
+			if (mob_active[m].count)
+				mob_ai_sub_active(&mob_active[m], tick);
+		}
+	}
 	return 0;
 }
 
@@ -2314,7 +2572,6 @@ int mob_dead(struct mob_data *md, struct block_list *src, int type)
 	{ //Item Drop
 		struct item_drop_list *dlist = ers_alloc(item_drop_list_ers, struct item_drop_list);
 		struct item_drop *ditem;
-		struct item_data* it = NULL;
 		int drop_rate;
 #ifdef RENEWAL_DROP
 		int drop_modifier = mvp_sd    ? pc_level_penalty_mod(mvp_sd, md->level, md->status.class_, 2)   :
@@ -2330,12 +2587,10 @@ int mob_dead(struct mob_data *md, struct block_list *src, int type)
 		dlist->third_charid = (third_sd ? third_sd->status.char_id : 0);
 		dlist->item = NULL;
 
-		for(i = 0; i < MAX_MOB_DROP; i++) {
-			if(md->db->dropitem[i].nameid <= 0)
-				continue;
-			if(!(it = itemdb_exists(md->db->dropitem[i].nameid)))
-				continue;
-			drop_rate = md->db->dropitem[i].p;
+		for(i = 0; i < md->db->drop_count; i++) {
+			struct item_data *it = md->db->drop[i].data;
+
+			drop_rate = md->db->drop[i].p;
 			if(drop_rate <= 0) {
 				if (battle_config.drop_rate0item)
 					continue;
@@ -2383,11 +2638,11 @@ int mob_dead(struct mob_data *md, struct block_list *src, int type)
 				continue;
 
 			if(mvp_sd && it->type == IT_PETEGG) {
-				pet_create_egg(mvp_sd, md->db->dropitem[i].nameid);
+				pet_create_egg(mvp_sd, it->nameid);
 				continue;
 			}
 
-			ditem = mob_setdropitem(md->db->dropitem[i].nameid, 1);
+			ditem = mob_setdropitem(it->nameid, 1);
 
 			//A Rare Drop Global Announce by Lupus
 			if(mvp_sd && drop_rate <= battle_config.rare_drop_announce) {
@@ -2398,7 +2653,7 @@ int mob_dead(struct mob_data *md, struct block_list *src, int type)
 			}
 			//Announce first, or else ditem will be freed. [Lance]
 			//By popular demand, use base drop rate for autoloot code. [Skotlex]
-			mob_item_drop(md, dlist, ditem, 0, md->db->dropitem[i].p, homkillonly);
+			mob_item_drop(md, dlist, ditem, 0, md->db->drop[i].p, homkillonly);
 		}
 
 		//Ore Discovery [Celest]
@@ -3104,6 +3359,29 @@ struct mob_data *mob_getfriendstatus(struct mob_data *md,int cond1,int cond2)
 	return fr;
 }
 
+/*==========================================
+ * Builds the per state skill indexes of a mob
+ * A state uses its own skills and the MSS_ANY ones, and the MSS_ANYTARGET
+ * ones unless looting. Dead mobs only use their MSS_DEAD skills.
+ *------------------------------------------*/
+void mob_skill_index(struct mob_db *db)
+{
+	int i, state;
+
+	nullpo_retv(db);
+
+	for (state = 0; state < MSS_ANYTARGET; state++) {
+		db->skill_state_count[state] = 0;
+		for (i = 0; i < db->maxskill; i++) {
+			enum MobSkillState ss = db->skill[i].state;
+
+			if (ss != state && (state == MSS_DEAD || (ss != MSS_ANY && (ss != MSS_ANYTARGET || state == MSS_LOOT))))
+				continue;
+			db->skill_state[state][db->skill_state_count[state]++] = i;
+		}
+	}
+}
+
 /*==========================================
  * Skill use judging
  *------------------------------------------*/
@@ -3113,7 +3391,20 @@ int mobskill_use(struct mob_data *md, unsigned int tick, int event)
 	struct block_list *fbl = NULL; //Friend bl, which can either be a BL_PC or BL_MOB depending on the situation [Skotlex]
 	struct block_list *bl;
 	struct mob_data *fmd = NULL;
-	int i, j, n;
+	//Area scans are shared by the candidate skills asking for the same thing
+	struct {
+		bool done;
+		int min, max;
+		struct block_list *bl;
+	} hp_scan = { false, 0, 0, NULL };
+	struct {
+		bool done;
+		int cond1, cond2;
+		struct mob_data *md;
+	} status_scan = { false, 0, 0, NULL };
+	int slave_count = -1, targeted_count = -1;
+	uint8 *list;
+	int i, j, k, n, count;
 	short skill_target;
 
 	nullpo_ret(md);
@@ -3125,27 +3416,29 @@ int mobskill_use(struct mob_data *md, unsigned int tick, int event)
 	if (event == -1 && DIFF_TICK(md->ud.canact_tick, tick) > 0)
 		return 0; //Skill act delay only affects non-event skills
 
+	if (md->state.skillstate < 0 || md->state.skillstate >= MSS_ANYTARGET)
+		return 0;
+
+	list = md->db->skill_state[md->state.skillstate];
+	if (!(count = md->db->skill_state_count[md->state.skillstate]))
+		return 0;
+
 	//Pick a starting position and loop from that
-	i = (battle_config.mob_ai&0x100) ? rnd()%md->db->maxskill : 0;
-	for (n = 0; n < md->db->maxskill; i++, n++) {
+	k = (battle_config.mob_ai&0x100) ? rnd()%count : 0;
+	for (n = 0; n < count; k++, n++) {
 		int c2, flag = 0;
 
-		if (i == md->db->maxskill)
-			i = 0;
+		if (k == count)
+			k = 0;
+		i = list[k];
 
 		if (DIFF_TICK(tick, md->skilldelay[i]) < ms[i].delay)
 			continue;
 
+		if (ms[i].state == MSS_ANYTARGET && !md->target_id)
+			continue; //ANYTARGET works with any state as long as there's a target [Skotlex]
+
 		c2 = ms[i].cond2;
-		
-		if (ms[i].state != md->state.skillstate) {
-			if (md->state.skillstate != MSS_DEAD && (ms[i].state == MSS_ANY ||
-				(ms[i].state == MSS_ANYTARGET && md->target_id && md->state.skillstate != MSS_LOOT)
-			)) //ANYTARGET works with any state as long as there's a target [Skotlex]
-				;
-			else
-				continue;
-		}
 
 		if (rnd() % 10000 > ms[i].permillage) //Lupus (max value = 10000)
 			continue;
@@ -3181,26 +3474,40 @@ int mobskill_use(struct mob_data *md, unsigned int tick, int event)
 					flag ^= (ms[i].cond1 == MSC_MYSTATUSOFF);
 					break;
 				case MSC_FRIENDHPLTMAXRATE: //Friend HP < maxhp %
-					flag = ((fbl = mob_getfriendhprate(md, 0, ms[i].cond2)) != NULL);
-					break;
-				case MSC_FRIENDHPINRATE	:
-					flag = ((fbl = mob_getfriendhprate(md, ms[i].cond2, ms[i].val[0])) != NULL);
+				case MSC_FRIENDHPINRATE: {
+						int min_rate = (ms[i].cond1 == MSC_FRIENDHPINRATE ? ms[i].cond2 : 0);
+						int max_rate = (ms[i].cond1 == MSC_FRIENDHPINRATE ? ms[i].val[0] : ms[i].cond2);
+
+						if (!hp_scan.done || hp_scan.min != min_rate || hp_scan.max != max_rate) {
+							hp_scan.done = true;
+							hp_scan.min = min_rate;
+							hp_scan.max = max_rate;
+							hp_scan.bl = mob_getfriendhprate(md, min_rate, max_rate);
+						}
+						flag = ((fbl = hp_scan.bl) != NULL);
+					}
 					break;
 				case MSC_FRIENDSTATUSON: //Friend status[num] on
 				case MSC_FRIENDSTATUSOFF: //Friend status[num] off
-					flag = ((fmd = mob_getfriendstatus(md, ms[i].cond1, ms[i].cond2)) != NULL);
+					if (!status_scan.done || status_scan.cond1 != ms[i].cond1 || status_scan.cond2 != ms[i].cond2) {
+						status_scan.done = true;
+						status_scan.cond1 = ms[i].cond1;
+						status_scan.cond2 = ms[i].cond2;
+						status_scan.md = mob_getfriendstatus(md, ms[i].cond1, ms[i].cond2);
+					}
+					flag = ((fmd = status_scan.md) != NULL);
 					break;
 				case MSC_SLAVELT: //Slave < num
-					flag = (mob_countslave(&md->bl) < c2);
-					break;
-				case MSC_ATTACKPCGT: //Attack pc > num
-					flag = (unit_counttargeted(&md->bl) > c2);
-					break;
 				case MSC_SLAVELE: //Slave <= num
-					flag = (mob_countslave(&md->bl) <= c2);
+					if (slave_count < 0)
+						slave_count = mob_countslave(&md->bl);
+					flag = (ms[i].cond1 == MSC_SLAVELT ? slave_count < c2 : slave_count <= c2);
 					break;
+				case MSC_ATTACKPCGT: //Attack pc > num
 				case MSC_ATTACKPCGE: //Attack pc >= num
-					flag = (unit_counttargeted(&md->bl) >= c2);
+					if (targeted_count < 0)
+						targeted_count = unit_counttargeted(&md->bl);
+					flag = (ms[i].cond1 == MSC_ATTACKPCGT ? targeted_count > c2 : targeted_count >= c2);
 					break;
 				case MSC_AFTERSKILL:
 					flag = (md->ud.skill_id == c2);
@@ -3559,6 +3866,8 @@ int mob_clone_spawn(struct map_session_data *sd, int16 m, int16 x, int16 y, cons
 	//We grant the session it's fd value back
 	sd->fd = fd;
 
+	mob_skill_index(db);
+
 	//Finally, spawn it
 	md = mob_once_spawn_sub(&sd->bl, m, x, y, "--en--", mob_id, event, SZ_SMALL, AI_NONE);
 	if (!md)
@@ -4666,6 +4975,41 @@ static void mob_drop_ratio_adjust(void) {
 
 	//Now that we are done we can delete the stored item ratios
 	mob_item_drop_ratio->clear(mob_item_drop_ratio, mob_item_drop_ratio_free);
+	mob_drop_build();
+}
+
+/**
+ * Builds the drop table rolled on kill of one monster from its adjusted dropitem rates
+ * Must be run again whenever dropitem changes (addmonsterdrop/delmonsterdrop).
+ * @param mob Monster DB entry
+ */
+void mob_drop_build_db(struct mob_db *mob) {
+	int i;
+
+	mob->drop_count = 0;
+	for (i = 0; i < MAX_MOB_DROP; i++) {
+		struct item_data *id;
+
+		if (mob->dropitem[i].nameid == 0 || !(id = itemdb_exists(mob->dropitem[i].nameid)))
+			continue;
+
+		mob->drop[mob->drop_count].data = id;
+		mob->drop[mob->drop_count].p = mob->dropitem[i].p;
+		mob->drop_count++;
+	}
+}
+
+/**
+ * Builds the drop tables rolled on kill from the adjusted dropitem rates
+ * Must be run again when the item data is reloaded, the tables keep pointers to it.
+ */
+void mob_drop_build(void) {
+	int i;
+
+	for (i = 0; i <= MAX_MOB_DB; i++) {
+		if (mob_db_data[i])
+			mob_drop_build_db(mob_db_data[i]);
+	}
 }
 
 /**
@@ -4736,12 +5080,18 @@ static int mob_skill_db_free(DBKey key, DBData *data, va_list ap) {
 static void mob_skill_db_set(void) {
 	DBIterator *iter = db_iterator(mob_skill_db);
 	struct s_mob_skill *skill = NULL;
+	int i;
 
 	for (skill = (struct s_mob_skill *)dbi_first(iter);  dbi_exists(iter); skill = (struct s_mob_skill *)dbi_next(iter))
 		mob_skill_db_set_single(skill);
 
 	dbi_destroy(iter);
 
+	for (i = 0; i <= MAX_MOB_DB; i++) {
+		if (mob_db_data[i] != NULL)
+			mob_skill_index(mob_db_data[i]);
+	}
+
 	//ShowStatus("Set skills to '%d' monsters.\n", db_size(mob_skill_db));
 	mob_skill_db->clear(mob_skill_db, mob_skill_db_free);
 }
@@ -4797,6 +5147,8 @@ void mob_clear_spawninfo() { //Clear spawn related information for a script relo
  *------------------------------------------*/
 void do_init_mob(void)
 { //Initialize the mob database
+	int i;
+
 	memset(mob_db_data,0,sizeof(mob_db_data)); //Clear the array
 	mob_db_data[0] = (struct mob_db*)aCalloc(1, sizeof (struct mob_db));	//This mob is used for random spawns
 	mob_makedummymobdb(0); //The first time this is invoked, it creates the dummy mob
@@ -4805,8 +5157,10 @@ void do_init_mob(void)
 	mob_item_drop_ratio = idb_alloc(DB_OPT_BASE);
 	mob_skill_db = idb_alloc(DB_OPT_BASE);
 	mob_load();
+	for (i = 0; i < MAX_MAP_PER_SERVER; i++)
+		mob_spawnqueue[i].timer = INVALID_TIMER;
 
-	add_timer_func_list(mob_delayspawn,"mob_delayspawn");
+	add_timer_func_list(mob_spawnqueue_timer,"mob_spawnqueue_timer");
 	add_timer_func_list(mob_delay_item_drop,"mob_delay_item_drop");
 	add_timer_func_list(mob_ai_hard,"mob_ai_hard");
 	add_timer_func_list(mob_ai_lazy,"mob_ai_lazy");
@@ -4828,6 +5182,35 @@ void do_final_mob(void)
 		aFree(mob_dummy);
 		mob_dummy = NULL;
 	}
+	for (i = 0; i < MAX_MAP_PER_SERVER; i++) {
+		if (mob_active[i].list != NULL) {
+			aFree(mob_active[i].list);
+			mob_active[i].list = NULL;
+		}
+		mob_active[i].count = mob_active[i].max = 0;
+	}
+	if (mob_ai_queue != NULL) {
+		aFree(mob_ai_queue);
+		mob_ai_queue = NULL;
+		mob_ai_queue_max = 0;
+	}
+	for (i = 0; i < MAX_MAP_PER_SERVER; i++) {
+		if (mob_frozen[i].spawn != NULL)
+			aFree(mob_frozen[i].spawn);
+	}
+	memset(mob_frozen, 0, sizeof(mob_frozen));
+	for (i = 0; i < MAX_MAP_PER_SERVER; i++) {
+		struct s_mob_spawnqueue *queue = &mob_spawnqueue[i];
+		int j;
+
+		for (j = 0; j < queue->count; j++)
+			aFree(queue->bucket[j].id);
+		if (queue->bucket != NULL)
+			aFree(queue->bucket);
+		if (queue->timer != INVALID_TIMER)
+			delete_timer(queue->timer, mob_spawnqueue_timer);
+	}
+	memset(mob_spawnqueue, 0, sizeof(mob_spawnqueue));
 	for (i = 0; i <= MAX_MOB_DB; i++) {
 		if (mob_db_data[i] != NULL) {
 			aFree(mob_db_data[i]);
@@ -170,12 +170,19 @@ struct mob_db {
 		unsigned short nameid;
 		int p;
 	} mvpitem[MAX_MVP_DROP];
+	struct s_mob_drop {
+		struct item_data *data;
+		int p;
+	} drop[MAX_MOB_DROP]; //Filled slots of dropitem with a known item (see mob_drop_build)
+	uint8 drop_count;
 	struct status_data status;
 	struct view_data vd;
 	unsigned int option;
 	int summonper[MAX_RANDOMMONSTER];
 	int maxskill;
 	struct mob_skill skill[MAX_MOBSKILL];
+	uint8 skill_state[MSS_ANYTARGET][MAX_MOBSKILL]; //Indexes of the skills usable in each state (see mob_skill_index)
+	uint8 skill_state_count[MSS_ANYTARGET];
 	struct spawn_info spawn[10];
 	int effect_id;
 };
@@ -215,7 +222,8 @@ struct mob_data {
 		unsigned int flag : 2; //0: Normal. 1: Homunc exp. 2: Pet exp
 	} dmglog[DAMAGELOG_SIZE];
 	struct spawn_data *spawn; //Spawn data.
-	int spawn_timer; //Required for Convex Mirror
+	unsigned int spawn_tick; //Respawn time, required for Convex Mirror
+	bool spawn_pending; //Waiting in the respawn queue of its map
 	struct item *lootitem;
 	short mob_id;
 	unsigned int tdmg; //Stores total damage given to the mob, for exp calculations. [Skotlex]
@@ -225,6 +233,8 @@ struct mob_data {
 	unsigned int bg_id; //BattleGround System
 
 	unsigned int next_walktime,last_thinktime,last_linktime,last_pcneartime,dmgtick;
+	unsigned int active_tick; //Last time a player had it in active AI range
+	int active_pos; //Position in the active set of its map, -1 if not in it (see mob_ai_hard)
 	short move_fail_count;
 	short lootitem_count;
 	short min_chase;
@@ -324,9 +334,11 @@ int mob_randomwalk(struct mob_data *md, unsigned int tick);
 int mob_warpchase(struct mob_data *md, struct block_list *target);
 int mob_target(struct mob_data *md, struct block_list *bl, int dist);
 int mob_unlocktarget(struct mob_data *md, unsigned int tick);
+void mob_ai_deactivate(struct mob_data *md);
+void mob_freeze_map(int16 m);
+void mob_thaw_map(int16 m);
 struct mob_data* mob_spawn_dataset(struct spawn_data *data);
 int mob_spawn(struct mob_data *md);
-int mob_delayspawn(int tid, unsigned int tick, int id, intptr_t data);
 int mob_setdelayspawn(struct mob_data *md);
 int mob_parse_dataset(struct spawn_data *data);
 void mob_log_damage(struct mob_data *md, struct block_list *src, int damage);
@@ -371,6 +383,9 @@ int mob_clone_spawn(struct map_session_data *sd, int16 m, int16 x, int16 y, cons
 int mob_clone_delete(struct mob_data *md);
 
 void mob_reload(void);
+void mob_skill_index(struct mob_db *db);
+void mob_drop_build(void);
+void mob_drop_build_db(struct mob_db *mob);
 
 //MvP Tomb System
 void mvptomb_create(struct mob_data *md, char *killer, time_t time);
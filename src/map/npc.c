@@ -2055,6 +2055,7 @@ int npc_unload(struct npc_data *nd, bool single) {
 	}
 
 	script_stop_sleeptimers(nd->bl.id);
+	clif_freeviewcache(&nd->ud);
 	aFree(nd);
 	return 0;
 }
@@ -2280,6 +2281,7 @@ struct npc_data* npc_create_npc(int m, int x, int y)
 	nd->bl.x = x;
 	nd->bl.y = y;
 	nd->area_size = AREA_SIZE + 1;
+	status_change_init_data(&nd->sc); //NPCs not placed on a map never reach status_change_init
 
 	return nd;
 }
@@ -4492,6 +4494,7 @@ void do_init_npc(void)
 	fake_nd->bl.id = npc_get_new_npc_id();
 	fake_nd->class_ = -1;
 	fake_nd->speed = 200;
+	status_change_init_data(&fake_nd->sc);
 	strcpy(fake_nd->name,"FAKE_NPC");
 	memcpy(fake_nd->exname,fake_nd->name,9);
 
@@ -34,6 +34,7 @@
 static DBMap* party_db; // int party_id -> struct party_data* (releases data)
 static DBMap* party_booking_db; // int char_id -> struct party_booking_ad_info* (releases data) // Party Booking [Spiria]
 static unsigned long party_booking_nextid = 1;
+static struct s_xy_stats party_xy_stats; // Traffic of party_send_xy_timer
 
 int party_send_xy_timer(int tid, unsigned int tick, int id, intptr_t data);
 int party_create_byscript;
@@ -933,14 +934,18 @@ int party_skill_check(struct map_session_data *sd, int party_id, uint16 skill_id
 	return 0;
 }
 
+/// Sends the positions and hp of the party members that changed since the last run,
+/// coalesced into one write per recipient (see clif_party_xy_batch).
 int party_send_xy_timer(int tid, unsigned int tick, int id, intptr_t data)
 {
 	struct party_data *p;
+	uint64 packets = party_xy_stats.packets, bytes = party_xy_stats.bytes;
 
 	DBIterator *iter = db_iterator(party_db);
 	//For each existing party
 	for( p = (struct party_data *)dbi_first(iter); dbi_exists(iter); p = (struct party_data *)dbi_next(iter) ) {
-		int i;
+		uint8 flag[MAX_PARTY];
+		int i, changed = 0;
 
 		if( !p->party.count ) //No online party members so do not iterate
 			continue;
@@ -949,25 +954,41 @@ int party_send_xy_timer(int tid, unsigned int tick, int id, intptr_t data)
 		for( i = 0; i < MAX_PARTY; i++ ) {
 			struct map_session_data* sd = p->data[i].sd;
 
+			flag[i] = 0;
 			if( !sd )
 				continue;
 
 			if( p->data[i].x != sd->bl.x || p->data[i].y != sd->bl.y ) { //Perform position update
-				clif_party_xy(sd);
+				flag[i] |= XY_UPDATE_POS;
 				p->data[i].x = sd->bl.x;
 				p->data[i].y = sd->bl.y;
 			}
 			if( battle_config.party_hp_mode && p->data[i].hp != sd->battle_status.hp ) { //Perform hp update
-				clif_party_hp(sd);
+				flag[i] |= XY_UPDATE_HP;
 				p->data[i].hp = sd->battle_status.hp;
 			}
+			if( flag[i] )
+				changed++;
+		}
+		if( changed ) {
+			party_xy_stats.members += changed;
+			clif_party_xy_batch(p, flag, &party_xy_stats);
 		}
 	}
 	dbi_destroy(iter);
 
+	party_xy_stats.intervals++;
+	party_xy_stats.last_packets = (unsigned int)(party_xy_stats.packets - packets);
+	party_xy_stats.last_bytes = (unsigned int)(party_xy_stats.bytes - bytes);
 	return 0;
 }
 
+/// Traffic of party_send_xy_timer
+struct s_xy_stats* party_get_xy_stats(void)
+{
+	return &party_xy_stats;
+}
+
 int party_send_xy_clear(struct party_data *p)
 {
 	int i;
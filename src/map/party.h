@@ -9,6 +9,7 @@ struct block_list;
 struct map_session_data;
 struct party;
 struct item;
+struct s_xy_stats;
 
 #include <stdarg.h>
 
@@ -83,6 +84,7 @@ int party_send_message(struct map_session_data *sd,const char *mes,int len);
 int party_recv_message(int party_id,int account_id,const char *mes,int len);
 int party_skill_check(struct map_session_data *sd, int party_id, uint16 skill_id, uint16 skill_lv);
 int party_send_xy_clear(struct party_data *p);
+struct s_xy_stats* party_get_xy_stats(void);
 int party_exp_share(struct party_data *p,struct block_list *src,unsigned int base_exp,unsigned int job_exp,int zeny);
 int party_share_loot(struct party_data* p, struct map_session_data* sd, struct item* item, int first_charid);
 int party_send_dot_remove(struct map_session_data *sd);
@@ -35,6 +35,7 @@ struct path_node {
 	short g_cost; ///< Actual cost from start to this node
 	short f_cost; ///< g_cost + heuristic(this, goal)
 	short flag; ///< SET_OPEN / SET_CLOSED
+	unsigned int search; ///< Search the node belongs to (see path_search_id)
 };
 
 /// Binary heap of path nodes
@@ -43,7 +44,15 @@ BHEAP_STRUCT_DECL(node_heap, struct path_node*);
 /// Comparator for binary heap of path nodes (minimum cost at top)
 #define NODE_MINTOPCMP(i,j) ((i)->f_cost - (j)->f_cost)
 
-#define calc_index(x,y) (((x)+(y)*MAX_WALKPATH) & (MAX_WALKPATH*MAX_WALKPATH-1))
+/// Cells a walk path can reach lie within MAX_WALKPATH cells of its start,
+/// nodes are kept by their position in that square.
+#define PATH_WINDOW (MAX_WALKPATH * 2 + 1)
+#define calc_index(x0,y0,x,y) (((x) - (x0) + MAX_WALKPATH) + ((y) - (y0) + MAX_WALKPATH) * PATH_WINDOW)
+
+/// Nodes of the current search, reused between searches
+static struct path_node path_nodes[PATH_WINDOW * PATH_WINDOW];
+/// Current search, nodes of older searches are free
+static unsigned int path_search_id = 0;
 
 /// Estimates the cost from (x0,y0) to (x1,y1).
 /// This is inadmissible (overestimating) heuristic used by game client.
@@ -112,6 +121,59 @@ int path_blownpos(int16 m,int16 x0,int16 y0,int16 dx,int16 dy,int count)
 	return (x0<<16)|y0; //@TODO: Use 'struct point' here instead?
 }
 
+/// Checks whether any cell from (x0,y) to (x1,y) is a wall (neither walkable nor shootable).
+/// Tests a whole word of the terrain bitmaps at a time, all cells must be inside the map.
+static bool path_wall_run(struct map_data *md, int16 x0, int16 x1, int16 y)
+{
+	int w, w0 = map_cellword(md, x0, y), w1 = map_cellword(md, x1, y);
+
+	if( x0 > x1 )
+		return false; // Empty run
+
+	for( w = w0; w <= w1; w++ ) {
+		uint64 mask = UINT64_MAX;
+
+		if( w == w0 )
+			mask &= UINT64_MAX << (x0&63);
+		if( w == w1 )
+			mask &= UINT64_MAX >> (63 - (x1&63));
+		if( ((md->cell_walkable[w] | md->cell_shootable[w]) & mask) != mask )
+			return true;
+	}
+
+	return false;
+}
+
+/// Line of sight for x-major lines when the path itself is not wanted.
+/// Checks the cells of each row of the line together with path_wall_run.
+/// Like path_search_long, the starting cell is not checked.
+static bool path_search_long_wall(struct map_data *md, int16 x0, int16 y0, int16 x1, int16 y1)
+{
+	int dx = x1 - x0, dy = y1 - y0;
+	int wy = 0;
+	int16 run_x = x0 + 1, run_y = y0;
+
+	while( x0 != x1 ) {
+		x0++;
+		wy += dy;
+		if( wy >= dx ) {
+			wy -= dx;
+			if( path_wall_run(md, run_x, x0 - 1, run_y) )
+				return false;
+			run_x = x0;
+			run_y = ++y0;
+		} else if( wy < 0 ) {
+			wy += dx;
+			if( path_wall_run(md, run_x, x0 - 1, run_y) )
+				return false;
+			run_x = x0;
+			run_y = --y0;
+		}
+	}
+
+	return !path_wall_run(md, run_x, x0, run_y);
+}
+
 /*==========================================
  * is ranged attack from (x0,y0) to (x1,y1) possible?
  *------------------------------------------*/
@@ -122,6 +184,7 @@ bool path_search_long(struct shootpath_data *spd,int16 m,int16 x0,int16 y0,int16
 	int weight;
 	struct map_data *md;
 	struct shootpath_data s_spd;
+	bool want_path = (spd != NULL);
 
 	if( spd == NULL )
 		spd = &s_spd; // use dummy output variable
@@ -144,6 +207,11 @@ bool path_search_long(struct shootpath_data *spd,int16 m,int16 x0,int16 y0,int16
 	spd->y[0] = y0;
 
 	if (dx > abs(dy)) {
+		// The last row and column never count as walls (see map_getcellp), so the
+		// bitmap test is only used when both ends are within the rest of the map
+		if (!want_path && cell == CELL_CHKWALL &&
+			x0 >= 0 && x1 < md->xs - 1 && y0 >= 0 && y0 < md->ys - 1 && y1 >= 0 && y1 < md->ys - 1)
+			return path_search_long_wall(md, x0, y0, x1, y1);
 		weight = dx;
 		spd->ry = 1;
 	} else {
@@ -205,11 +273,18 @@ static int heap_update_node(struct node_heap *heap, struct path_node *node)
 
 /// Path_node processing in A* pathfinding.
 /// Adds new node to heap and updates/re-adds old ones if necessary.
-static int add_path(struct node_heap *heap, struct path_node *tp, int16 x, int16 y, int g_cost, struct path_node *parent, int h_cost)
+/// Nodes that no walk path from (x0,y0) to (x1,y1) could go through are skipped.
+static int add_path(struct node_heap *heap, struct path_node *tp, int16 x0, int16 y0, int16 x1, int16 y1, int16 x, int16 y, int g_cost, struct path_node *parent)
 {
-	int i = calc_index(x, y);
+	int i, h_cost;
+
+	if (max(abs(x - x0), abs(y - y0)) + max(abs(x1 - x), abs(y1 - y)) > MAX_WALKPATH)
+		return 0; // Any path through here has more steps than a walk path can hold
+
+	h_cost = heuristic(x, y, x1, y1);
 
-	if (tp[i].x == x && tp[i].y == y) { // We processed this node before
+	i = calc_index(x0, y0, x, y);
+	if (tp[i].search == path_search_id) { // We processed this node before
 		if (g_cost < tp[i].g_cost) { // New path to this node is better than old one
 			// Update costs and parent
 			tp[i].g_cost = g_cost;
@@ -226,10 +301,8 @@ static int add_path(struct node_heap *heap, struct path_node *tp, int16 x, int16
 		return 0;
 	}
 
-	if (tp[i].x || tp[i].y) // Index is already taken; see `tp` array FIXME for details
-		return 1;
-
 	// New node
+	tp[i].search = path_search_id;
 	tp[i].x = x;
 	tp[i].y = y;
 	tp[i].g_cost = g_cost;
@@ -241,13 +314,60 @@ static int add_path(struct node_heap *heap, struct path_node *tp, int16 x, int16
 }
 ///@}
 
+/// @name Walk path cache
+/// A* results kept by map, start and goal, so units asking for the same
+/// path again (chasing, walking to the same spot) skip the search.
+/// Failed searches are kept as well.
+/// @{
+
+#define PATH_CACHE_SETS 256 ///< Must be a power of 2
+#define PATH_CACHE_WAYS 4 ///< Entries per set, the least recently used one is replaced
+
+struct path_cache_entry {
+	int16 m, x0, y0, x1, y1;
+	cell_chk cell;
+	unsigned int version; ///< path_cache_version of the map when stored
+	unsigned int used; ///< Last use, 0 if the entry is free
+	bool found;
+	struct walkpath_data wpd;
+};
+
+static struct path_cache_entry path_cache[PATH_CACHE_SETS][PATH_CACHE_WAYS];
+static unsigned int path_cache_version[MAX_MAP_PER_SERVER]; ///< Bumped when a cell of the map changes
+static unsigned int path_cache_use = 0;
+static uint64 path_cache_hits = 0, path_cache_misses = 0;
+
+#ifdef CELL_NOSTACK
+	// Units stacking on a cell change CELL_CHKNOPASS without going through map_setcell
+	#define path_cache_cell(cell) ((cell) == CELL_CHKNOREACH)
+#else
+	#define path_cache_cell(cell) ((cell) == CELL_CHKNOPASS || (cell) == CELL_CHKNOREACH)
+#endif
+
+#define path_cache_set(m,x0,y0,x1,y1) (((((x0) | ((y0) << 10)) * 2654435761U) ^ (((x1) | ((y1) << 10)) * 40503U) ^ (unsigned int)(m)) & (PATH_CACHE_SETS - 1))
+
+/// Drops the cached paths of map m, to be called when its walkable cells change
+void path_cache_clear(int16 m)
+{
+	if (m >= 0 && m < MAX_MAP_PER_SERVER)
+		path_cache_version[m]++;
+}
+
+/// Returns the cache hits and misses since the server started
+void path_cache_stats(uint64 *hits, uint64 *misses)
+{
+	*hits = path_cache_hits;
+	*misses = path_cache_misses;
+}
+/// @}
+
 /*==========================================
  * path search (x0,y0)->(x1,y1)
  * wpd: path info will be written here
  * flag: &1 = easy path search only
  * cell: type of obstruction to check for
  *------------------------------------------*/
-bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int flag, cell_chk cell)
+static bool path_search_sub(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int flag, cell_chk cell)
 {
 	register int i, x, y, dx = 0, dy = 0;
 	struct map_data *md;
@@ -316,20 +436,21 @@ bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x
 
 		BHEAP_STRUCT_VAR(node_heap, open_set); // 'Open' set
 
-		// FIXME: This array is too small to ensure all paths shorter than MAX_WALKPATH
-		// can be found without node collision: calc_index(node1) = calc_index(node2)
-		// Figure out more proper size or another way to keep track of known nodes
-		struct path_node tp[MAX_WALKPATH * MAX_WALKPATH];
+		struct path_node *tp = path_nodes;
 		struct path_node *current, *it;
 		int xs = md->xs - 1;
 		int ys = md->ys - 1;
 		int len = 0;
 		int j;
 
-		memset(tp, 0, sizeof(tp));
+		if (++path_search_id == 0) { // Wrapped around, forget all nodes
+			memset(path_nodes, 0, sizeof(path_nodes));
+			path_search_id = 1;
+		}
 
 		// Start node
-		i = calc_index(x0, y0);
+		i = calc_index(x0, y0, x0, y0);
+		tp[i].search = path_search_id;
 		tp[i].parent = NULL;
 		tp[i].x      = x0;
 		tp[i].y      = y0;
@@ -379,21 +500,21 @@ bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x
 #define chk_dir(d) ((allowed_dirs & (d)) == (d))
 			// Process neighbors of current node
 			if (chk_dir(DIR_SOUTH|DIR_EAST) && !map_getcellp(md, x+1, y-1, cell))
-				e += add_path(&open_set, tp, x+1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y-1, x1, y1)); // (x+1, y-1) 5
+				e += add_path(&open_set, tp, x0, y0, x1, y1, x+1, y-1, g_cost + MOVE_DIAGONAL_COST, current); // (x+1, y-1) 5
 			if (chk_dir(DIR_EAST))
-				e += add_path(&open_set, tp, x+1, y, g_cost + MOVE_COST, current, heuristic(x+1, y, x1, y1)); // (x+1, y) 6
+				e += add_path(&open_set, tp, x0, y0, x1, y1, x+1, y, g_cost + MOVE_COST, current); // (x+1, y) 6
 			if (chk_dir(DIR_NORTH|DIR_EAST) && !map_getcellp(md, x+1, y+1, cell))
-				e += add_path(&open_set, tp, x+1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x+1, y+1, x1, y1)); // (x+1, y+1) 7
+				e += add_path(&open_set, tp, x0, y0, x1, y1, x+1, y+1, g_cost + MOVE_DIAGONAL_COST, current); // (x+1, y+1) 7
 			if (chk_dir(DIR_NORTH))
-				e += add_path(&open_set, tp, x, y+1, g_cost + MOVE_COST, current, heuristic(x, y+1, x1, y1)); // (x, y+1) 0
+				e += add_path(&open_set, tp, x0, y0, x1, y1, x, y+1, g_cost + MOVE_COST, current); // (x, y+1) 0
 			if (chk_dir(DIR_NORTH|DIR_WEST) && !map_getcellp(md, x-1, y+1, cell))
-				e += add_path(&open_set, tp, x-1, y+1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y+1, x1, y1)); // (x-1, y+1) 1
+				e += add_path(&open_set, tp, x0, y0, x1, y1, x-1, y+1, g_cost + MOVE_DIAGONAL_COST, current); // (x-1, y+1) 1
 			if (chk_dir(DIR_WEST))
-				e += add_path(&open_set, tp, x-1, y, g_cost + MOVE_COST, current, heuristic(x-1, y, x1, y1)); // (x-1, y) 2
+				e += add_path(&open_set, tp, x0, y0, x1, y1, x-1, y, g_cost + MOVE_COST, current); // (x-1, y) 2
 			if (chk_dir(DIR_SOUTH|DIR_WEST) && !map_getcellp(md, x-1, y-1, cell))
-				e += add_path(&open_set, tp, x-1, y-1, g_cost + MOVE_DIAGONAL_COST, current, heuristic(x-1, y-1, x1, y1)); // (x-1, y-1) 3
+				e += add_path(&open_set, tp, x0, y0, x1, y1, x-1, y-1, g_cost + MOVE_DIAGONAL_COST, current); // (x-1, y-1) 3
 			if (chk_dir(DIR_SOUTH))
-				e += add_path(&open_set, tp, x, y-1, g_cost + MOVE_COST, current, heuristic(x, y-1, x1, y1)); // (x, y-1) 4
+				e += add_path(&open_set, tp, x0, y0, x1, y1, x, y-1, g_cost + MOVE_COST, current); // (x, y-1) 4
 #undef chk_dir
 			if (e) {
 				BHEAP_CLEAR(open_set);
@@ -421,6 +542,53 @@ bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x
 	return false;
 }
 
+/// Same as path_search_sub, A* searches go through the walk path cache
+bool path_search(struct walkpath_data *wpd, int16 m, int16 x0, int16 y0, int16 x1, int16 y1, int flag, cell_chk cell)
+{
+	struct path_cache_entry *set, *entry;
+	struct walkpath_data s_wpd;
+	int i;
+
+	if ((flag&1) || !path_cache_cell(cell) || m < 0 || m >= MAX_MAP_PER_SERVER || (x0 == x1 && y0 == y1))
+		return path_search_sub(wpd, m, x0, y0, x1, y1, flag, cell);
+
+	if (wpd == NULL)
+		wpd = &s_wpd; // Use dummy output variable
+
+	set = path_cache[path_cache_set(m, x0, y0, x1, y1)];
+	ARR_FIND(0, PATH_CACHE_WAYS, i, set[i].used && set[i].m == m && set[i].x0 == x0 && set[i].y0 == y0 &&
+		set[i].x1 == x1 && set[i].y1 == y1 && set[i].cell == cell && set[i].version == path_cache_version[m]);
+	if (i < PATH_CACHE_WAYS) {
+		entry = &set[i];
+		entry->used = ++path_cache_use;
+		path_cache_hits++;
+		if (entry->found)
+			memcpy(wpd, &entry->wpd, sizeof(*wpd));
+		return entry->found;
+	}
+	path_cache_misses++;
+
+	// Replace the least recently used entry of the set
+	entry = &set[0];
+	for (i = 1; i < PATH_CACHE_WAYS && entry->used; i++) {
+		if (!set[i].used || set[i].used < entry->used)
+			entry = &set[i];
+	}
+
+	entry->found = path_search_sub(wpd, m, x0, y0, x1, y1, flag, cell);
+	entry->m = m;
+	entry->x0 = x0;
+	entry->y0 = y0;
+	entry->x1 = x1;
+	entry->y1 = y1;
+	entry->cell = cell;
+	entry->version = path_cache_version[m];
+	entry->used = ++path_cache_use;
+	if (entry->found)
+		memcpy(&entry->wpd, wpd, sizeof(*wpd));
+	return entry->found;
+}
+
 
 //Distance functions, taken from http://www.flipcode.com/articles/article_fastdistance.shtml
 bool check_distance(int dx, int dy, int distance)
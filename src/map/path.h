@@ -9,7 +9,14 @@
 #define MOVE_COST 10
 #define MOVE_DIAGONAL_COST 14
 
-#define MAX_WALKPATH 32
+// Longest walk path, in cells. It can be raised at build time so that units
+// follow long routes with a single search, the client has to allow it too.
+#ifndef MAX_WALKPATH
+	#define MAX_WALKPATH 32
+#endif
+#if MAX_WALKPATH > 255
+	#error MAX_WALKPATH must fit in walkpath_data::path_len
+#endif
 
 struct walkpath_data {
 	unsigned char path_len,path_pos;
@@ -46,6 +53,10 @@ int path_blownpos(int16 m,int16 x0,int16 y0,int16 dx,int16 dy,int count);
 // tries to find a walkable path
 bool path_search(struct walkpath_data *wpd,int16 m,int16 x0,int16 y0,int16 x1,int16 y1,int flag,cell_chk cell);
 
+// walk path cache
+void path_cache_clear(int16 m);
+void path_cache_stats(uint64 *hits, uint64 *misses);
+
 // tries to find a shootable path
 bool path_search_long(struct shootpath_data *spd,int16 m,int16 x0,int16 y0,int16 x1,int16 y1,cell_chk cell);
 
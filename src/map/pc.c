@@ -683,6 +683,22 @@ void pc_makesavestatus(struct map_session_data *sd)
 	}
 }
 
+/**
+ * Clears a map_session_data and sets the fields that must never be left NULL.
+ * Every place that builds a map_session_data by hand (login, autotrade, console) goes through here.
+ * @param sd
+ * @param packet_ver Client packet version, 0 for sessions without a client
+ */
+void pc_init_data(struct map_session_data *sd, int packet_ver)
+{
+	nullpo_retv(sd);
+
+	memset(sd, 0, sizeof(struct map_session_data));
+	sd->packet_ver = packet_ver;
+	sd->packet_db = packet_db[packet_ver];
+	status_change_init_data(&sd->sc);
+}
+
 /*==========================================
  * Off init ? Connection ?
  *------------------------------------------*/
@@ -1178,6 +1194,7 @@ bool pc_authok(struct map_session_data *sd, int login_id2, time_t expiration_tim
 	sd->pvp_timer = INVALID_TIMER;
 	sd->expiration_tid = INVALID_TIMER;
 	sd->autotrade_tid = INVALID_TIMER;
+	sd->areachar.timer = INVALID_TIMER;
 
 #ifdef SECURE_NPCTIMEOUT
 	//Initialize to defaults/expected
@@ -2352,6 +2369,8 @@ void pc_bonus(struct map_session_data *sd, int type, int val)
 
 	nullpo_retv(sd);
 
+	sd->cardfix_cache.count = 0; //Products of battle_calc_cardfix may change
+
 	status = &sd->base_status;
 
 	switch(type) {
@@ -2962,6 +2981,8 @@ void pc_bonus2(struct map_session_data *sd, int type, int type2, int val)
 
 	nullpo_retv(sd);
 
+	sd->cardfix_cache.count = 0; //Products of battle_calc_cardfix may change
+
 	switch(type) {
 		case SP_ADDELE: // bonus2 bAddEle,e,x;
 			PC_BONUS_CHK_ELEMENT(type2, SP_ADDELE);
@@ -3614,6 +3635,8 @@ void pc_bonus3(struct map_session_data *sd, int type, int type2, int type3, int
 {
 	nullpo_retv(sd);
 
+	sd->cardfix_cache.count = 0; //Products of battle_calc_cardfix may change
+
 	switch(type) {
 		case SP_ADD_MONSTER_DROP_ITEM: // bonus3 bAddMonsterDropItem,iid,r,n;
 			if(sd->state.lr_flag != 2)
@@ -5217,8 +5240,8 @@ char pc_setpos(struct map_session_data* sd, unsigned short mapindex, int x, int
 				struct status_change_entry *sce = sd->sc.data[SC_KNOWLEDGE];
 
 				if( sce->timer != INVALID_TIMER )
-					delete_timer(sce->timer, status_change_timer);
-				sce->timer = add_timer(gettick() + skill_get_time(SG_KNOWLEDGE, sce->val1), status_change_timer, sd->bl.id, SC_KNOWLEDGE);
+					status_change_delete_timer(sce);
+				sce->timer = status_change_add_timer(&sd->bl,SC_KNOWLEDGE,gettick() + skill_get_time(SG_KNOWLEDGE, sce->val1));
 			}
 			status_change_end(&sd->bl, SC_CLOAKINGEXCEED, INVALID_TIMER);
 			status_change_end(&sd->bl, SC_NEUTRALBARRIER_MASTER, INVALID_TIMER);
@@ -10582,6 +10605,8 @@ void pc_readdb(void)
 	FILE *fp;
 	char line[24000];
 
+	status_calc_cache_clear(); // Cached bonuses use the base weight of the jobs
+
 	// Reset
 	memset(job_info, 0, sizeof(job_info)); // job_info table
 
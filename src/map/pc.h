@@ -23,6 +23,7 @@
 #include "pc_groups.h"
 
 #define MAX_PC_BONUS 20 //Max bonus, usually used by item bonus
+#define MAX_CARDFIX_CACHE 8 //Card modifier products remembered per player (see battle_calc_cardfix)
 #define MAX_PC_SKILL_REQUIRE 5 //Max skill tree requirement
 #define MAX_PC_FEELHATE 3 //Max feel hate info
 #define DAMAGELOG_SIZE_PC 100 //Damage log
@@ -252,6 +253,7 @@ struct map_session_data {
 	int count_rewarp; //Count how many time we being rewarped
 
 	uint32 packet_ver;  //5: old, 6: 7july04, 7: 13july04, 8: 26july04, 9: 9aug04/16aug04/17aug04, 10: 6sept04, 11: 21sept04, 12: 18oct04, 13: 25oct04 ... 18
+	struct s_packet_db *packet_db; //Packet table of packet_ver (packet_db[packet_ver])
 	struct mmo_charstatus status;
 	struct registry save_reg;
 	
@@ -285,6 +287,11 @@ struct map_session_data {
 	int followtimer; //[MouseJstr]
 	int followtarget;
 
+	struct {
+		unsigned int tick; //Last search for mobs to activate (see mob_ai_sub_foreachclient)
+		int16 m, x, y;
+	} ai_scan;
+
 	time_t emotionlasttime; //To limit flood with emotion packets
 
 	short skillitem, skillitemlv;
@@ -504,6 +511,12 @@ struct map_session_data {
 	} feel_map[3]; // 0 - Sun; 1 - Moon; 2 - Stars
 	short hate_mob[3];
 
+	struct {
+		int *id; //Units left to show on arrival (see clif_getareachar_all)
+		int count, pos;
+		int timer;
+	} areachar;
+
 	int pvp_timer;
 	short pvp_point;
 	unsigned short pvp_rank, pvp_lastusers;
@@ -576,6 +589,12 @@ struct map_session_data {
 		unsigned int *pos; //Array of positions
 		unsigned char count;
 	} combos;
+	struct s_status_calc_cache *calc_cache; //Bonuses of the last equipment sets (see status_calc_cache_load)
+	struct s_cardfix_cache {
+		uint64 key[MAX_CARDFIX_CACHE];
+		short cardfix[MAX_CARDFIX_CACHE], cardfix_[MAX_CARDFIX_CACHE];
+		unsigned char count, next;
+	} cardfix_cache; //Products of battle_calc_cardfix, emptied whenever the bonuses change
 
 	/**
 	 * Guarantees your friend request is legit (for bugreport:4629)
@@ -845,6 +864,7 @@ bool pc_should_log_commands(struct map_session_data *sd);
 void pc_setrestartvalue(struct map_session_data *sd, char type);
 void pc_makesavestatus(struct map_session_data *sd);
 void pc_respawn(struct map_session_data* sd, clr_type clrtype);
+void pc_init_data(struct map_session_data *sd, int packet_ver);
 void pc_setnewpc(struct map_session_data *sd, int account_id, int char_id, int login_id1, unsigned int client_tick, int sex, int fd);
 bool pc_authok(struct map_session_data *sd, int login_id2, time_t expiration_time, int group_id, struct mmo_charstatus *st, bool changing_mapservers);
 void pc_authfail(struct map_session_data *sd);
@@ -855,6 +875,7 @@ int pc_close_npc_timer(int tid,unsigned int tick,int id,intptr_t data);
 uint8 pc_isequip(struct map_session_data *sd, int n);
 int pc_equippoint(struct map_session_data *sd,int n);
 void pc_setinventorydata(struct map_session_data *sd);
+void pc_setequipindex(struct map_session_data *sd);
 
 uint8 pc_checkskill(struct map_session_data *sd, uint16 skill_id);
 short pc_checkequip(struct map_session_data *sd, int pos);
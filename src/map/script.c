@@ -209,6 +209,7 @@ static struct str_data_struct {
 	int (*func)(struct script_state *st);
 	int val;
 	int next;
+	bool pure; //Buildin that only reads what status_calc_pc caches bonuses on (see script_purity_start)
 } *str_data = NULL;
 static int str_data_size = 0; // size of the data
 static int str_num = LABEL_START; // next id to be assigned
@@ -238,6 +239,22 @@ static int buildin_set_ref = 0;
 static int buildin_callsub_ref = 0;
 static int buildin_callfunc_ref = 0;
 static int buildin_getelementofarray_ref = 0;
+static int buildin_bonus_ref = 0;
+
+// Purity of the scripts run by status_calc_pc (see script_purity_start)
+static bool script_purity_tracking = false;
+static bool script_purity_ok = false;
+
+/// Buildins whose result only depends on the equipment of the player, or that only
+/// change script variables, so the bonuses they lead to can be cached.
+static const char* script_pure_buildin[] = {
+	"bonus", "bonus2", "bonus3", "bonus4", "bonus5",
+	"set", "setarray", "cleararray", "copyarray", "getarraysize", "getelementofarray",
+	"jump_zero", "goto", "end", "callfunc", "callsub", "return", "getarg",
+	"readparam", "getrefine", "getiteminfo", "isequipped", "isequippedcnt",
+	"getequipid", "getequipcardid", "getequipcardcnt", "getequipweaponlv", "getequipisequiped",
+	"getequipisenableref", "getequiprefinerycnt", "getequippercentrefinery",
+};
 
 // Caches compiled autoscript item code.
 // NOTE: This is not cleared when reloading itemdb.
@@ -2151,7 +2168,7 @@ const char* parse_syntax_close_sub(const char* p,int* flag)
  *------------------------------------------*/
 static void add_buildin_func(void)
 {
-	int i;
+	int i, j;
 
 	for( i = 0; buildin_func[i].func; i++ ) {
 		// arg must follow the pattern: (v|s|i|r|l)*\?*\*?
@@ -2177,15 +2194,47 @@ static void add_buildin_func(void)
 			str_data[n].type = C_FUNC;
 			str_data[n].val = i;
 			str_data[n].func = buildin_func[i].func;
+			ARR_FIND(0, ARRAYLENGTH(script_pure_buildin), j, strcmp(buildin_func[i].name, script_pure_buildin[j]) == 0);
+			str_data[n].pure = (j < ARRAYLENGTH(script_pure_buildin));
 
 			if( !strcmp(buildin_func[i].name, "set") ) buildin_set_ref = n;
 			else if( !strcmp(buildin_func[i].name, "callsub") ) buildin_callsub_ref = n;
 			else if( !strcmp(buildin_func[i].name, "callfunc") ) buildin_callfunc_ref = n;
 			else if( !strcmp(buildin_func[i].name, "getelementofarray") ) buildin_getelementofarray_ref = n;
+			else if( !strcmp(buildin_func[i].name, "bonus") ) buildin_bonus_ref = n;
 		}
 	}
 }
 
+/// Starts tracking whether the scripts run from now on are pure.
+/// A pure script only reads constants, its own scope variables, the equipment, stats,
+/// levels, class and sex of the player, and only calls buildins of script_pure_buildin.
+/// The bonuses of pure item scripts are the same as long as these are (see status_calc_pc).
+void script_purity_start(void)
+{
+	script_purity_tracking = true;
+	script_purity_ok = true;
+}
+
+/// Stops tracking, returns whether all the scripts run since script_purity_start were pure.
+bool script_purity_end(void)
+{
+	script_purity_tracking = false;
+	return script_purity_ok;
+}
+
+/// Whether a player parameter can be read by pure scripts
+static bool script_param_ispure(int type)
+{
+	switch( type ) {
+		case SP_STR: case SP_AGI: case SP_VIT: case SP_INT: case SP_DEX: case SP_LUK:
+		case SP_BASELEVEL: case SP_JOBLEVEL: case SP_CLASS: case SP_UPPER:
+		case SP_BASEJOB: case SP_BASECLASS: case SP_SEX:
+			return true;
+	}
+	return false;
+}
+
 /// Retrieves the value of a constant.
 bool script_get_constant(const char* name, int* value)
 {
@@ -2627,6 +2676,10 @@ void get_val(struct script_state* st, struct script_data* data)
 	prefix = name[0];
 	postfix = name[strlen(name) - 1];
 
+	if( script_purity_tracking && !reference_toconstant(data) && !(prefix == '.' && name[1] == '@') &&
+		!(reference_toparam(data) && script_param_ispure(reference_getparamtype(data))) )
+		script_purity_ok = false;
+
 	// @TODO: Use reference_tovariable(data) when it's confirmed that it works [FlavioJS]
 	if( !reference_toconstant(data) && not_server_variable(prefix) ) {
 		sd = script_rid2sd(st);
@@ -2767,6 +2820,9 @@ static int set_reg(struct script_state* st, TBL_PC* sd, int num, const char* nam
 {
 	char prefix = name[0];
 
+	if( script_purity_tracking && !(prefix == '.' && name[1] == '@') )
+		script_purity_ok = false;
+
 	if( is_string_variable(name) ) { // String variable
 		const char* str = (const char*)value;
 
@@ -3083,6 +3139,8 @@ void script_free_code(struct script_code* code)
 
 	script_free_vars(code->script_vars);
 	aFree(code->script_buf);
+	if( code->bonus )
+		aFree(code->bonus);
 	aFree(code);
 }
 
@@ -3518,6 +3576,9 @@ int run_func(struct script_state *st)
 	if( script_config.warn_func_mismatch_argtypes )
 		script_check_buildin_argtype(st, func);
 
+	if( script_purity_tracking && !str_data[func].pure )
+		script_purity_ok = false;
+
 	if(str_data[func].func) {
 		if (str_data[func].func(st)) //Report error
 			script_reportsrc(st);
@@ -3565,6 +3626,83 @@ int run_func(struct script_state *st)
 /*==========================================
  * script execution
  *------------------------------------------*/
+/// Compiles a script made only of bonus calls with constant arguments, like most item
+/// scripts, so run_script can apply them directly instead of running the VM.
+/// Skill names are left to the VM, the skill db is read after the item db.
+/// @return true if the script was compiled
+bool script_compile_bonus(struct script_code *code)
+{
+	struct script_bonus bonus[16];
+	int count = 0, pos = 0;
+
+	nullpo_retr(false, code);
+
+	for( ;; ) {
+		enum c_op c = get_com(code->script_buf, &pos);
+		int func, args[6], n = 0;
+
+		if( c == C_NOP )
+			break; // End of script
+		if( c == C_EOL )
+			continue;
+		if( c != C_NAME || count == ARRAYLENGTH(bonus) )
+			return false;
+		func = GETVALUE(code->script_buf, pos);
+		pos += 3;
+		if( str_data[func].type != C_FUNC || str_data[func].func != str_data[buildin_bonus_ref].func )
+			return false;
+		if( get_com(code->script_buf, &pos) != C_ARG )
+			return false;
+		while( (c = get_com(code->script_buf, &pos)) != C_FUNC ) {
+			int next;
+
+			if( c != C_INT || n == ARRAYLENGTH(args) )
+				return false; // Not a constant
+			args[n] = get_num(code->script_buf, &pos);
+			while( next = pos, get_com(code->script_buf, &next) == C_NEG ) { // Negative values
+				args[n] = -args[n];
+				pos = next;
+			}
+			n++;
+		}
+		if( n < 2 )
+			return false;
+		bonus[count].type = args[0];
+		bonus[count].count = n - 1;
+		memcpy(bonus[count].val, &args[1], (n - 1) * sizeof(int));
+		count++;
+	}
+
+	if( !count )
+		return false;
+	code->bonus = (struct script_bonus *)aMalloc(count * sizeof(struct script_bonus));
+	memcpy(code->bonus, bonus, count * sizeof(struct script_bonus));
+	code->bonus_count = count;
+	return true;
+}
+
+/// Applies the bonuses of a script compiled by script_compile_bonus, like buildin_bonus
+static void script_run_bonus(struct script_code *code, int rid)
+{
+	TBL_PC *sd = map_id2sd(rid);
+	int i;
+
+	if( sd == NULL )
+		return; // No player attached
+
+	for( i = 0; i < code->bonus_count; i++ ) {
+		struct script_bonus *b = &code->bonus[i];
+
+		switch( b->count ) {
+			case 1: pc_bonus(sd, b->type, b->val[0]); break;
+			case 2: pc_bonus2(sd, b->type, b->val[0], b->val[1]); break;
+			case 3: pc_bonus3(sd, b->type, b->val[0], b->val[1], b->val[2]); break;
+			case 4: pc_bonus4(sd, b->type, b->val[0], b->val[1], b->val[2], b->val[3]); break;
+			case 5: pc_bonus5(sd, b->type, b->val[0], b->val[1], b->val[2], b->val[3], b->val[4]); break;
+		}
+	}
+}
+
 void run_script(struct script_code *rootscript,int pos,int rid,int oid)
 {
 	struct script_state *st;
@@ -3572,6 +3710,11 @@ void run_script(struct script_code *rootscript,int pos,int rid,int oid)
 	if( rootscript == NULL || pos < 0 )
 		return;
 
+	if( rootscript->bonus && pos == 0 ) { // Only constant bonuses
+		script_run_bonus(rootscript, rid);
+		return;
+	}
+
 	// @TODO: In jAthena, this function can take over the pending script in the player [FlavioJS]
 	// It is unclear how that can be triggered, so it needs the be traced/checked in more detail
 	// NOTE At the time of this change, this function wasn't capable of taking over the script state because st->scriptroot was never set
@@ -7113,6 +7256,8 @@ BUILDIN_FUNC(readparam)
 	TBL_PC *sd;
 
 	type = script_getnum(st,2);
+	if( script_purity_tracking && (script_hasdata(st,3) || !script_param_ispure(type)) )
+		script_purity_ok = false;
 	if( script_hasdata(st,3) )
 		sd = map_nick2sd(script_getstr(st,3));
 	else
@@ -10212,13 +10357,8 @@ BUILDIN_FUNC(getstatus)
 		case 3:  script_pushint(st, sd->sc.data[id]->val3);	break;
 		case 4:  script_pushint(st, sd->sc.data[id]->val4);	break;
 		case 5:
-			{
-				struct TimerData* timer = (struct TimerData*)get_timer(sd->sc.data[id]->timer);
-
-				if( timer ) { //Return the amount of time remaining
-					script_pushint(st, timer->tick - gettick());
-				}
-			}
+			if( sd->sc.data[id]->timer != INVALID_TIMER ) //Return the amount of time remaining
+				script_pushint(st, sd->sc.data[id]->tick - gettick());
 			break;
 		default: script_pushint(st,1); break;
 	}
@@ -15758,6 +15898,7 @@ BUILDIN_FUNC(addmonsterdrop)
 		if( c ) { //Fill in the slot with the item and rate
 			mob->dropitem[c].nameid = item_id;
 			mob->dropitem[c].p = (rate > 10000) ? 10000 : rate;
+			mob_drop_build_db(mob);
 			script_pushint(st,1);
 		} else //No place to put the new drop
 			script_pushint(st,0);
@@ -15802,6 +15943,7 @@ BUILDIN_FUNC(delmonsterdrop)
 			if( mob->dropitem[i].nameid == item_id ) {
 				mob->dropitem[i].nameid = 0;
 				mob->dropitem[i].p = 0;
+				mob_drop_build_db(mob);
 				script_pushint(st,1);
 				return 0;
 			}
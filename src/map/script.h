@@ -96,14 +96,23 @@ struct script_data {
 	struct DBMap** ref;
 };
 
-// Moved defsp from script_state to script_stack since
-// it must be saved when script state is RERUNLINE. [Eoe / jA 1094]
+/// Bonus call with constant arguments (see script_compile_bonus)
+struct script_bonus {
+	int type;
+	int val[5];
+	uint8 count; // Number of values, selects pc_bonus to pc_bonus5
+};
+
 struct script_code {
 	int script_size;
 	unsigned char* script_buf;
 	struct DBMap* script_vars;
+	struct script_bonus* bonus; // Bonus calls the script is made of, run without the VM (NULL if none)
+	int bonus_count;
 };
 
+// Moved defsp from script_state to script_stack since
+// it must be saved when script state is RERUNLINE. [Eoe / jA 1094]
 struct script_stack {
 	int sp;// number of entries in the stack
 	int sp_max;// capacity of the stack
@@ -180,6 +189,9 @@ struct DBMap* script_get_userfunc_db(void);
 void script_run_autobonus(const char *autobonus, struct map_session_data *sd, unsigned int pos);
 
 bool script_get_constant(const char* name, int* value);
+bool script_compile_bonus(struct script_code *code);
+void script_purity_start(void);
+bool script_purity_end(void);
 void script_set_constant(const char* name, int value, bool isparameter);
 void script_hardcoded_constants(void);
 
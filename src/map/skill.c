@@ -2385,8 +2385,8 @@ void skill_combo(struct block_list* src, struct block_list *dsrc, struct block_l
 					sce->val1 = skill_id; //Update combo-skill
 					sce->val3 = skill_id;
 					if (sce->timer != INVALID_TIMER)
-						delete_timer(sce->timer, status_change_timer);
-					sce->timer = add_timer(tick + sce->val4, status_change_timer, src->id, SC_COMBO);
+						status_change_delete_timer(sce);
+					sce->timer = status_change_add_timer(src,SC_COMBO,tick + sce->val4);
 					break;
 				}
 				unit_cancel_combo(src); //Cancel combo wait
@@ -7277,9 +7277,7 @@ int skill_castend_nodamage_id(struct block_list *src, struct block_list *bl, uin
 						pc_bonus_script_clear(dstsd,BSF_REM_ON_DISPELL);
 					if( !tsc || !tsc->count )
 						break;
-					for( i = 0; i < SC_MAX; i++ ) {
-						if( !tsc->data[i] )
-							continue;
+					for( i = status_change_next(tsc, 0); i < SC_MAX; i = status_change_next(tsc, i + 1) ) {
 						switch( i ) {
 							case SC_WEIGHT50:		case SC_WEIGHT90:		case SC_HALLUCINATION:
 							case SC_STRIPWEAPON:		case SC_STRIPSHIELD:		case SC_STRIPARMOR:
@@ -8852,9 +8850,7 @@ int skill_castend_nodamage_id(struct block_list *src, struct block_list *bl, uin
 						pc_bonus_script_clear(dstsd,BSF_REM_ON_CLEARANCE);
 					if( !tsc || !tsc->count )
 						break;
-					for( i = 0; i < SC_MAX; i++ ) {
-						if( !tsc->data[i] )
-							continue;
+					for( i = status_change_next(tsc, 0); i < SC_MAX; i = status_change_next(tsc, i + 1) ) {
 						switch( i ) {
 							case SC_WEIGHT50:		case SC_WEIGHT90:		case SC_HALLUCINATION:
 							case SC_STRIPWEAPON:		case SC_STRIPSHIELD:		case SC_STRIPARMOR:
@@ -9021,9 +9017,7 @@ int skill_castend_nodamage_id(struct block_list *src, struct block_list *bl, uin
 			clif_skill_nodamage(src,bl,skill_id,skill_lv,sc_start(src,bl,type,100,skill_lv,skill_get_time(skill_id,skill_lv)));
 			if( !tsc || !tsc->count )
 				break;
-			for( i = 0; i < SC_MAX; i++) {
-				if( !tsc->data[i] )
-					continue;
+			for( i = status_change_next(tsc, 0); i < SC_MAX; i = status_change_next(tsc, i + 1) ) {
 				switch( i ) {
 					case SC_BLIND:		case SC_CURSE:
 					case SC_POISON:		case SC_HALLUCINATION:
@@ -10549,9 +10543,7 @@ int skill_castend_nodamage_id(struct block_list *src, struct block_list *bl, uin
 						pc_bonus_script_clear(dstsd,BSF_REM_ON_BANISHING_BUSTER);
 					if( !tsc || !tsc->count )
 						break;
-					for( i = 0; i < SC_MAX && n > 0; i++ ) {
-						if( !tsc->data[i] )
-							continue;
+					for( i = status_change_next(tsc, 0); i < SC_MAX && n > 0; i = status_change_next(tsc, i + 1) ) {
 						switch( i ) {
 							case SC_WEIGHT50:		case SC_WEIGHT90:		case SC_HALLUCINATION:
 							case SC_STRIPWEAPON:		case SC_STRIPSHIELD:		case SC_STRIPARMOR:
@@ -11076,9 +11068,9 @@ int skill_castend_id(int tid, unsigned int tick, int id, intptr_t data)
 				case CR_GRANDCROSS:
 				case NPC_GRANDDARKNESS:
 					if( (sc = status_get_sc(src)) && sc->data[SC_STRIPSHIELD] ) {
-						const struct TimerData *timer = get_timer(sc->data[SC_STRIPSHIELD]->timer);
+						const struct status_change_entry *sce = sc->data[SC_STRIPSHIELD];
 
-						if( timer && timer->func == status_change_timer && DIFF_TICK(timer->tick,gettick() + skill_get_time(ud->skill_id,ud->skill_lv)) > 0 )
+						if( sce->timer != INVALID_TIMER && DIFF_TICK(sce->tick,gettick() + skill_get_time(ud->skill_id,ud->skill_lv)) > 0 )
 							break;
 					}
 					sc_start2(src,src,SC_STRIPSHIELD,100,0,1,skill_get_time(ud->skill_id,ud->skill_lv));
@@ -12969,11 +12961,10 @@ static int skill_unit_onplace(struct skill_unit *unit, struct block_list *bl, un
 	switch( group->unit_id ) {
 		case UNT_SPIDERWEB:
 			if( battle_check_target(&group->unit->bl,bl,group->target_flag) > 0 ) {
-				const struct TimerData* td = (sce ? get_timer(sce->timer) : NULL);
 				int time = (bl->type == BL_PC ? skill_get_time(skill_id,skill_lv) / 2 : skill_get_time(skill_id,skill_lv));
 
-				if( td ) {
-					int sec = DIFF_TICK(td->tick,tick);
+				if( sce && sce->timer != INVALID_TIMER ) {
+					int sec = DIFF_TICK(sce->tick,tick);
 
 					time += sec;
 				}
@@ -13096,8 +13087,8 @@ static int skill_unit_onplace(struct skill_unit *unit, struct block_list *bl, un
 				sc_start4(src,bl,type,100,skill_lv,group->val1,group->val2,0,group->limit);
 			else if( battle_config.song_timer_reset && sce->val4 == 1 ) { //Readjust timers since the effect will not last long
 				sce->val4 = 0; //Remove the mark that we stepped out
-				delete_timer(sce->timer,status_change_timer);
-				sce->timer = add_timer(tick + group->limit,status_change_timer,bl->id,type); //Put duration 1 back
+				status_change_delete_timer(sce);
+				sce->timer = status_change_add_timer(bl,type,tick + group->limit); //Put duration 1 back
 			}
 			break;
 
@@ -13437,11 +13428,11 @@ static int skill_unit_onplace_timer(struct skill_unit *unit, struct block_list *
 				int sec = skill_get_time2(skill_id,skill_lv);
 
 				if (status_change_start(src,bl,type,10000,skill_lv,group->group_id,0,0,sec,SCFLAG_FIXEDRATE)) {
-					const struct TimerData* td = (tsc && tsc->data[type] ? get_timer(tsc->data[type]->timer) : NULL);
+					const struct status_change_entry *tsce = (tsc ? tsc->data[type] : NULL);
 					int range = skill_get_unit_range(skill_id,skill_lv);
 
-					if (td)
-						sec = DIFF_TICK(td->tick,tick);
+					if (tsce && tsce->timer != INVALID_TIMER)
+						sec = DIFF_TICK(tsce->tick,tick);
 					if (!unit_blown_immune(bl,0x3) ||
 						(group->unit_id == UNT_MANHOLE && distance_xy(unit->bl.x,unit->bl.y,bl->x,bl->y) <= range)) {
 						if (unit_movepos(bl,unit->bl.x,unit->bl.y,0,false))
@@ -14150,9 +14141,9 @@ int skill_unit_onleft(uint16 skill_id, struct block_list *bl, unsigned int tick)
 						type = status_skill2sc(i);
 						sce = (sc && type != SC_NONE) ? sc->data[type] : NULL;
 						if (sce && !sce->val4) { //We don't want dissonance updating this anymore
-							delete_timer(sce->timer, status_change_timer);
+							status_change_delete_timer(sce);
 							sce->val4 = 1; //Store the fact that this is a "reduced" duration effect
-							sce->timer = add_timer(tick + skill_get_time2(i, 1), status_change_timer, bl->id, type);
+							sce->timer = status_change_add_timer(bl,type,tick + skill_get_time2(i, 1));
 						}
 					}
 				}
@@ -14169,11 +14160,11 @@ int skill_unit_onleft(uint16 skill_id, struct block_list *bl, unsigned int tick)
 			if (sce) {
 				if (battle_config.song_timer_reset || //Athena-style
 					(!battle_config.song_timer_reset && sce->val4 != 1)) {
-					delete_timer(sce->timer, status_change_timer);
+					status_change_delete_timer(sce);
 					//NOTE: It'd be nice if we could get the skill_lv for a more accurate extra time, but still
 					//not possible on our current implementation
 					sce->val4 = 1;
-					sce->timer = add_timer(tick + skill_get_time2(skill_id, 1), status_change_timer, bl->id, type);
+					sce->timer = status_change_add_timer(bl,type,tick + skill_get_time2(skill_id, 1));
 				}
 			}
 			break;
@@ -14184,8 +14175,8 @@ int skill_unit_onleft(uint16 skill_id, struct block_list *bl, unsigned int tick)
 					if (bl->type == BL_PC) //Players get blind ended inmediately, others have it still for 30 secs [Skotlex]
 						status_change_end(bl, SC_BLIND, INVALID_TIMER);
 					else {
-						delete_timer(sce->timer, status_change_timer);
-						sce->timer = add_timer(30000 + tick, status_change_timer, bl->id, SC_BLIND);
+						status_change_delete_timer(sce);
+						sce->timer = status_change_add_timer(bl,SC_BLIND,30000 + tick);
 					}
 				}
 			}
@@ -53,6 +53,16 @@ enum e_regen {
 static int atkmods[3][MAX_WEAPON_TYPE];	/// ATK weapon modification for size (size_fix.txt)
 
 static struct eri *sc_data_ers; /// For sc_data entries
+static struct eri *sc_table_ers; /// For sc_data lookup tables
+
+/// Lookup table of a unit with at least one active status change
+struct sc_data_table {
+	struct status_change_entry *data[SC_MAX];
+};
+static struct status_change_entry *sc_empty_table[SC_MAX]; /// Shared by every unit without active status changes, never written
+static int sc_timer_serial = 0; /// Last handle given by status_change_add_timer
+static int status_change_unit_timer(int tid, unsigned int tick, int id, intptr_t data);
+static void status_heal_notify(struct block_list *bl, int hp, int sp, int flag);
 static struct status_data dummy_status;
 
 short current_equip_item_index; /// Contains inventory index of an equipped item. To pass it into the EQUP_SCRIPT [Lupus]
@@ -1604,6 +1614,7 @@ int status_damage(struct block_list *src, struct block_list *target, int64 in_hp
 //Heals a character
 //If flag&1, this is forced healing (otherwise, stuff like Berserk can block it)
 //If flag&2, when the player is healed, show the HP/SP heal effect
+//If flag&4, the client is not updated, the caller does it later through status_heal_notify
 int status_heal(struct block_list *bl, int64 in_hp, int64 in_sp, int flag)
 {
 	struct status_data *status;
@@ -1666,6 +1677,21 @@ int status_heal(struct block_list *bl, int64 in_hp, int64 in_sp, int flag)
 		status_change_end(bl, SC_PROVOKE, INVALID_TIMER);
 
 	//Send hp update to client
+	if (!(flag&4))
+		status_heal_notify(bl, hp, sp, flag);
+
+	return (int)(hp + sp);
+}
+
+/**
+ * Tells the client about a heal done by status_heal.
+ * @param bl: Object that was healed
+ * @param hp: HP healed
+ * @param sp: SP healed
+ * @param flag: Flag given to status_heal
+ */
+static void status_heal_notify(struct block_list *bl, int hp, int sp, int flag)
+{
 	switch (bl->type) {
 		case BL_PC:  pc_heal((TBL_PC*)bl, hp, sp, (flag&2 ? 1 : 0)); break;
 		case BL_MOB: mob_heal((TBL_MOB*)bl, hp); break;
@@ -1673,8 +1699,6 @@ int status_heal(struct block_list *bl, int64 in_hp, int64 in_sp, int flag)
 		case BL_MER: mercenary_heal((TBL_MER*)bl, hp, sp); break;
 		case BL_ELEM: elemental_heal((TBL_ELEM*)bl, hp, sp); break;
 	}
-
-	return (int)(hp + sp);
 }
 
 //Does percentual non-flinching damage/heal. If mob is killed this way,
@@ -3018,181 +3042,223 @@ static unsigned int status_calc_maxhpsp_pc(struct map_session_data* sd, bool isH
 	return (unsigned int)cap_value(max, 1, UINT_MAX);
 }
 
-//Calculates player data from scratch without counting SC adjustments.
-//Should be invoked whenever players raise stats, learn passive skills or change equipment.
-int status_calc_pc_(struct map_session_data* sd, enum e_status_calc_opt opt)
-{
-	static int calculating = 0; //Check for recursive call preemption [Skotlex]
-	struct status_data *status; //Pointer to the player's base status
-	const struct status_change *sc = &sd->sc;
-	struct s_skill b_skill[MAX_SKILL]; //Previous skill tree
-	int b_weight, b_max_weight, b_cart_weight_max, //Previous weight
-	i, skill, refinedef = 0;
-	short index = -1;
+static int calculating = 0; //Check for recursive call preemption of status_calc_pc [Skotlex]
 
-	if (++calculating > 10) //Too many recursive calls!
-		return -1;
+/*==========================================
+ * Equipment bonus cache
+ * The bonuses left by the equipment scripts (see status_calc_pc_equip) are kept for
+ * the last STATUS_CALC_CACHE_SIZE equipment sets of a player. They are used again as
+ * long as the items, stats, levels, class and map restrictions they came from are the
+ * same. Results are only cached when every script run for them was pure, that is only
+ * read what the key holds (see script_purity_start).
+ *------------------------------------------*/
+#define STATUS_CALC_CACHE_SIZE 2 //Two sets are enough for gear swaps
+
+/// What the bonuses of the equipment depend on
+struct s_status_calc_key {
+	short equip_index[EQI_MAX];
+	struct {
+		unsigned short nameid;
+		unsigned short card[MAX_SLOTS];
+		unsigned int equip;
+		char refine;
+		bool fame; //Forged by a famous blacksmith
+	} item[EQI_MAX];
+	int class_;
+	unsigned int mapid, base_level, job_level;
+	short param[6]; //str, agi, vit, int, dex, luk
+	unsigned char sex, size;
+	unsigned short speed;
+	uint32 noequip; //Map restrictions the items are checked against (see itemdb_isNoEquip)
+};
 
-	//Remember player-specific values that are currently being shown to the client (for refresh purposes)
-	memcpy(b_skill, &sd->status.skill, sizeof(b_skill));
-	b_weight = sd->weight;
-	b_max_weight = sd->max_weight;
-	b_cart_weight_max = sd->cart_weight_max;
+/// Parts of map_session_data written by status_calc_pc_equip
+static const struct {
+	size_t offset, size;
+} status_calc_cache_area[] = {
+	{ offsetof(struct map_session_data, right_weapon.overrefine), sizeof(struct weapon_data) - sizeof(((struct weapon_data*)0)->atkmods) },
+	{ offsetof(struct map_session_data, left_weapon.overrefine), sizeof(struct weapon_data) - sizeof(((struct weapon_data*)0)->atkmods) },
+	{ offsetof(struct map_session_data, param_bonus), offsetof(struct map_session_data, autobonus) - offsetof(struct map_session_data, param_bonus) }, //Zeroed arrays and structures
+	{ offsetof(struct map_session_data, bonus), sizeof(((struct map_session_data*)0)->bonus) },
+	{ offsetof(struct map_session_data, castrate), offsetof(struct map_session_data, itemid) - offsetof(struct map_session_data, castrate) }, //Rates
+	{ offsetof(struct map_session_data, special_state), sizeof(((struct map_session_data*)0)->special_state) },
+	{ offsetof(struct map_session_data, base_status.max_hp), sizeof(struct status_data) - offsetof(struct status_data, max_hp) },
+	{ offsetof(struct map_session_data, max_weight), sizeof(((struct map_session_data*)0)->max_weight) },
+};
 
-	pc_calc_skilltree(sd); //SkillTree calculation
+struct s_status_calc_cache {
+	struct s_status_calc_cache_entry {
+		struct s_status_calc_key key;
+		unsigned int version; //Of status_calc_cache_version when saved, 0 if unused
+		unsigned int tick; //Last use
+		short item_index; //current_equip_* globals left by the scripts
+		unsigned int combo_pos;
+		int card_id;
+		unsigned char regen_block;
+		uint8 *data; //Copy of status_calc_cache_area
+	} entry[STATUS_CALC_CACHE_SIZE];
+};
 
-	sd->max_weight = job_info[pc_class2idx(sd->status.class_)].max_weight_base + sd->status.str * 300;
+static unsigned int status_calc_cache_version = 1; //Bumped when the databases the bonuses come from are reloaded
+static size_t status_calc_cache_datasize = 0;
 
-	if (opt&SCO_FIRST) {
-		//Load Hp/SP from char-received data.
-		sd->battle_status.hp = sd->status.hp;
-		sd->battle_status.sp = sd->status.sp;
-		sd->regen.sregen = &sd->sregen;
-		sd->regen.ssregen = &sd->ssregen;
-		sd->weight = 0;
-		for (i = 0; i < MAX_INVENTORY; i++) {
-			if (sd->status.inventory[i].nameid == 0 || sd->inventory_data[i] == NULL)
-				continue;
-			sd->weight += sd->inventory_data[i]->weight * sd->status.inventory[i].amount;
-		}
-		sd->cart_weight = 0;
-		sd->cart_num = 0;
-		for (i = 0; i < MAX_CART; i++) {
-			if (sd->status.cart[i].nameid == 0)
-				continue;
-			sd->cart_weight += itemdb_weight(sd->status.cart[i].nameid) * sd->status.cart[i].amount;
-			sd->cart_num++;
-		}
-	}
+/// Drops the cached bonuses of every player, for database reloads
+void status_calc_cache_clear(void)
+{
+	if( ++status_calc_cache_version == 0 )
+		status_calc_cache_version = 1;
+}
 
-	status = &sd->base_status;
-	//These are not zeroed. [zzo]
-	sd->hprate = 100;
-	sd->sprate = 100;
-	sd->castrate = 100;
-	sd->delayrate = 100;
-	sd->dsprate = 100;
-	sd->hprecov_rate = 100;
-	sd->sprecov_rate = 100;
-	sd->matk_rate = 100;
-	sd->critical_rate = sd->hit_rate = sd->flee_rate = sd->flee2_rate = 100;
-	sd->def_rate = sd->def2_rate = sd->mdef_rate = sd->mdef2_rate = 100;
-	sd->regen.state.block = 0;
+void status_calc_cache_free(struct map_session_data *sd)
+{
+	int i;
 
-	//Zeroed arrays, order follows the order in pc.h
-	//Add new arrays to the end of zeroed area in pc.h (see comments) and size here [zzo]
-	memset(sd->param_bonus, 0, sizeof(sd->param_bonus)
-		+ sizeof(sd->param_equip)
-		+ sizeof(sd->subele)
-		+ sizeof(sd->subrace)
-		+ sizeof(sd->subrace2)
-		+ sizeof(sd->subclass)
-		+ sizeof(sd->subsize)
-		+ sizeof(sd->reseff)
-		+ sizeof(sd->weapon_coma_ele)
-		+ sizeof(sd->weapon_coma_race)
-		+ sizeof(sd->weapon_coma_class)
-		+ sizeof(sd->weapon_atk)
-		+ sizeof(sd->weapon_atk_rate)
-		+ sizeof(sd->arrow_addele)
-		+ sizeof(sd->arrow_addrace)
-		+ sizeof(sd->arrow_addclass)
-		+ sizeof(sd->arrow_addsize)
-		+ sizeof(sd->magic_addele)
-		+ sizeof(sd->magic_addrace)
-		+ sizeof(sd->magic_addclass)
-		+ sizeof(sd->magic_addsize)
-		+ sizeof(sd->magic_atk_ele)
-		+ sizeof(sd->critaddrace)
-		+ sizeof(sd->expaddrace)
-		+ sizeof(sd->expaddclass)
-		+ sizeof(sd->ignore_mdef_by_race)
-		+ sizeof(sd->ignore_mdef_by_class)
-		+ sizeof(sd->ignore_def_by_race)
-		+ sizeof(sd->ignore_def_by_class)
-		+ sizeof(sd->magic_subrace)
-		+ sizeof(sd->sp_gain_race)
-		+ sizeof(sd->sp_gain_race_attack)
-		+ sizeof(sd->hp_gain_race_attack)
-		);
+	if( !sd->calc_cache )
+		return;
+	for( i = 0; i < STATUS_CALC_CACHE_SIZE; i++ ) {
+		if( sd->calc_cache->entry[i].data )
+			aFree(sd->calc_cache->entry[i].data);
+	}
+	aFree(sd->calc_cache);
+	sd->calc_cache = NULL;
+}
 
-	memset(&sd->right_weapon.overrefine, 0, sizeof(sd->right_weapon) - sizeof(sd->right_weapon.atkmods));
-	memset(&sd->left_weapon.overrefine, 0, sizeof(sd->left_weapon) - sizeof(sd->left_weapon.atkmods));
+static void status_calc_cache_key(struct map_session_data *sd, struct s_status_calc_key *key)
+{
+	int i, m = sd->bl.m;
 
-	if (sd->special_state.intravision && !sc->data[SC_INTRAVISION]) //Clear intravision as long as nothing else is using it
-		clif_status_load(&sd->bl, SI_INTRAVISION, 0);
+	memset(key, 0, sizeof(*key));
+	memcpy(key->equip_index, sd->equip_index, sizeof(key->equip_index));
+	for( i = 0; i < EQI_MAX; i++ ) {
+		struct item *it;
 
-	memset(&sd->special_state, 0, sizeof(sd->special_state));
+		if( sd->equip_index[i] < 0 )
+			continue;
+		it = &sd->status.inventory[sd->equip_index[i]];
+		key->item[i].nameid = it->nameid;
+		memcpy(key->item[i].card, it->card, sizeof(key->item[i].card));
+		key->item[i].equip = it->equip;
+		key->item[i].refine = it->refine;
+		key->item[i].fame = (it->card[0] == CARD0_FORGE && pc_famerank(MakeDWord(it->card[2],it->card[3]),MAPID_BLACKSMITH));
+	}
+	key->class_ = sd->status.class_;
+	key->mapid = sd->class_;
+	key->base_level = sd->status.base_level;
+	key->job_level = sd->status.job_level;
+	key->param[0] = sd->status.str;
+	key->param[1] = sd->status.agi;
+	key->param[2] = sd->status.vit;
+	key->param[3] = sd->status.int_;
+	key->param[4] = sd->status.dex;
+	key->param[5] = sd->status.luk;
+	key->sex = sd->status.sex;
+	key->size = sd->base_status.size;
+	key->speed = sd->base_status.speed;
+	if( pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) )
+		key->noequip = UINT32_MAX;
+	else
+		key->noequip = (!map_flag_vs(m) ? 1 : 0)|(map[m].flag.pvp ? 2 : 0)|(map_flag_gvg2(m) ? 4 : 0)|(map[m].flag.battleground ? 8 : 0)|
+			(map[m].flag.restricted ? map[m].zone<<4 : 0);
+}
 
-	if (!sd->state.permanent_speed) {
-		memset(&status->max_hp, 0, sizeof(struct status_data) - (sizeof(status->hp) + sizeof(status->sp)));
-		status->speed = DEFAULT_WALK_SPEED;
-	} else {
-		int pSpeed = status->speed;
+static struct s_status_calc_cache_entry *status_calc_cache_find(struct map_session_data *sd, struct s_status_calc_key *key)
+{
+	int i;
 
-		memset(&status->max_hp, 0, sizeof(struct status_data) - (sizeof(status->hp) + sizeof(status->sp)));
-		status->speed = pSpeed;
+	if( !sd->calc_cache )
+		return NULL;
+	for( i = 0; i < STATUS_CALC_CACHE_SIZE; i++ ) {
+		struct s_status_calc_cache_entry *entry = &sd->calc_cache->entry[i];
+
+		if( entry->version == status_calc_cache_version && !memcmp(&entry->key, key, sizeof(*key)) )
+			return entry;
 	}
+	return NULL;
+}
 
-	//FIXME: Most of these stuff should be calculated once, but how do I fix the memset above to do that? [Skotlex]
-	//Give them all modes except these (useful for clones)
-	status->mode = (enum e_mode)(MD_MASK&~(MD_BOSS|MD_PLANT|MD_DETECTOR|MD_ANGRY|MD_TARGETWEAK));
+/// Restores the bonuses of the current equipment set instead of running status_calc_pc_equip
+/// @param key: Filled with the key of the set, for status_calc_cache_save
+/// @return true if they were cached, false if status_calc_pc_equip has to run
+static bool status_calc_cache_load(struct map_session_data *sd, struct s_status_calc_key *key)
+{
+	struct s_status_calc_cache_entry *entry;
+	uint8 *p;
+	int i;
 
-	status->size = (sd->class_&JOBL_BABY) ? SZ_SMALL : SZ_MEDIUM;
-	if (battle_config.character_size && (pc_isriding(sd) || pc_isridingdragon(sd))) { //[Lupus]
-		if (sd->class_&JOBL_BABY) {
-			if (battle_config.character_size&SZ_BIG)
-				status->size++;
-		} else if (battle_config.character_size&SZ_MEDIUM)
-			status->size++;
-	}
-	status->aspd_rate = 1000;
-	status->ele_lv = 1;
-	status->race = RC_DEMIHUMAN;
-	status->class_ = CLASS_NORMAL;
+	status_calc_cache_key(sd, key);
+	if( battle_config.status_calc_cache == 2 ) //Verification mode, always do the full calculation
+		return false;
+	if( !(entry = status_calc_cache_find(sd, key)) )
+		return false;
 
-	//Zero up structures
-	memset(&sd->autospell,0,sizeof(sd->autospell)
-		+ sizeof(sd->autospell2)
-		+ sizeof(sd->autospell3)
-		+ sizeof(sd->addeff)
-		+ sizeof(sd->addeff2)
-		+ sizeof(sd->addeff3)
-		+ sizeof(sd->skillatk)
-		+ sizeof(sd->skillusesprate)
-		+ sizeof(sd->skillusesp)
-		+ sizeof(sd->skillheal)
-		+ sizeof(sd->skillheal2)
-		+ sizeof(sd->hp_loss)
-		+ sizeof(sd->sp_loss)
-		+ sizeof(sd->hp_regen)
-		+ sizeof(sd->sp_regen)
-		+ sizeof(sd->skillblown)
-		+ sizeof(sd->skillcast)
-		+ sizeof(sd->add_def)
-		+ sizeof(sd->add_mdef)
-		+ sizeof(sd->add_mdmg)
-		+ sizeof(sd->add_drop)
-		+ sizeof(sd->itemhealrate)
-		+ sizeof(sd->subele2)
-		+ sizeof(sd->cooldown)
-		+ sizeof(sd->skillfixcast)
-		+ sizeof(sd->skillvarcast)
-		+ sizeof(sd->skillfixcastrate)
-		+ sizeof(sd->def_set_race)
-		+ sizeof(sd->mdef_set_race)
-	);
+	for( i = 0, p = entry->data; i < ARRAYLENGTH(status_calc_cache_area); p += status_calc_cache_area[i].size, i++ )
+		memcpy((uint8*)sd + status_calc_cache_area[i].offset, p, status_calc_cache_area[i].size);
+	sd->regen.state.block = entry->regen_block;
+	current_equip_item_index = entry->item_index;
+	current_equip_combo_pos = entry->combo_pos;
+	current_equip_card_id = entry->card_id;
+	entry->tick = gettick();
+	if( sd->special_state.intravision ) //Sent by pc_bonus otherwise
+		clif_status_load(&sd->bl, SI_INTRAVISION, 1);
+	return true;
+}
 
-	memset(&sd->bonus, 0, sizeof(sd->bonus));
+/// Saves the bonuses status_calc_pc_equip just added for the equipment set of key
+/// In verification mode, they are first compared with the ones cached for that set.
+static void status_calc_cache_save(struct map_session_data *sd, struct s_status_calc_key *key)
+{
+	struct s_status_calc_cache_entry *entry;
+	uint8 *p;
+	int i;
 
-	//Autobonus
-	pc_delautobonus(sd, sd->autobonus, ARRAYLENGTH(sd->autobonus), true);
-	pc_delautobonus(sd, sd->autobonus2, ARRAYLENGTH(sd->autobonus2), true);
-	pc_delautobonus(sd, sd->autobonus3, ARRAYLENGTH(sd->autobonus3), true);
+	if( sd->itemgrouphealrate_count ) //Kept in a list of its own
+		return;
 
-	pc_itemgrouphealrate_clear(sd);
+	if( !status_calc_cache_datasize ) {
+		for( i = 0; i < ARRAYLENGTH(status_calc_cache_area); i++ )
+			status_calc_cache_datasize += status_calc_cache_area[i].size;
+	}
+	if( !sd->calc_cache )
+		CREATE(sd->calc_cache, struct s_status_calc_cache, 1);
+
+	if( (entry = status_calc_cache_find(sd, key)) != NULL ) {
+		if( battle_config.status_calc_cache == 2 ) {
+			bool differ = (entry->regen_block != sd->regen.state.block);
 
-	npc_script_event(sd, NPCE_STATCALC);
+			for( i = 0, p = entry->data; i < ARRAYLENGTH(status_calc_cache_area) && !differ; p += status_calc_cache_area[i].size, i++ )
+				differ = (memcmp((uint8*)sd + status_calc_cache_area[i].offset, p, status_calc_cache_area[i].size) != 0);
+			if( differ )
+				ShowWarning("status_calc_cache_save: Cached equipment bonuses of '%s' (char_id: %d) differ from a full calculation.\n", sd->status.name, sd->status.char_id);
+		}
+	} else { //Replace the least recently used set
+		entry = &sd->calc_cache->entry[0];
+		for( i = 1; i < STATUS_CALC_CACHE_SIZE; i++ ) {
+			if( DIFF_TICK(sd->calc_cache->entry[i].tick, entry->tick) < 0 || !sd->calc_cache->entry[i].version )
+				entry = &sd->calc_cache->entry[i];
+		}
+		if( !entry->data )
+			entry->data = (uint8*)aMalloc(status_calc_cache_datasize);
+	}
+
+	memcpy(&entry->key, key, sizeof(*key));
+	for( i = 0, p = entry->data; i < ARRAYLENGTH(status_calc_cache_area); p += status_calc_cache_area[i].size, i++ )
+		memcpy(p, (uint8*)sd + status_calc_cache_area[i].offset, status_calc_cache_area[i].size);
+	entry->regen_block = sd->regen.state.block;
+	entry->item_index = current_equip_item_index;
+	entry->combo_pos = current_equip_combo_pos;
+	entry->card_id = current_equip_card_id;
+	entry->version = status_calc_cache_version;
+	entry->tick = gettick();
+}
+
+/// Runs the scripts of the equipment, ammo, combos and cards of a player and adds their bonuses.
+/// Part of status_calc_pc, the bonuses are expected to be cleared.
+/// @return 1 if a script recalculated the status itself, in which case status_calc_pc stops here
+static int status_calc_pc_equip(struct map_session_data *sd, enum e_status_calc_opt opt)
+{
+	struct status_data *status = &sd->base_status;
+	int i, refinedef = 0;
+	short index = -1;
 
 	//Parse equipment
 	for(i = 0; i < EQI_MAX; i++) {
@@ -3332,60 +3398,257 @@ int status_calc_pc_(struct map_session_data* sd, enum e_status_calc_opt opt)
 		}
 	}
 
-	//Store equipment script bonuses
-	memcpy(sd->param_equip,sd->param_bonus,sizeof(sd->param_equip));
-	memset(sd->param_bonus,0,sizeof(sd->param_bonus));
+	//Store equipment script bonuses
+	memcpy(sd->param_equip,sd->param_bonus,sizeof(sd->param_equip));
+	memset(sd->param_bonus,0,sizeof(sd->param_bonus));
+
+	status->def += (refinedef + 50) / 100;
+
+	//Parse Cards
+	for(i = 0; i < EQI_MAX; i++) {
+		//We pass INDEX to current_equip_item_index - for EQUIP_SCRIPT (new cards solution) [Lupus]
+		current_equip_item_index = index = sd->equip_index[i];
+		current_equip_combo_pos = 0;
+		if(index < 0)
+			continue;
+		if(i == EQI_AMMO)
+			continue;
+		if(pc_is_same_equip_index((enum equip_index)i, sd->equip_index, index))
+			continue;
+		if(sd->inventory_data[index]) {
+			int j;
+			struct item_data *data;
+
+			//Card script execution
+			if(itemdb_isspecial(sd->status.inventory[index].card[0]))
+				continue;
+			for(j = 0; j < MAX_SLOTS; j++) { //Uses MAX_SLOTS to support Soul Bound system [Inkfish]
+				int c = sd->status.inventory[index].card[j];
+
+				current_equip_card_id = c;
+				if(!c)
+					continue;
+				data = itemdb_exists(c);
+				if(!data)
+					continue;
+				if((opt&SCO_FIRST) && data->equip_script && (pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) ||
+					!itemdb_isNoEquip(data,sd->bl.m))) { //Execute equip-script on login
+					run_script(data->equip_script,0,sd->bl.id,0);
+					if(!calculating)
+						return 1;
+				}
+				if(!data->script)
+					continue;
+				if(!pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) && itemdb_isNoEquip(data,sd->bl.m)) //Card restriction checks
+					continue;
+				if(i == EQI_HAND_L && sd->status.inventory[index].equip == EQP_HAND_L) { //Left hand status
+					sd->state.lr_flag = 1;
+					run_script(data->script,0,sd->bl.id,0);
+					sd->state.lr_flag = 0;
+				} else
+					run_script(data->script,0,sd->bl.id,0);
+				if(!calculating) //Abort, run_script his function [Skotlex]
+					return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+//Calculates player data from scratch without counting SC adjustments.
+//Should be invoked whenever players raise stats, learn passive skills or change equipment.
+int status_calc_pc_(struct map_session_data* sd, enum e_status_calc_opt opt)
+{
+	struct status_data *status; //Pointer to the player's base status
+	const struct status_change *sc = &sd->sc;
+	struct s_skill b_skill[MAX_SKILL]; //Previous skill tree
+	int b_weight, b_max_weight, b_cart_weight_max, //Previous weight
+	i, skill, statcalc_events;
+	short index = -1;
+
+	if (++calculating > 10) //Too many recursive calls!
+		return -1;
+
+	sd->cardfix_cache.count = 0; //Card bonuses are about to change
+
+	//Remember player-specific values that are currently being shown to the client (for refresh purposes)
+	memcpy(b_skill, &sd->status.skill, sizeof(b_skill));
+	b_weight = sd->weight;
+	b_max_weight = sd->max_weight;
+	b_cart_weight_max = sd->cart_weight_max;
+
+	pc_calc_skilltree(sd); //SkillTree calculation
+
+	sd->max_weight = job_info[pc_class2idx(sd->status.class_)].max_weight_base + sd->status.str * 300;
+
+	if (opt&SCO_FIRST) {
+		//Load Hp/SP from char-received data.
+		sd->battle_status.hp = sd->status.hp;
+		sd->battle_status.sp = sd->status.sp;
+		sd->regen.sregen = &sd->sregen;
+		sd->regen.ssregen = &sd->ssregen;
+		sd->weight = 0;
+		for (i = 0; i < MAX_INVENTORY; i++) {
+			if (sd->status.inventory[i].nameid == 0 || sd->inventory_data[i] == NULL)
+				continue;
+			sd->weight += sd->inventory_data[i]->weight * sd->status.inventory[i].amount;
+		}
+		sd->cart_weight = 0;
+		sd->cart_num = 0;
+		for (i = 0; i < MAX_CART; i++) {
+			if (sd->status.cart[i].nameid == 0)
+				continue;
+			sd->cart_weight += itemdb_weight(sd->status.cart[i].nameid) * sd->status.cart[i].amount;
+			sd->cart_num++;
+		}
+	}
+
+	status = &sd->base_status;
+	//These are not zeroed. [zzo]
+	sd->hprate = 100;
+	sd->sprate = 100;
+	sd->castrate = 100;
+	sd->delayrate = 100;
+	sd->dsprate = 100;
+	sd->hprecov_rate = 100;
+	sd->sprecov_rate = 100;
+	sd->matk_rate = 100;
+	sd->critical_rate = sd->hit_rate = sd->flee_rate = sd->flee2_rate = 100;
+	sd->def_rate = sd->def2_rate = sd->mdef_rate = sd->mdef2_rate = 100;
+	sd->regen.state.block = 0;
+
+	//Zeroed arrays, order follows the order in pc.h
+	//Add new arrays to the end of zeroed area in pc.h (see comments) and size here [zzo]
+	memset(sd->param_bonus, 0, sizeof(sd->param_bonus)
+		+ sizeof(sd->param_equip)
+		+ sizeof(sd->subele)
+		+ sizeof(sd->subrace)
+		+ sizeof(sd->subrace2)
+		+ sizeof(sd->subclass)
+		+ sizeof(sd->subsize)
+		+ sizeof(sd->reseff)
+		+ sizeof(sd->weapon_coma_ele)
+		+ sizeof(sd->weapon_coma_race)
+		+ sizeof(sd->weapon_coma_class)
+		+ sizeof(sd->weapon_atk)
+		+ sizeof(sd->weapon_atk_rate)
+		+ sizeof(sd->arrow_addele)
+		+ sizeof(sd->arrow_addrace)
+		+ sizeof(sd->arrow_addclass)
+		+ sizeof(sd->arrow_addsize)
+		+ sizeof(sd->magic_addele)
+		+ sizeof(sd->magic_addrace)
+		+ sizeof(sd->magic_addclass)
+		+ sizeof(sd->magic_addsize)
+		+ sizeof(sd->magic_atk_ele)
+		+ sizeof(sd->critaddrace)
+		+ sizeof(sd->expaddrace)
+		+ sizeof(sd->expaddclass)
+		+ sizeof(sd->ignore_mdef_by_race)
+		+ sizeof(sd->ignore_mdef_by_class)
+		+ sizeof(sd->ignore_def_by_race)
+		+ sizeof(sd->ignore_def_by_class)
+		+ sizeof(sd->magic_subrace)
+		+ sizeof(sd->magic_subclass)
+		+ sizeof(sd->sp_gain_race)
+		+ sizeof(sd->sp_gain_race_attack)
+		+ sizeof(sd->hp_gain_race_attack)
+		);
+
+	memset(&sd->right_weapon.overrefine, 0, sizeof(sd->right_weapon) - sizeof(sd->right_weapon.atkmods));
+	memset(&sd->left_weapon.overrefine, 0, sizeof(sd->left_weapon) - sizeof(sd->left_weapon.atkmods));
+
+	if (sd->special_state.intravision && !sc->data[SC_INTRAVISION]) //Clear intravision as long as nothing else is using it
+		clif_status_load(&sd->bl, SI_INTRAVISION, 0);
+
+	memset(&sd->special_state, 0, sizeof(sd->special_state));
+
+	if (!sd->state.permanent_speed) {
+		memset(&status->max_hp, 0, sizeof(struct status_data) - (sizeof(status->hp) + sizeof(status->sp)));
+		status->speed = DEFAULT_WALK_SPEED;
+	} else {
+		int pSpeed = status->speed;
+
+		memset(&status->max_hp, 0, sizeof(struct status_data) - (sizeof(status->hp) + sizeof(status->sp)));
+		status->speed = pSpeed;
+	}
+
+	//FIXME: Most of these stuff should be calculated once, but how do I fix the memset above to do that? [Skotlex]
+	//Give them all modes except these (useful for clones)
+	status->mode = (enum e_mode)(MD_MASK&~(MD_BOSS|MD_PLANT|MD_DETECTOR|MD_ANGRY|MD_TARGETWEAK));
+
+	status->size = (sd->class_&JOBL_BABY) ? SZ_SMALL : SZ_MEDIUM;
+	if (battle_config.character_size && (pc_isriding(sd) || pc_isridingdragon(sd))) { //[Lupus]
+		if (sd->class_&JOBL_BABY) {
+			if (battle_config.character_size&SZ_BIG)
+				status->size++;
+		} else if (battle_config.character_size&SZ_MEDIUM)
+			status->size++;
+	}
+	status->aspd_rate = 1000;
+	status->ele_lv = 1;
+	status->race = RC_DEMIHUMAN;
+	status->class_ = CLASS_NORMAL;
+
+	//Zero up structures
+	memset(&sd->autospell,0,sizeof(sd->autospell)
+		+ sizeof(sd->autospell2)
+		+ sizeof(sd->autospell3)
+		+ sizeof(sd->addeff)
+		+ sizeof(sd->addeff2)
+		+ sizeof(sd->addeff3)
+		+ sizeof(sd->skillatk)
+		+ sizeof(sd->skillusesprate)
+		+ sizeof(sd->skillusesp)
+		+ sizeof(sd->skillheal)
+		+ sizeof(sd->skillheal2)
+		+ sizeof(sd->hp_loss)
+		+ sizeof(sd->sp_loss)
+		+ sizeof(sd->hp_regen)
+		+ sizeof(sd->sp_regen)
+		+ sizeof(sd->skillblown)
+		+ sizeof(sd->skillcast)
+		+ sizeof(sd->add_def)
+		+ sizeof(sd->add_mdef)
+		+ sizeof(sd->add_mdmg)
+		+ sizeof(sd->add_drop)
+		+ sizeof(sd->itemhealrate)
+		+ sizeof(sd->subele2)
+		+ sizeof(sd->cooldown)
+		+ sizeof(sd->skillfixcast)
+		+ sizeof(sd->skillvarcast)
+		+ sizeof(sd->skillfixcastrate)
+		+ sizeof(sd->def_set_race)
+		+ sizeof(sd->mdef_set_race)
+	);
 
-	status->def += (refinedef + 50) / 100;
+	memset(&sd->bonus, 0, sizeof(sd->bonus));
 
-	//Parse Cards
-	for(i = 0; i < EQI_MAX; i++) {
-		//We pass INDEX to current_equip_item_index - for EQUIP_SCRIPT (new cards solution) [Lupus]
-		current_equip_item_index = index = sd->equip_index[i];
-		current_equip_combo_pos = 0;
-		if(index < 0)
-			continue;
-		if(i == EQI_AMMO)
-			continue;
-		if(pc_is_same_equip_index((enum equip_index)i, sd->equip_index, index))
-			continue;
-		if(sd->inventory_data[index]) {
-			int j;
-			struct item_data *data;
+	//Autobonus
+	pc_delautobonus(sd, sd->autobonus, ARRAYLENGTH(sd->autobonus), true);
+	pc_delautobonus(sd, sd->autobonus2, ARRAYLENGTH(sd->autobonus2), true);
+	pc_delautobonus(sd, sd->autobonus3, ARRAYLENGTH(sd->autobonus3), true);
 
-			//Card script execution
-			if(itemdb_isspecial(sd->status.inventory[index].card[0]))
-				continue;
-			for(j = 0; j < MAX_SLOTS; j++) { //Uses MAX_SLOTS to support Soul Bound system [Inkfish]
-				int c = sd->status.inventory[index].card[j];
+	pc_itemgrouphealrate_clear(sd);
 
-				current_equip_card_id = c;
-				if(!c)
-					continue;
-				data = itemdb_exists(c);
-				if(!data)
-					continue;
-				if((opt&SCO_FIRST) && data->equip_script && (pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) ||
-					!itemdb_isNoEquip(data,sd->bl.m))) { //Execute equip-script on login
-					run_script(data->equip_script,0,sd->bl.id,0);
-					if(!calculating)
-						return 1;
-				}
-				if(!data->script)
-					continue;
-				if(!pc_has_permission(sd,PC_PERM_USE_ALL_EQUIPMENT) && itemdb_isNoEquip(data,sd->bl.m)) //Card restriction checks
-					continue;
-				if(i == EQI_HAND_L && sd->status.inventory[index].equip == EQP_HAND_L) { //Left hand status
-					sd->state.lr_flag = 1;
-					run_script(data->script,0,sd->bl.id,0);
-					sd->state.lr_flag = 0;
-				} else
-					run_script(data->script,0,sd->bl.id,0);
-				if(!calculating) //Abort, run_script his function [Skotlex]
-					return 1;
+	statcalc_events = npc_script_event(sd, NPCE_STATCALC);
+
+	//Equipment, ammo, combo and card bonuses, from the cache when allowed (see status_calc_cache_load)
+	if(battle_config.status_calc_cache && !(opt&SCO_FIRST) && !statcalc_events) {
+		struct s_status_calc_key key;
+
+		if(!status_calc_cache_load(sd, &key)) {
+			script_purity_start();
+			if(status_calc_pc_equip(sd, opt)) {
+				script_purity_end();
+				return 1;
 			}
+			if(script_purity_end())
+				status_calc_cache_save(sd, &key);
 		}
-	}
+	} else if(status_calc_pc_equip(sd, opt))
+		return 1;
 
 	if(sc->count && sc->data[SC_ITEMSCRIPT]) {
 		struct item_data *data = itemdb_exists(sc->data[SC_ITEMSCRIPT]->val1);
@@ -4295,7 +4558,88 @@ void status_calc_state(struct block_list *bl, struct status_change *sc, enum scs
 	return;
 }
 
+/// Stats of the battle status that are computed from a primary stat, in the order of status_calc_bl_main
+static const struct {
+	int flag; ///< Primary stat
+	int bl_type; ///< Objects for which the dependency exists
+	int deps; ///< Stats that have to be recalculated when the primary stat changes
+} status_calc_dependency[] = {
+	{ SCB_STR, BL_ALL, SCB_BATK },
+	{ SCB_STR, BL_HOM, SCB_WATK },
+#ifdef RENEWAL
+	{ SCB_AGI, BL_ALL, SCB_FLEE|SCB_DEF2 },
+#else
+	{ SCB_AGI, BL_ALL, SCB_FLEE },
+#endif
+	{ SCB_AGI, BL_PC|BL_HOM, SCB_ASPD|SCB_DSPD },
+	{ SCB_VIT, BL_ALL, SCB_DEF2|SCB_MDEF2 },
+	{ SCB_VIT, BL_PC|BL_HOM|BL_MER|BL_ELEM, SCB_MAXHP },
+	{ SCB_VIT, BL_HOM, SCB_DEF },
+	{ SCB_INT, BL_ALL, SCB_MATK|SCB_MDEF2 },
+	{ SCB_INT, BL_PC|BL_HOM|BL_MER|BL_ELEM, SCB_MAXSP },
+	{ SCB_INT, BL_HOM, SCB_MDEF },
+#ifdef RENEWAL
+	{ SCB_DEX, BL_ALL, SCB_BATK|SCB_HIT|SCB_MATK|SCB_MDEF2 },
+#else
+	{ SCB_DEX, BL_ALL, SCB_BATK|SCB_HIT },
+#endif
+	{ SCB_DEX, BL_PC|BL_HOM, SCB_ASPD },
+	{ SCB_DEX, BL_HOM, SCB_WATK },
+#ifdef RENEWAL
+	{ SCB_LUK, BL_ALL, SCB_BATK|SCB_CRI|SCB_FLEE2|SCB_MATK|SCB_HIT|SCB_FLEE },
+#else
+	{ SCB_LUK, BL_ALL, SCB_BATK|SCB_CRI|SCB_FLEE2 },
+#endif
+};
+
+/// Recalculation counters, see status_calc_stats
+static struct {
+	uint64 calls; ///< Runs of status_calc_bl_main
+	uint64 stats; ///< Stats recalculated
+	uint64 skipped; ///< Dependent stats left alone because the primary stat didn't change
+	unsigned int tick; ///< When counting started
+} status_calc_counter;
+
+/// Adds the stats that depend on a recalculated primary stat to flag.
+/// They are only needed when its value changed, or when the base status was recalculated too.
+static int status_calc_depend(struct block_list *bl, int flag, int stat, bool changed)
+{
+	int i, deps = 0;
+
+	for( i = 0; i < ARRAYLENGTH(status_calc_dependency); i++ ) {
+		if( status_calc_dependency[i].flag == stat && bl->type&status_calc_dependency[i].bl_type )
+			deps |= status_calc_dependency[i].deps;
+	}
+	if( changed || flag&SCB_BASE )
+		return flag|deps;
+	deps &= ~flag;
+	for( ; deps; deps &= deps - 1 )
+		status_calc_counter.skipped++;
+	return flag;
+}
+
+/// Reports the recalculation counters
+/// @param calls Runs of status_calc_bl_main
+/// @param stats Stats recalculated
+/// @param skipped Stats skipped thanks to the dependency table
+/// @param tick When counting started
+void status_calc_stats(uint64 *calls, uint64 *stats, uint64 *skipped, unsigned int *tick)
+{
+	*calls = status_calc_counter.calls;
+	*stats = status_calc_counter.stats;
+	*skipped = status_calc_counter.skipped;
+	*tick = status_calc_counter.tick;
+}
+
+/// Restarts the recalculation counters
+void status_calc_stats_reset(void)
+{
+	memset(&status_calc_counter, 0, sizeof(status_calc_counter));
+	status_calc_counter.tick = gettick();
+}
+
 /// Recalculates parts of an object's battle status according to the specified flags.
+/// Stats computed from STR/AGI/VIT/INT/DEX/LUK are only added when that stat actually changed (see status_calc_dependency).
 /// @param flag bitfield of values from enum scb_flag
 void status_calc_bl_main(struct block_list *bl, /*enum scb_flag*/int flag)
 {
@@ -4308,6 +4652,8 @@ void status_calc_bl_main(struct block_list *bl, /*enum scb_flag*/int flag)
 	if( !b_status || !status )
 		return;
 
+	status_calc_counter.calls++;
+
 	//This needs to be done even if there is currently no status change active, because
 	//we need to update the speed on the client when the last status change ends [Playtester]
 	if( flag&SCB_SPEED ) {
@@ -4329,61 +4675,39 @@ void status_calc_bl_main(struct block_list *bl, /*enum scb_flag*/int flag)
 	}
 
 	if( flag&SCB_STR ) {
+		temp = status->str;
 		status->str = status_calc_str(bl, sc, b_status->str);
-		flag |= SCB_BATK;
-		if( bl->type&BL_HOM )
-			flag |= SCB_WATK;
+		flag = status_calc_depend(bl, flag, SCB_STR, status->str != temp);
 	}
 
 	if( flag&SCB_AGI ) {
+		temp = status->agi;
 		status->agi = status_calc_agi(bl, sc, b_status->agi);
-		flag |= SCB_FLEE
-#ifdef RENEWAL
-			|SCB_DEF2
-#endif
-			;
-		if( bl->type&(BL_PC|BL_HOM) )
-			flag |= SCB_ASPD|SCB_DSPD;
+		flag = status_calc_depend(bl, flag, SCB_AGI, status->agi != temp);
 	}
 
 	if( flag&SCB_VIT ) {
+		temp = status->vit;
 		status->vit = status_calc_vit(bl, sc, b_status->vit);
-		flag |= SCB_DEF2|SCB_MDEF2;
-		if( bl->type&(BL_PC|BL_HOM|BL_MER|BL_ELEM) )
-			flag |= SCB_MAXHP;
-		if( bl->type&BL_HOM )
-			flag |= SCB_DEF;
+		flag = status_calc_depend(bl, flag, SCB_VIT, status->vit != temp);
 	}
 
 	if( flag&SCB_INT ) {
+		temp = status->int_;
 		status->int_ = status_calc_int(bl, sc, b_status->int_);
-		flag |= SCB_MATK|SCB_MDEF2;
-		if( bl->type&(BL_PC|BL_HOM|BL_MER|BL_ELEM) )
-			flag |= SCB_MAXSP;
-		if( bl->type&BL_HOM )
-			flag |= SCB_MDEF;
+		flag = status_calc_depend(bl, flag, SCB_INT, status->int_ != temp);
 	}
 
 	if( flag&SCB_DEX ) {
+		temp = status->dex;
 		status->dex = status_calc_dex(bl, sc, b_status->dex);
-		flag |= SCB_BATK|SCB_HIT
-#ifdef RENEWAL
-			|SCB_MATK|SCB_MDEF2
-#endif
-			;
-		if( bl->type&(BL_PC|BL_HOM) )
-			flag |= SCB_ASPD;
-		if( bl->type&BL_HOM )
-			flag |= SCB_WATK;
+		flag = status_calc_depend(bl, flag, SCB_DEX, status->dex != temp);
 	}
 
 	if( flag&SCB_LUK ) {
+		temp = status->luk;
 		status->luk = status_calc_luk(bl, sc, b_status->luk);
-		flag |= SCB_BATK|SCB_CRI|SCB_FLEE2
-#ifdef RENEWAL
-			|SCB_MATK|SCB_HIT|SCB_FLEE
-#endif
-			;
+		flag = status_calc_depend(bl, flag, SCB_LUK, status->luk != temp);
 	}
 
 	if( flag&SCB_BATK && b_status->batk ) {
@@ -4676,6 +5000,9 @@ void status_calc_bl_main(struct block_list *bl, /*enum scb_flag*/int flag)
 
 	if( flag&SCB_REGEN && bl->type&BL_REGEN )
 		status_calc_regen_rate(bl, status_get_regen_data(bl), sc);
+
+	for( flag &= SCB_BATTLE; flag; flag &= flag - 1 )
+		status_calc_counter.stats++;
 }
 
 /// Recalculates parts of an object's base status and battle status according to the specified flags.
@@ -4699,6 +5026,7 @@ void status_calc_bl_(struct block_list* bl, enum scb_flag flag, enum e_status_ca
 	//Remember previous values
 	status = status_get_status_data(bl);
 	memcpy(&b_status, status, sizeof(struct status_data));
+	clif_clearviewcache(bl); //Speed or level may change
 
 	if( flag&SCB_BASE ) { //Calculate the object's base status too
 		switch( bl->type ) {
@@ -6866,6 +7194,7 @@ void status_set_viewdata(struct block_list *bl, int class_)
 	else
 		vd = NULL;
 
+	clif_clearviewcache(bl);
 	switch (bl->type) {
 		case BL_PC: {
 				TBL_PC* sd = (TBL_PC*)bl;
@@ -7005,6 +7334,87 @@ void status_change_init(struct block_list *bl)
 	nullpo_retv(sc);
 
 	memset(sc,0,sizeof (struct status_change));
+	status_change_init_data(sc);
+}
+
+/**
+ * Points the lookup table of a status change at the shared empty table.
+ * Status changes that are not initialized through status_change_init need this before any sc->data access.
+ * @param sc: Status change to initialize
+ */
+void status_change_init_data(struct status_change *sc)
+{
+	nullpo_retv(sc);
+
+	sc->data = sc_empty_table;
+	memset(sc->active,0,sizeof(sc->active));
+	sc->timer = INVALID_TIMER;
+}
+
+/**
+ * Finds the next active status change type.
+ * Usage: for( i = status_change_next(sc, 0); i < SC_MAX; i = status_change_next(sc, i + 1) )
+ * @param sc: Status change to look into
+ * @param type: First type to check
+ * @return First active type at or after type, SC_MAX if there is none
+ */
+int status_change_next(struct status_change *sc, int type)
+{
+	int i;
+	uint32 word;
+
+	if( type < 0 )
+		type = 0;
+	if( type >= SC_MAX )
+		return SC_MAX;
+
+	i = type / 32;
+	word = sc->active[i]&(0xFFFFFFFFU<<(type % 32));
+	while( !word ) {
+		if( ++i >= SC_ACTIVE_WORDS )
+			return SC_MAX;
+		word = sc->active[i];
+	}
+	type = i * 32;
+	while( !(word&1) ) {
+		word >>= 1;
+		type++;
+	}
+	return type;
+}
+
+/**
+ * Stores a new entry in the lookup table, giving the unit its own table if it was using the shared empty one.
+ */
+static void status_change_set_entry(struct status_change *sc, enum sc_type type, struct status_change_entry *sce)
+{
+	if( sc->data == sc_empty_table ) {
+		struct sc_data_table *table = ers_alloc(sc_table_ers, struct sc_data_table);
+
+		memset(table, 0, sizeof(struct sc_data_table));
+		sc->data = table->data;
+	}
+	sc->data[type] = sce;
+	sc->active[type / 32] |= 1U<<(type % 32);
+	++sc->count;
+}
+
+/**
+ * Removes an entry from the lookup table, returning the table once the last status is gone.
+ * The caller has already decreased sc->count.
+ */
+static void status_change_unset_entry(struct status_change *sc, enum sc_type type)
+{
+	sc->data[type] = NULL;
+	sc->active[type / 32] &= ~(1U<<(type % 32));
+	if( !sc->count && sc->data != sc_empty_table ) {
+		ers_free(sc_table_ers, (struct sc_data_table *)sc->data);
+		sc->data = sc_empty_table;
+		if( sc->timer != INVALID_TIMER ) {
+			delete_timer(sc->timer, status_change_unit_timer);
+			sc->timer = INVALID_TIMER;
+		}
+	}
 }
 
 /**
@@ -8855,8 +9265,8 @@ int status_change_start(struct block_list* src,struct block_list* bl,enum sc_typ
 							sc_start4(src,src,type2,100,val1,1,0,0,tick + 1000);
 						else { //Increase count of locked enemies and refresh time
 							(sce2->val2)++;
-							delete_timer(sce2->timer,status_change_timer);
-							sce2->timer = add_timer(gettick() + tick + 1000,status_change_timer,src->id,type2);
+							status_change_delete_timer(sce2);
+							sce2->timer = status_change_add_timer(src,type2,gettick() + tick + 1000);
 						}
 					} else //Status failed
 						return 0;
@@ -10111,6 +10521,7 @@ int status_change_start(struct block_list* src,struct block_list* bl,enum sc_typ
 
 	//Set option as needed
 	opt_flag = 1;
+	clif_clearviewcache(bl);
 	switch (type) {
 		//OPT1
 		case SC_STONE: 
@@ -10346,11 +10757,11 @@ int status_change_start(struct block_list* src,struct block_list* bl,enum sc_typ
 	//Don't trust the previous sce assignment, in case the SC ended somewhere between there and here
 	if((sce = sc->data[type])) { //Reuse old sc
 		if(sce->timer != INVALID_TIMER)
-			delete_timer(sce->timer,status_change_timer);
+			status_change_delete_timer(sce);
 		sc_isnew = false;
 	} else { //New sc
-		++sc->count;
-		sce = sc->data[type] = ers_alloc(sc_data_ers,struct status_change_entry);
+		sce = ers_alloc(sc_data_ers,struct status_change_entry);
+		status_change_set_entry(sc,type,sce);
 	}
 
 	sce->val1 = val1;
@@ -10359,7 +10770,7 @@ int status_change_start(struct block_list* src,struct block_list* bl,enum sc_typ
 	sce->val4 = val4;
 
 	if(tick >= 0)
-		sce->timer = add_timer(gettick() + tick,status_change_timer,bl->id,type);
+		sce->timer = status_change_add_timer(bl,type,gettick() + tick);
 	else
 		sce->timer = INVALID_TIMER; //Infinite duration
 
@@ -10465,9 +10876,7 @@ int status_change_clear(struct block_list* bl,int type)
 	if(!sc || !sc->count)
 		return 0;
 
-	for(i = 0; i < SC_MAX; i++) {
-		if(!sc->data[i])
-			continue;
+	for(i = status_change_next(sc, 0); i < SC_MAX; i = status_change_next(sc, i + 1)) {
 		if(type == 0) {
 			switch(i) { //Type 0: PC killed -> Place here statuses that do not dispel on death
 				case SC_ELEMENTALCHANGE: //Only when its Holy or Dark that it doesn't dispell on death
@@ -10577,11 +10986,13 @@ int status_change_clear(struct block_list* bl,int type)
 
 		//If for some reason status_change_end decides to still keep the status when quitting [Skotlex]
 		if(type == 1 && sc->data[i]) {
+			struct status_change_entry *sce = sc->data[i];
+
+			if(sce->timer != INVALID_TIMER)
+				status_change_delete_timer(sce);
 			sc->count--;
-			if(sc->data[i]->timer != INVALID_TIMER)
-				delete_timer(sc->data[i]->timer,status_change_timer);
-			ers_free(sc_data_ers,sc->data[i]);
-			sc->data[i] = NULL;
+			status_change_unset_entry(sc,(sc_type)i);
+			ers_free(sc_data_ers,sce);
 		}
 	}
 
@@ -10633,7 +11044,7 @@ int status_change_end_(struct block_list* bl, enum sc_type type, int tid, const
 		if (type == SC_ENDURE && sce->val4)
 			return 0; //Do not end infinite endure
 		if (sce->timer != INVALID_TIMER) //Could be a SC with infinite duration
-			delete_timer(sce->timer,status_change_timer);
+			status_change_delete_timer(sce);
 		if (sc->opt1)
 			switch (type) {
 				//"Ugly workaround" [Skotlex]
@@ -10649,7 +11060,7 @@ int status_change_end_(struct block_list* bl, enum sc_type type, int tid, const
 						//since these SC are not affected by it, and it lets us know
 						//if we have already delayed this attack or not
 						sce->val1 = 0;
-						sce->timer = add_timer(gettick() + 10,status_change_timer,bl->id,type);
+						sce->timer = status_change_add_timer(bl,type,gettick() + 10);
 						return 1;
 					}
 			}
@@ -10660,7 +11071,7 @@ int status_change_end_(struct block_list* bl, enum sc_type type, int tid, const
 	if (StatusChangeStateTable[type])
 		status_calc_state(bl,sc,(enum scs_flag)StatusChangeStateTable[type],false);
 
-	sc->data[type] = NULL;
+	status_change_unset_entry(sc,type);
 
 	if (sd && StatusDisplayType[type])
 		status_display_remove(sd,type);
@@ -11164,6 +11575,7 @@ int status_change_end_(struct block_list* bl, enum sc_type type, int tid, const
 	}
 
 	opt_flag = 1;
+	clif_clearviewcache(bl);
 	switch (type) {
 		case SC_STONE:
 		case SC_FREEZE:
@@ -11382,6 +11794,115 @@ int status_change_end_(struct block_list* bl, enum sc_type type, int tid, const
 	return 1;
 }
 
+/**
+ * Makes sure the heap timer of a unit wakes it up no later than tick.
+ * @param bl: Unit
+ * @param sc: Status change of the unit
+ * @param tick: When an entry timer is due
+ */
+static void status_change_arm_timer(struct block_list *bl, struct status_change *sc, unsigned int tick)
+{
+	if( sc->timer != INVALID_TIMER ) {
+		if( DIFF_TICK(sc->timer_tick, tick) <= 0 )
+			return;
+		delete_timer(sc->timer, status_change_unit_timer); //settick_timer would search the whole heap
+	}
+	sc->timer = add_timer(tick, status_change_unit_timer, bl->id, 0);
+	sc->timer_tick = tick;
+}
+
+/**
+ * Sets the timer of a status change entry, replacing add_timer(tick, status_change_timer, bl->id, type).
+ * Entries don't own heap timers, each unit has a single one for its earliest entry (see status_change_unit_timer).
+ * @param bl: Unit
+ * @param type: Status change whose entry gets the timer
+ * @param tick: When status_change_timer should be called
+ * @return Handle to store in sce->timer, INVALID_TIMER if the entry doesn't exist
+ */
+int status_change_add_timer(struct block_list *bl, enum sc_type type, unsigned int tick)
+{
+	struct status_change *sc = status_get_sc(bl);
+	struct status_change_entry *sce;
+
+	if( !sc || !(sce = sc->data[type]) )
+		return INVALID_TIMER;
+
+	sce->tick = tick;
+	status_change_arm_timer(bl, sc, tick);
+	if( sc_timer_serial == INT_MAX )
+		sc_timer_serial = 0;
+	return ++sc_timer_serial;
+}
+
+/**
+ * Cancels the timer of a status change entry, replacing delete_timer(sce->timer, status_change_timer).
+ * The unit timer is left alone, it finds nothing due and goes back to sleep.
+ * @param sce: Status change entry
+ */
+void status_change_delete_timer(struct status_change_entry *sce)
+{
+	nullpo_retv(sce);
+
+	sce->timer = INVALID_TIMER;
+}
+
+/**
+ * Heap timer of a unit, calls status_change_timer for every entry that is due, earliest first.
+ * Each entry gets its own due tick like a heap timer would, so periodic effects don't drift.
+ */
+static int status_change_unit_timer(int tid, unsigned int tick, int id, intptr_t data)
+{
+	struct block_list *bl = map_id2bl(id);
+	struct status_change *sc;
+	unsigned int now = gettick();
+	int i, next;
+
+	if( !bl || !(sc = status_get_sc(bl)) || sc->timer != tid )
+		return 0;
+
+	sc->timer = INVALID_TIMER;
+	if( DIFF_TICK(now, tick) < 0 )
+		now = tick;
+
+	for(;;) {
+		struct status_change_entry *sce;
+
+		next = SC_MAX;
+		for( i = status_change_next(sc, 0); i < SC_MAX; i = status_change_next(sc, i + 1) ) {
+			sce = sc->data[i];
+			if( sce->timer == INVALID_TIMER || DIFF_TICK(sce->tick, now) > 0 )
+				continue;
+			if( next == SC_MAX || DIFF_TICK(sce->tick, sc->data[next]->tick) < 0 )
+				next = i;
+		}
+		if( next == SC_MAX )
+			break;
+
+		sce = sc->data[next];
+		status_change_timer(sce->timer, (DIFF_TICK(sce->tick, now) < -1000 ? now : sce->tick), id, next);
+
+		//The unit can be gone after any of the timers
+		if( !(bl = map_id2bl(id)) || !(sc = status_get_sc(bl)) )
+			return 0;
+	}
+
+	//Sleep until the next entry timer
+	next = SC_MAX;
+	for( i = status_change_next(sc, 0); i < SC_MAX; i = status_change_next(sc, i + 1) ) {
+		if( sc->data[i]->timer == INVALID_TIMER )
+			continue;
+		if( next == SC_MAX || DIFF_TICK(sc->data[i]->tick, sc->data[next]->tick) < 0 )
+			next = i;
+	}
+	if( next != SC_MAX )
+		status_change_arm_timer(bl, sc, sc->data[next]->tick);
+	else if( sc->timer != INVALID_TIMER ) {
+		delete_timer(sc->timer, status_change_unit_timer);
+		sc->timer = INVALID_TIMER;
+	}
+	return 0;
+}
+
 /*==========================================
  * For recusive status, like for each 5s we drop sp etc.
  * Reseting the end timer.
@@ -11418,9 +11939,9 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 	sd = BL_CAST(BL_PC,bl);
 
 //Set the next timer of the sce (don't assume the status still exists)
-#define sc_timer_next(t,f,i,d) \
+#define sc_timer_next(t) \
 	if( (sce = sc->data[type]) ) \
-		sce->timer = add_timer(t,f,i,d); \
+		sce->timer = status_change_add_timer(bl,type,t); \
 	else \
 		ShowError("status_change_timer: Unexpected NULL status change id: %d data: %d\n",id,data)
 
@@ -11429,7 +11950,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_CLOAKING:
 			if( !status_charge(bl,0,1) )
 				break; //Not enough SP to continue
-			sc_timer_next(sce->val2 + tick,status_change_timer,bl->id,data);
+			sc_timer_next(sce->val2 + tick);
 			return 0;
 
 		case SC_CHASEWALK:
@@ -11440,13 +11961,13 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				(sc->data[SC_SPIRIT] && sc->data[SC_SPIRIT]->val2 == SL_ROGUE ? 10 : 1) * //SL bonus -> x10 duration
 				skill_get_time2(status_sc2skill(type),sce->val1));
 			}
-			sc_timer_next(sce->val2 + tick,status_change_timer,bl->id,data);
+			sc_timer_next(sce->val2 + tick);
 			return 0;
 
 		case SC_SKA:
 			if( --(sce->val2) >= 0 ) {
 				sce->val3 = rnd()%100; //Random defense
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11455,7 +11976,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val2) >= 0 ) {
 				if( sce->val2%sce->val4 == 0 && !status_charge(bl,0,1) )
 					break; //Fail if it's time to substract SP and there isn't
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11470,7 +11991,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			} else
 				map_foreachinrange(status_change_timer_sub,bl,sce->val3,BL_CHAR,bl,sce,type,tick);
 			if( --(sce->val2) >= 0 ) {
-				sc_timer_next(20 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(20 + tick);
 				sce->val4 += 20; //Use for Shadow Form 2 seconds checking
 				return 0;
 			}
@@ -11478,7 +11999,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			
 		case SC_PROVOKE:
 			if( sce->val2 ) { //Auto-provoke (it is ended in status_heal)
-				sc_timer_next(1000 * 60 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 * 60 + tick);
 				return 0;
 			}
 			break;
@@ -11490,14 +12011,14 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				unit_stop_attack(bl);
 				sc->opt1 = OPT1_STONE;
 				clif_changeoption(bl);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				status_calc_bl(bl,StatusChangeFlagTable[type]);
 				return 0;
 			}
 			if( --(sce->val3) >= 0 ) {
 				if( ++(sce->val4)%5 == 0 && status->hp > status->max_hp / 4 )
 					status_percent_damage(NULL,bl,1,0,false);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11516,7 +12037,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 					if( status->hp >= max(status->max_hp>>2,sce->val4) ) //Stop damaging after 25% HP left
 						status_zap(bl,sce->val4,0);
 					if( sc->data[type] ) { //Check if the status still last (can be dead since then)
-						sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+						sc_timer_next(1000 + tick);
 					}
 					map_freeblock_unlock();
 				}
@@ -11526,7 +12047,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 
 		case SC_TENSIONRELAX:
 			if( status->max_hp > status->hp && --(sce->val3) >= 0 ) { //Decrease at 10secs intervals
-				sc_timer_next(10000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(10000 + tick);
 				return 0;
 			}
 			break;
@@ -11562,7 +12083,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 						map_freeblock_unlock();
 						return 0;
 					}
-					sc_timer_next(10000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(10000 + tick);
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -11578,7 +12099,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				if( status->hp < status->max_hp )
 					hp = (sce->val1 < 0) ? (int)(sd->status.max_hp * -1 * sce->val1 / 100.) : sce->val1 ;
 				status_heal(bl,hp,0,2);
-				sc_timer_next((sce->val2 * 1000) + tick,status_change_timer,bl->id,data);
+				sc_timer_next((sce->val2 * 1000) + tick);
 				return 0;
 			}
 			break;
@@ -11590,7 +12111,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				if( boss_md && sd->bl.m == boss_md->bl.m ) {
 					clif_bossmapinfo(sd->fd,boss_md,1); //Update X - Y on minimap
 					if( boss_md->bl.prev != NULL ) {
-						sc_timer_next(5000 + tick,status_change_timer,bl->id,data);
+						sc_timer_next(5000 + tick);
 						return 0;
 					}
 				}
@@ -11648,14 +12169,14 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 					if( !status_charge(bl,0,sp) )
 						break;
 				}
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
 
 		case SC_BERSERK:
 			if( --(sce->val4) >= 0 && status_charge(bl,sce->val2,0) && status->hp > 100 ) {
-				sc_timer_next(sce->val3 + tick,status_change_timer,bl->id,data); //5% MaxHP drain every 15 seconds
+				sc_timer_next(sce->val3 + tick); //5% MaxHP drain every 15 seconds
 				return 0;
 			}
 			break;
@@ -11666,7 +12187,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				clif_changestatus(sd,SP_MANNER,sd->status.manner);
 				clif_updatestatus(sd,SP_MANNER);
 				if( sd->status.manner < 0 ) { //Every 60 seconds your manner goes up by 1 until it gets back to 0
-					sc_timer_next(60000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(60000 + tick);
 					return 0;
 				}
 			}
@@ -11680,7 +12201,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			//	clif_displaymessage(bl,timer);
 			//}
 			if( (sce->val4 -= 500) >= 0 ) {
-				sc_timer_next(500 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(500 + tick);
 				return 0;
 			}
 			break;
@@ -11691,7 +12212,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				struct block_list *pbl = map_id2bl(sce->val1);
 
 				if( pbl && check_distance_bl(bl,pbl,7) ) {
-					sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(1000 + tick);
 					return 0;
 				}
 			}
@@ -11705,21 +12226,21 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				sp = (sce->val1 > 5) ? 35 : 20;
 				if( !status_charge(bl,hp,sp) )
 					break;
-				sc_timer_next(10000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(10000 + tick);
 				return 0;
 			}
 			break;
 
 		case SC_JAILED:
 			if( sce->val1 == INT_MAX || --(sce->val1) >= 0 ) {
-				sc_timer_next(60000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(60000 + tick);
 				return 0;
 			}
 			break;
 
 		case SC_BLIND:
 			if( sc->data[SC_FOGWALL] ) { //Blind lasts forever while you are standing on the fog
-				sc_timer_next(5000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(5000 + tick);
 				return 0;
 			}
 			break;
@@ -11727,7 +12248,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_ABUNDANCE:
 			if( --(sce->val4) >= 0 ) {
 				status_heal(bl,0,60,0);
-				sc_timer_next(10000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(10000 + tick);
 				return 0;
 			}
 			break;
@@ -11738,7 +12259,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				status_damage(NULL,bl,100,0,clif_damage(bl,bl,tick,status_get_amotion(bl),status_get_dmotion(bl) + 500,100,0,DMG_NORMAL,0),0);
 				unit_skillcastcancel(bl,2);
 				if( sc->data[type] ) {
-					sc_timer_next(5000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(5000 + tick);
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -11754,7 +12275,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				status_damage(NULL,bl,damage,0,clif_damage(bl,bl,tick,status_get_amotion(bl),status_get_dmotion(bl) + 500,damage,0,DMG_NORMAL,0),0);
 				unit_skillcastcancel(bl,2);
 				if( sc->data[type] ) {
-					sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(1000 + tick);
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -11801,7 +12322,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 						}
 					}
 					clif_emotion(bl,E_HEH);
-					sc_timer_next(4000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(4000 + tick);
 					map_freeblock_unlock();
 				}
 				return 0;
@@ -11814,7 +12335,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				status_damage(NULL,bl,1,status->max_sp * 3 / 100,clif_damage(bl,bl,tick,status_get_amotion(bl),1,1,0,DMG_NORMAL,0),0);
 				unit_skillcastcancel(bl,2);
 				if( sc->data[type] ) {
-					sc_timer_next(10000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(10000 + tick);
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -11824,7 +12345,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_OBLIVIONCURSE:
 			if( --(sce->val4) >= 0 ) {
 				clif_emotion(bl,E_WHAT);
-				sc_timer_next(3000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(3000 + tick);
 				return 0;
 			}
 			break;
@@ -11833,7 +12354,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,3) )
 					break;
-				sc_timer_next(3000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(3000 + tick);
 				return 0;
 			}
 			break;
@@ -11841,7 +12362,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_CLOAKINGEXCEED:
 			if( !status_charge(bl,0,10 - sce->val1) )
 				break;
-			sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+			sc_timer_next(1000 + tick);
 			return 0;
 
 		case SC_RENOVATIO:
@@ -11860,7 +12381,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 					status_heal(bl,heal,0,3);
 				}
 				if( sc->data[type] ) {
-					sc_timer_next(5000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(5000 + tick);
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -11876,7 +12397,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				status_damage(src,bl,damage,0,clif_damage(bl,bl,tick,status_get_amotion(bl),1,damage,0,DMG_NORMAL,0),0);
 				unit_skillcastcancel(bl,2);
 				if( sc->data[type] ) { //Target still lives [LimitLine]
-					sc_timer_next(3000 + tick,status_change_timer,bl->id,data); //Deals damage every 3 seconds
+					sc_timer_next(3000 + tick); //Deals damage every 3 seconds
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -11887,7 +12408,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( sce->val2 > 0 )
 					sce->val2--;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11900,7 +12421,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,1) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11913,14 +12434,14 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 					status_change_end(bl,(sc_type)i,INVALID_TIMER);
 				break;
 			}
-			sc_timer_next(10000 + tick,status_change_timer,bl->id,data);
+			sc_timer_next(10000 + tick);
 			return 0;
 
 		case SC_ELECTRICSHOCKER:
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,5 * sce->val1 * status->max_sp / 100) )
 					status_zap(bl,0,status->sp);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11930,14 +12451,14 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				break;
 			if( --(sce->val4) >= 0 )
 				sce->val3++; //Value from duration
-			sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+			sc_timer_next(1000 + tick);
 			return 0;
 
 		case SC__REPRODUCE:
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,9 - (1 + sce->val1) / 2) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11946,7 +12467,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,11 - sce->val1) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11955,7 +12476,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,status->max_sp * (12 - 2 * sce->val1) / 100) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11964,7 +12485,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,sce->val3) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -11975,7 +12496,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 					sc->cant.move++;
 					sce->val2 = 1;
 				}
-				sc_timer_next(100 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(100 + tick);
 				return 0;
 			}
 			break;
@@ -11991,7 +12512,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				if( group )
 					skill_attack(BF_MISC,src,src,bl,group->skill_id,group->skill_lv,tick,SD_LEVEL|SD_ANIMATION);
 				if( sc->data[type] ) {
-					sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(1000 + tick);
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -12009,7 +12530,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				heal = 200 + 100 * sce->val1 + status_get_int(src);
 				skill_attack(BF_MISC,src,src,bl,status_sc2skill(type),sce->val1,tick,SD_LEVEL|SD_ANIMATION);
 				if( sc->data[type] ) {
-					sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(1000 + tick);
 				}
 				status_heal(src,heal * (5 + 5 * sce->val1) / 100,0,0); //5 + 5% per level
 				map_freeblock_unlock();
@@ -12025,7 +12546,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				map_freeblock_lock();
 				status_damage(src,bl,damage,0,clif_damage(bl,bl,tick,0,0,damage,0,DMG_ENDURE,0),1);
 				if( sc->data[type] ) {
-					sc_timer_next(2000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(2000 + tick);
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -12035,7 +12556,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_TEARGAS_SOB:
 			if( --(sce->val4) >= 0 ) {
 				clif_emotion(bl,E_SOB);
-				sc_timer_next(3000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(3000 + tick);
 				return 0;
 			}
 			break;
@@ -12043,7 +12564,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_VOICEOFSIREN:
 			if( --(sce->val4) >= 0 ) {
 				clif_emotion(bl,E_LV);
-				sc_timer_next(2000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(2000 + tick);
 				return 0;
 			}
 			break;
@@ -12051,7 +12572,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_DEEPSLEEP:
 			if( --(sce->val4) >= 0 ) { //Recovers 3% of the player's MaxHP/MaxSP every 2 seconds
 				status_heal(bl,status->max_hp * 3 / 100,status->max_sp * 3 / 100,2);
-				sc_timer_next(2000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(2000 + tick);
 				return 0;
 			}
 			break;
@@ -12061,7 +12582,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				if( !status_charge(bl,0,sce->val3) )
 					break;
 				status_heal(bl,sce->val2,0,1);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12069,14 +12590,14 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_SONGOFMANA:
 			if( --(sce->val4) >= 0 ) {
 				status_heal(bl,0,sce->val3,3);
-				sc_timer_next(5000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(5000 + tick);
 				return 0;
 			}
 			break;
 
 		case SC_SATURDAYNIGHTFEVER:
 			if( --(sce->val4) >= 0 && status_charge(bl,sce->val2,status->max_sp / 100) && status->hp > 100 ) {
-				sc_timer_next(sce->val3 + tick,status_change_timer,bl->id,data); //1% MaxHP/MaxSP drain every val3 seconds [Jobbie]
+				sc_timer_next(sce->val3 + tick); //1% MaxHP/MaxSP drain every val3 seconds [Jobbie]
 				return 0;
 			}
 			break;
@@ -12084,7 +12605,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_MELODYOFSINK:
 			if( --(sce->val4) >= 0 ) {
 				status_charge(bl,0,status->max_sp * (2 * sce->val1 + min(2 * sce->val2,20)) / 100);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12093,7 +12614,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) { //Drains 2% of HP and 1% of SP every seconds
 				if( bl->type != BL_MOB ) //Doesn't work on mobs
 					status_charge(bl,status->max_hp * 2 / 100,status->max_sp / 100);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12102,7 +12623,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,24 - 4 * sce->val1) )
 					break;
-				sc_timer_next(10000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(10000 + tick);
 				return 0;
 			}
 			break;
@@ -12111,7 +12632,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( status_charge(bl,0,7 - sce->val1) ) {
 				if( sd )
 					pc_banding(sd,sce->val1);
-				sc_timer_next(5000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(5000 + tick);
 				return 0;
 			}
 			break;
@@ -12120,14 +12641,14 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,10) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
 
 		case SC_OVERHEAT_LIMITPOINT:
 			if( --(sce->val1) >= 0 ) { //Cooling
-				sc_timer_next(30000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(30000 + tick);
 			}
 			break;
 
@@ -12139,7 +12660,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				map_freeblock_lock();
 				status_fix_damage(NULL,bl,damage,clif_damage(bl,bl,tick,0,0,damage,0,DMG_NORMAL,0));
 				if( sc->data[type] ) {
-					sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(1000 + tick);
 				}
 				map_freeblock_unlock();
 				return 0;
@@ -12159,7 +12680,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 					if( !src || !ssc || !ssc->data[SC_MAGNETICFIELD] )
 						break; //Source no more under Magnetic Field
 				}
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12168,7 +12689,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,status->max_sp * 3 / 100) )
 					break;
-				sc_timer_next(2000 + 1000 * sce->val1 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(2000 + 1000 * sce->val1 + tick);
 				return 0;
 			}
 			break;
@@ -12180,7 +12701,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 
 				if( !status_charge(bl,hp,sp) )
 					break;
-				sc_timer_next(5000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(5000 + tick);
 				return 0;
 			}
 			break;
@@ -12189,7 +12710,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,0,sce->val3) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12198,7 +12719,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val3) >= 0 && status_charge(bl,sce->val2,0) ) {
 				if( !sc->data[type] )
 					return 0;
-				sc_timer_next(5000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(5000 + tick);
 				return 0;
 			}
 			break;
@@ -12224,7 +12745,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_WIND_CURTAIN:
 		case SC_STONE_SHIELD:
 			if( status_charge(bl,0,sce->val2) && (sce->val4 == -1 || (sce->val4 -= sce->val3) >= 0) ) {
-				sc_timer_next(sce->val3 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(sce->val3 + tick);
 				return 0;
 			} else if( bl->type == BL_ELEM )
 				elemental_change_mode(BL_CAST(BL_ELEM,bl),MAX_ELESKILLTREE);
@@ -12238,7 +12759,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 					skill_sit(sd,1);
 					clif_sitting(bl);
 				}
-				sc_timer_next(10000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(10000 + tick);
 				return 0;
 			}
 			break;
@@ -12248,13 +12769,13 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_SOULCOLD:
 		case SC_HAWKEYES:
 			//They only end by status_change_end
-			sc_timer_next(600000 + tick,status_change_timer,bl->id,data);
+			sc_timer_next(600000 + tick);
 			return 0;
 
 		case SC_MEIKYOUSISUI:
 			if( --(sce->val4) >= 0 ) {
 				status_heal(bl,status->max_hp * (sce->val1 + 1) / 100,status->max_sp * sce->val1 / 100,0);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12264,7 +12785,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val2) >= 0 ) {
 				if( !status_charge(bl,0,1) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12273,7 +12794,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 			if( --(sce->val4) >= 0 ) {
 				if( !status_charge(bl,100,20) )
 					break;
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12286,9 +12807,9 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				if( !status_charge(bl,hp,sp) )
 					break;
 				if( bl->type == BL_MOB )
-					sc_timer_next(2000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(2000 + tick);
 				else
-					sc_timer_next(3000 + tick,status_change_timer,bl->id,data);
+					sc_timer_next(3000 + tick);
 				return 0;
 			}
 			break;
@@ -12296,7 +12817,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_FULL_THROTTLE:
 			if( --(sce->val4) >= 0 ) {
 				status_percent_damage(bl,bl,0,sce->val2,false);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12304,7 +12825,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_REBOUND:
 			if( --(sce->val4) >= 0 ) {
 				clif_emotion(bl,E_SWT);
-				sc_timer_next(2000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(2000 + tick);
 				return 0;
 			}
 			break;
@@ -12312,7 +12833,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_KINGS_GRACE:
 			if( --(sce->val4) >= 0 ) {
 				status_percent_heal(bl,sce->val2,0);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12320,7 +12841,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 		case SC_FRIGG_SONG:
 			if( --(sce->val4) >= 0 ) {
 				status_heal(bl,sce->val3,0,0);
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12332,7 +12853,7 @@ int status_change_timer(int tid, unsigned int tick, int id, intptr_t data)
 				if( !sd || sd->bl.m != bl->m ) //End status if caster isn't in same map
 					break;
 				clif_crimson_marker(sd,bl,0); //Update target position
-				sc_timer_next(1000 + tick,status_change_timer,bl->id,data);
+				sc_timer_next(1000 + tick);
 				return 0;
 			}
 			break;
@@ -12447,9 +12968,7 @@ void status_change_clear_buffs(struct block_list* bl, int type)
 		for( i = SC_COMMON_MIN; i <= SC_COMMON_MAX; i++ )
 			status_change_end(bl, (sc_type)i, INVALID_TIMER);
 
-	for( i = SC_COMMON_MAX + 1; i < SC_MAX; i++ ) {
-		if( !sc->data[i] )
-			continue;
+	for( i = status_change_next(sc, SC_COMMON_MAX + 1); i < SC_MAX; i = status_change_next(sc, i + 1) ) {
 		switch( i ) {
 			//Stuff that cannot be removed
 			case SC_WEIGHT50:
@@ -12625,7 +13144,6 @@ void status_change_clear_buffs(struct block_list* bl, int type)
 int status_change_spread(struct block_list *src, struct block_list *bl) {
 	int i, flag = 0;
 	struct status_change *sc = status_get_sc(src);
-	const struct TimerData *timer;
 	unsigned int tick;
 	struct status_change_data data;
 
@@ -12638,8 +13156,8 @@ int status_change_spread(struct block_list *src, struct block_list *bl) {
 	if( (status_get_mode(src)&MD_BOSS) || (status_get_mode(bl)&MD_BOSS) )
 		return 0;
 
-	for( i = SC_COMMON_MIN; i < SC_MAX; i++ ) {
-		if( !sc->data[i] || i == SC_COMMON_MAX )
+	for( i = status_change_next(sc, SC_COMMON_MIN); i < SC_MAX; i = status_change_next(sc, i + 1) ) {
+		if( i == SC_COMMON_MAX )
 			continue;
 
 		switch( i ) {
@@ -12673,10 +13191,9 @@ int status_change_spread(struct block_list *src, struct block_list *bl) {
 			case SC_DEATHHURT:
 			case SC_PARALYSE:
 				if( sc->data[i]->timer != INVALID_TIMER ) {
-					timer = get_timer(sc->data[i]->timer);
-					if( timer == NULL || timer->func != status_change_timer || DIFF_TICK(timer->tick,tick) < 0 )
+					if( DIFF_TICK(sc->data[i]->tick,tick) < 0 )
 						continue;
-					data.tick = DIFF_TICK(timer->tick,tick);
+					data.tick = DIFF_TICK(sc->data[i]->tick,tick);
 				} else
 					data.tick = INVALID_TIMER;
 				break;
@@ -12723,22 +13240,100 @@ int status_change_spread(struct block_list *src, struct block_list *bl) {
 
 //Natural regen related stuff
 static unsigned int natural_heal_prev_tick,natural_heal_diff_tick;
-static int status_natural_heal(struct block_list* bl, va_list args)
+
+/// Objects with natural regen, in parallel arrays so the regen pass is one linear walk.
+/// The pointers are resolved once when the object is added (see map_addiddb).
+static struct {
+	struct block_list **bl;
+	struct regen_data **regen;
+	struct status_data **status;
+	struct status_change **sc;
+	struct unit_data **ud;
+	int count, max;
+	bool running; ///< Inside status_natural_heal_timer, removals leave a hole
+	bool holes; ///< Slots removed while running
+} natural_heal_list;
+
+/**
+ * Adds an object to the natural regen arrays.
+ * @param bl: Object of a BL_REGEN type
+ */
+void status_natural_heal_add(struct block_list *bl)
+{
+	struct regen_data *regen = status_get_regen_data(bl);
+	int i;
+
+	if( !regen )
+		return;
+	i = regen->index;
+	if( i < 0 || i >= natural_heal_list.count || natural_heal_list.bl[i] != bl )
+		ARR_FIND(0, natural_heal_list.count, i, natural_heal_list.bl[i] == bl);
+	if( i < natural_heal_list.count ) {
+		regen->index = i;
+		return; //Already there
+	}
+
+	if( natural_heal_list.count == natural_heal_list.max ) {
+		natural_heal_list.max += 256;
+		RECREATE(natural_heal_list.bl, struct block_list *, natural_heal_list.max);
+		RECREATE(natural_heal_list.regen, struct regen_data *, natural_heal_list.max);
+		RECREATE(natural_heal_list.status, struct status_data *, natural_heal_list.max);
+		RECREATE(natural_heal_list.sc, struct status_change *, natural_heal_list.max);
+		RECREATE(natural_heal_list.ud, struct unit_data *, natural_heal_list.max);
+	}
+	i = natural_heal_list.count++;
+	natural_heal_list.bl[i] = bl;
+	natural_heal_list.regen[i] = regen;
+	natural_heal_list.status[i] = status_get_status_data(bl);
+	natural_heal_list.sc[i] = status_get_sc(bl);
+	natural_heal_list.ud[i] = unit_bl2ud(bl);
+	regen->index = i;
+}
+
+/**
+ * Moves slot from to slot to of the natural regen arrays.
+ */
+static void status_natural_heal_move(int from, int to)
+{
+	natural_heal_list.bl[to] = natural_heal_list.bl[from];
+	natural_heal_list.regen[to] = natural_heal_list.regen[from];
+	natural_heal_list.status[to] = natural_heal_list.status[from];
+	natural_heal_list.sc[to] = natural_heal_list.sc[from];
+	natural_heal_list.ud[to] = natural_heal_list.ud[from];
+	natural_heal_list.regen[to]->index = to;
+}
+
+/**
+ * Removes an object from the natural regen arrays.
+ * @param bl: Object of a BL_REGEN type
+ */
+void status_natural_heal_remove(struct block_list *bl)
+{
+	struct regen_data *regen = status_get_regen_data(bl);
+	int i = (regen ? regen->index : -1);
+
+	if( i < 0 || i >= natural_heal_list.count || natural_heal_list.bl[i] != bl ) {
+		ARR_FIND(0, natural_heal_list.count, i, natural_heal_list.bl[i] == bl);
+		if( i == natural_heal_list.count )
+			return;
+	}
+
+	if( natural_heal_list.running ) {
+		natural_heal_list.bl[i] = NULL;
+		natural_heal_list.holes = true;
+		return;
+	}
+	if( i != --natural_heal_list.count )
+		status_natural_heal_move(natural_heal_list.count, i);
+}
+
+static int status_natural_heal(struct block_list* bl, struct regen_data *regen, struct status_data *status, struct status_change *sc, struct unit_data *ud)
 {
-	struct regen_data *regen;
-	struct status_data *status;
-	struct status_change *sc;
-	struct unit_data *ud;
 	struct view_data *vd = NULL;
 	struct regen_data_sub *sregen;
 	struct map_session_data *sd;
-	int rate, multi = 1, flag;
+	int rate, multi = 1, flag, hp = 0, sp = 0;
 
-	regen = status_get_regen_data(bl);
-	if (!regen)
-		return 0;
-	status = status_get_status_data(bl);
-	sc = status_get_sc(bl);
 	if (sc && !sc->count)
 		sc = NULL;
 	sd = BL_CAST(BL_PC,bl);
@@ -12787,7 +13382,6 @@ static int status_natural_heal(struct block_list* bl, va_list args)
 	}
 	if (flag && regen->state.overweight)
 		flag = RGN_NONE;
-	ud = unit_bl2ud(bl);
 	if (flag&(RGN_HP|RGN_SHP|RGN_SSP) && ud && ud->walktimer != INVALID_TIMER) {
 		flag &= ~(RGN_SHP|RGN_SSP);
 		if (!regen->state.walk)
@@ -12819,7 +13413,8 @@ static int status_natural_heal(struct block_list* bl, va_list args)
 				val += regen->hp;
 				regen->tick.hp -= battle_config.natural_healhp_interval;
 			} while (regen->tick.hp >= (unsigned int)battle_config.natural_healhp_interval);
-			if (status_heal(bl, val, 0, 1) < val)
+			hp = status_heal(bl, val, 0, 1|4);
+			if (hp < val)
 				flag &= ~RGN_SHP; //Full
 		}
 	}
@@ -12842,10 +13437,14 @@ static int status_natural_heal(struct block_list* bl, va_list args)
 				val += regen->sp;
 				regen->tick.sp -= battle_config.natural_healsp_interval;
 			} while (regen->tick.sp >= (unsigned int)battle_config.natural_healsp_interval);
-			if (status_heal(bl, 0, val, 1) < val)
+			sp = status_heal(bl, 0, val, 1|4);
+			if (sp < val)
 				flag &= ~RGN_SSP; //Full
 		}
 	}
+	//One client update for both natural heals
+	if (hp || sp)
+		status_heal_notify(bl, hp, sp, 1);
 	if (!regen->sregen)
 		return flag;
 	//Skill regen
@@ -12886,8 +13485,26 @@ static int status_natural_heal(struct block_list* bl, va_list args)
 //Natural heal main timer.
 static int status_natural_heal_timer(int tid, unsigned int tick, int id, intptr_t data)
 {
+	int i, j;
+
 	natural_heal_diff_tick = DIFF_TICK(tick,natural_heal_prev_tick);
-	map_foreachregen(status_natural_heal);
+	natural_heal_list.running = true;
+	for( i = 0; i < natural_heal_list.count; i++ ) {
+		if( natural_heal_list.bl[i] )
+			status_natural_heal(natural_heal_list.bl[i], natural_heal_list.regen[i], natural_heal_list.status[i], natural_heal_list.sc[i], natural_heal_list.ud[i]);
+	}
+	natural_heal_list.running = false;
+	if( natural_heal_list.holes ) { //Close the slots of objects removed during the pass
+		for( i = j = 0; i < natural_heal_list.count; i++ ) {
+			if( !natural_heal_list.bl[i] )
+				continue;
+			if( i != j )
+				status_natural_heal_move(i, j);
+			j++;
+		}
+		natural_heal_list.count = j;
+		natural_heal_list.holes = false;
+	}
 	natural_heal_prev_tick = tick;
 	return 0;
 }
@@ -12973,6 +13590,7 @@ int status_readdb(void)
 	//path,filename,separator,mincol,maxcol,maxrow,func_parsor
 	sv_readdb(db_path, DBPATH"size_fix.txt", ',', MAX_WEAPON_TYPE, MAX_WEAPON_TYPE, ARRAYLENGTH(atkmods), &status_readdb_sizefix);
 	sv_readdb(db_path, DBPATH"refine_db.txt", ',', 4 + MAX_REFINE, 4 + MAX_REFINE, ARRAYLENGTH(refine_info), &status_readdb_refine);
+	status_calc_cache_clear();
 	return 0;
 }
 
@@ -12981,13 +13599,15 @@ int status_readdb(void)
  *------------------------------------------*/
 int do_init_status(void)
 {
-	add_timer_func_list(status_change_timer,"status_change_timer");
+	add_timer_func_list(status_change_unit_timer,"status_change_unit_timer");
 	add_timer_func_list(status_natural_heal_timer,"status_natural_heal_timer");
 	initChangeTables();
 	initDummyData();
 	status_readdb();
 	natural_heal_prev_tick = gettick();
+	status_calc_stats_reset();
 	sc_data_ers = ers_new(sizeof(struct status_change_entry),"status.c::sc_data_ers",ERS_OPT_NONE);
+	sc_table_ers = ers_new(sizeof(struct sc_data_table),"status.c::sc_table_ers",ERS_OPT_NONE);
 	add_timer_interval(natural_heal_prev_tick + NATURAL_HEAL_INTERVAL,status_natural_heal_timer,0,0,NATURAL_HEAL_INTERVAL);
 	return 0;
 }
@@ -12995,4 +13615,11 @@ int do_init_status(void)
 void do_final_status(void)
 {
 	ers_destroy(sc_data_ers);
+	ers_destroy(sc_table_ers);
+	aFree(natural_heal_list.bl);
+	aFree(natural_heal_list.regen);
+	aFree(natural_heal_list.status);
+	aFree(natural_heal_list.sc);
+	aFree(natural_heal_list.ud);
+	memset(&natural_heal_list, 0, sizeof(natural_heal_list));
 }
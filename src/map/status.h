@@ -1945,6 +1945,8 @@ struct regen_data {
 
 	//skill-regen, sitting-skill-regen (since not all chars with regen need it)
 	struct regen_data_sub *sregen, *ssregen;
+
+	int index; //Slot in the natural regen arrays (see status_natural_heal_add)
 };
 
 //Status display entry
@@ -1953,9 +1955,12 @@ struct sc_display_entry {
 	int val1, val2, val3;
 };
 
+#define SC_ACTIVE_WORDS ((SC_MAX + 31) / 32)
+
 //Status change entry
 struct status_change_entry {
-	int timer;
+	int timer; //Handle from status_change_add_timer, INVALID_TIMER for infinite duration
+	unsigned int tick; //When the timer is due
 	int val1, val2, val3, val4;
 };
 
@@ -1983,7 +1988,10 @@ struct status_change {
 	unsigned char sg_counter; //Storm gust counter (previous hits from storm gust)
 #endif
 	unsigned char bs_counter; //Blood Sucker counter
-	struct status_change_entry *data[SC_MAX];
+	struct status_change_entry **data; //Entries by type, points to a shared empty table while no status is active
+	uint32 active[SC_ACTIVE_WORDS]; //Bitmap of the types that have an entry in data
+	int timer; //Heap timer of the earliest entry timer
+	unsigned int timer_tick; //When that heap timer is due
 };
 
 //For looking up associated data
@@ -2011,6 +2019,8 @@ int status_set_maxhp(struct block_list *bl, unsigned int hp, int flag);
 int status_set_sp(struct block_list *bl, unsigned int sp, int flag);
 int status_set_maxsp(struct block_list *bl, unsigned int hp, int flag);
 int status_heal(struct block_list *bl,int64 hp,int64 sp, int flag);
+void status_natural_heal_add(struct block_list *bl);
+void status_natural_heal_remove(struct block_list *bl);
 int status_revive(struct block_list *bl, unsigned char per_hp, unsigned char per_sp);
 int status_fixed_revive(struct block_list *bl, unsigned int per_hp, unsigned int per_sp);
 
@@ -2076,6 +2086,8 @@ int status_get_race2(struct block_list *bl);
 struct view_data *status_get_viewdata(struct block_list *bl);
 void status_set_viewdata(struct block_list *bl, int class_);
 void status_change_init(struct block_list *bl);
+void status_change_init_data(struct status_change *sc);
+int status_change_next(struct status_change *sc, int type);
 struct status_change *status_get_sc(struct block_list *bl);
 
 int status_isdead(struct block_list *bl);
@@ -2093,6 +2105,8 @@ int status_change_end_(struct block_list* bl, enum sc_type type, int tid, const
 #define status_change_end(bl,type,tid) status_change_end_(bl,type,tid,__FILE__,__LINE__)
 int kaahi_heal_timer(int tid, unsigned int tick, int id, intptr_t data);
 int status_change_timer(int tid, unsigned int tick, int id, intptr_t data);
+int status_change_add_timer(struct block_list *bl, enum sc_type type, unsigned int tick);
+void status_change_delete_timer(struct status_change_entry *sce);
 int status_change_timer_sub(struct block_list* bl, va_list ap);
 int status_change_clear(struct block_list* bl, int type);
 void status_change_clear_buffs(struct block_list* bl, int type);
@@ -2116,6 +2130,10 @@ void status_calc_bl_(struct block_list *bl, enum scb_flag flag, enum e_status_ca
 int status_calc_mob_(struct mob_data* md, enum e_status_calc_opt opt);
 void status_calc_pet_(struct pet_data* pd, enum e_status_calc_opt opt);
 int status_calc_pc_(struct map_session_data* sd, enum e_status_calc_opt opt);
+void status_calc_cache_clear(void);
+void status_calc_cache_free(struct map_session_data *sd);
+void status_calc_stats(uint64 *calls, uint64 *stats, uint64 *skipped, unsigned int *tick);
+void status_calc_stats_reset(void);
 int status_calc_homunculus_(struct homun_data *hd, enum e_status_calc_opt opt);
 int status_calc_mercenary_(struct mercenary_data *md, enum e_status_calc_opt opt);
 int status_calc_elemental_(struct elemental_data *ed, enum e_status_calc_opt opt);
@@ -51,8 +51,19 @@ const short diry[8] = { 1,1,0,-1,-1,-1,0,1 }; //Lookup to know where will move t
 //Early declaration
 static int unit_attack_timer(int tid, unsigned int tick, int id, intptr_t data);
 static int unit_walktoxy_timer(int tid, unsigned int tick, int id, intptr_t data);
+static int unit_walkqueue_timer(int tid, unsigned int tick, int id, intptr_t data);
 int unit_unattackable(struct block_list *bl);
 
+//Walking units of a map whose steps are done together (see walk_batch_interval)
+static struct s_unit_walkqueue {
+	struct s_unit_walkstep {
+		int id;
+		unsigned int tick; //Same as the walk_tick of the unit, otherwise the entry is stale
+	} *step;
+	int count, max;
+} unit_walkqueue[MAX_MAP_PER_SERVER];
+static int unit_walkqueue_tid = INVALID_TIMER;
+
 /**
  * Get the unit_data related to the bl
  * @param bl : Object to get the unit_data from
@@ -75,6 +86,91 @@ struct unit_data* unit_bl2ud(struct block_list *bl)
 	}
 }
 
+/**
+ * Schedules the next step of a walking unit
+ * With walk_batch_interval, the step is queued on the map of the unit instead of
+ * getting its own timer. All the steps of the map that came due are done together
+ * at the next slot, with their own tick so that the walk speed stays exact.
+ * @param bl: Walking unit
+ * @param ud: Unit data of bl
+ * @param tick: When the unit reaches the next cell
+ * @param step: Duration of the step
+ */
+static void unit_walk_schedule(struct block_list *bl, struct unit_data *ud, unsigned int tick, int step)
+{
+	struct s_unit_walkqueue *queue;
+
+	if( !battle_config.walk_batch_interval ) {
+		ud->walktimer = add_timer(tick,unit_walktoxy_timer,bl->id,step);
+		return;
+	}
+
+	queue = &unit_walkqueue[bl->m];
+	if( queue->count == queue->max ) {
+		queue->max += 32;
+		RECREATE(queue->step, struct s_unit_walkstep, queue->max);
+	}
+	queue->step[queue->count].id = bl->id;
+	queue->step[queue->count].tick = tick;
+	queue->count++;
+	ud->walktimer = UNIT_WALK_TIMER;
+	ud->walk_tick = tick;
+	ud->walk_step = step;
+
+	if( unit_walkqueue_tid == INVALID_TIMER ) {
+		int slot = battle_config.walk_batch_interval;
+		unsigned int due = gettick() + slot;
+
+		unit_walkqueue_tid = add_timer(due - due % slot,unit_walkqueue_timer,0,0);
+	}
+}
+
+/**
+ * Does the steps that came due on every map, at fixed slots of walk_batch_interval
+ * Entries of units that stopped, left the map or got a new step are dropped here.
+ * Steps queued while doing the others are done in the same pass if they are due,
+ * so fast units do not fall behind when their speed is shorter than a slot.
+ */
+static int unit_walkqueue_timer(int tid, unsigned int tick, int id, intptr_t data)
+{
+	int m, pending = 0;
+
+	if( unit_walkqueue_tid != tid ) {
+		ShowError("unit_walkqueue_timer: Timer mismatch: %d != %d\n", tid, unit_walkqueue_tid);
+		return 0;
+	}
+	unit_walkqueue_tid = INVALID_TIMER;
+
+	for( m = 0; m < map_num; m++ ) {
+		struct s_unit_walkqueue *queue = &unit_walkqueue[m];
+		int i, k;
+
+		for( i = k = 0; i < queue->count; i++ ) {
+			struct s_unit_walkstep step = queue->step[i];
+			struct block_list *bl = map_id2bl(step.id);
+			struct unit_data *ud = unit_bl2ud(bl);
+
+			if( !ud || bl->m != m || ud->walktimer != UNIT_WALK_TIMER || ud->walk_tick != step.tick )
+				continue; //Stale
+			if( DIFF_TICK(step.tick,tick) > 0 ) { //Not yet
+				queue->step[k++] = step;
+				continue;
+			}
+			unit_walktoxy_timer(UNIT_WALK_TIMER,step.tick,step.id,ud->walk_step); //May queue more steps on any map
+		}
+		queue->count = k;
+		pending += k;
+	}
+
+	if( pending && unit_walkqueue_tid == INVALID_TIMER ) {
+		int slot = max(battle_config.walk_batch_interval,1); //Finish the queued steps if the option was turned off
+		unsigned int due = tick + slot;
+
+		unit_walkqueue_tid = add_timer(due - due % slot,unit_walkqueue_timer,0,0);
+	}
+	return 0;
+}
+
 /**
  * Tells a unit to walk to a specific coordinate
  * @param bl: Unit to walk [ALL]
@@ -138,7 +234,7 @@ int unit_walktoxy_sub(struct block_list *bl)
 	else
 		i = status_get_speed(bl);
 	if( i > 0 )
-		ud->walktimer = add_timer(gettick() + i,unit_walktoxy_timer,bl->id,i);
+		unit_walk_schedule(bl,ud,gettick() + i,i);
 	return 1;
 }
 
@@ -490,7 +586,7 @@ static int unit_walktoxy_timer(int tid, unsigned int tick, int id, intptr_t data
 		i = status_get_speed(bl);
 
 	if(i > 0) {
-		ud->walktimer = add_timer(tick + i,unit_walktoxy_timer,id,i);
+		unit_walk_schedule(bl,ud,tick + i,i);
 		if(md && DIFF_TICK(tick,md->dmgtick) < 3000) //Not required not damaged recently
 			clif_move(ud);
 	} else if(ud->state.running) { //Keep trying to run
@@ -1213,24 +1309,31 @@ int unit_warp(struct block_list *bl,short m,short x,short y,clr_type type)
 int unit_stop_walking(struct block_list *bl,int type)
 {
 	struct unit_data *ud;
-	const struct TimerData* td;
-	unsigned int tick;
+	unsigned int tick, step_tick = 0;
+	int step = 0;
 
 	nullpo_ret(bl);
 
 	ud = unit_bl2ud(bl);
 	if(!ud || ud->walktimer == INVALID_TIMER)
 		return 0;
-	//NOTE: We are using timer data after deleting it because we know the
-	//delete_timer function does not messes with it. If the function's
-	//behaviour changes in the future, this code could break!
-	td = get_timer(ud->walktimer);
-	delete_timer(ud->walktimer, unit_walktoxy_timer);
+	if(ud->walktimer == UNIT_WALK_TIMER) { //The queued entry is dropped by unit_walkqueue_timer
+		step_tick = ud->walk_tick;
+		step = ud->walk_step;
+	} else {
+		const struct TimerData* td = get_timer(ud->walktimer);
+
+		if(td) {
+			step_tick = td->tick;
+			step = (int)td->data;
+		}
+		delete_timer(ud->walktimer, unit_walktoxy_timer);
+	}
 	ud->walktimer = INVALID_TIMER;
 	ud->state.change_walk_target = 0;
 	tick = gettick();
 	if( (type&0x02 && !ud->walkpath.path_pos) || //Force moving at least one cell.
-		(type&0x04 && td && DIFF_TICK(td->tick, tick) <= td->data / 2) //Enough time has passed to cover half-cell
+		(type&0x04 && step && DIFF_TICK(step_tick, tick) <= step / 2) //Enough time has passed to cover half-cell
 	) {
 		ud->walkpath.path_len = ud->walkpath.path_pos + 1;
 		unit_walktoxy_timer(INVALID_TIMER, tick, bl->id, ud->walkpath.path_pos);
@@ -2706,6 +2809,8 @@ int unit_remove_map_(struct block_list *bl, clr_type clrtype, const char* file,
 	//Do not reset can-act delay [Skotlex]
 	ud->attackabletime = ud->canmove_tick /*= ud->canact_tick*/ = gettick();
 
+	clif_clearviewcache(bl);
+
 	if (sc && sc->count) { //Map-change/warp dispells
 		status_change_end(bl,SC_BLADESTOP,INVALID_TIMER);
 		status_change_end(bl,SC_BASILICA,INVALID_TIMER);
@@ -2824,8 +2929,11 @@ int unit_remove_map_(struct block_list *bl, clr_type clrtype, const char* file,
 						sd->state.active,sd->state.connect_new,sd->state.rewarp,sd->state.changemap,sd->state.debug_remove_map,
 						map[bl->m].name,map[bl->m].users,
 						sd->debug_file,sd->debug_line,sd->debug_func,file,line,func);
-				} else if (--map[bl->m].users == 0 && battle_config.dynamic_mobs) //[Skotlex]
-					map_removemobs(bl->m);
+				} else if (--map[bl->m].users == 0) {
+					if (battle_config.dynamic_mobs) //[Skotlex]
+						map_removemobs(bl->m);
+					mob_freeze_map(bl->m);
+				}
 				if (!(sd->sc.option&OPTION_INVISIBLE)) //Decrement the number of active pvp players on the map
 					--map[bl->m].users_pvp;
 				if (sd->state.hpmeter_visible) {
@@ -2849,6 +2957,7 @@ int unit_remove_map_(struct block_list *bl, clr_type clrtype, const char* file,
 
 				md->attacked_id = 0;
 				md->state.skillstate = MSS_IDLE;
+				mob_ai_deactivate(md);
 
 			}
 			break;
@@ -2988,6 +3097,7 @@ int unit_free(struct block_list *bl, clr_type clrtype)
 				pc_delautobonus(sd, sd->autobonus3, ARRAYLENGTH(sd->autobonus3), false);
 				if( sd->followtimer != INVALID_TIMER )
 					pc_stop_following(sd);
+				clif_getareachar_clear(sd);
 				if( sd->duel_invite > 0 )
 					duel_reject(sd->duel_invite, sd);
 				channel_pcquit(sd, 0xF); //Leave all channel
@@ -3041,6 +3151,7 @@ int unit_free(struct block_list *bl, clr_type clrtype)
 				if( sd->bonus_script.head )
 					pc_bonus_script_clear(sd, BSF_REM_ALL);
 				pc_itemgrouphealrate_clear(sd);
+				status_calc_cache_free(sd);
 			}
 			break;
 		case BL_PET: {
@@ -3095,10 +3206,7 @@ int unit_free(struct block_list *bl, clr_type clrtype)
 		case BL_MOB: {
 				struct mob_data *md = (struct mob_data*)bl;
 
-				if( md->spawn_timer != INVALID_TIMER ) {
-					delete_timer(md->spawn_timer,mob_delayspawn);
-					md->spawn_timer = INVALID_TIMER;
-				}
+				md->spawn_pending = false; //Its queued respawn is dropped
 				if( md->deletetimer != INVALID_TIMER ) {
 					delete_timer(md->deletetimer,mob_timer_delete);
 					md->deletetimer = INVALID_TIMER;
@@ -3195,6 +3303,7 @@ int unit_free(struct block_list *bl, clr_type clrtype)
 
 	skill_clear_unitgroup(bl);
 	status_change_clear(bl,1);
+	clif_freeviewcache(ud);
 	map_deliddb(bl);
 	if( bl->type != BL_PC ) //Players are handled by map_quit
 		map_freeblock(bl);
@@ -3215,6 +3324,7 @@ void do_init_unit(void)
 	add_timer_func_list(unit_delay_walktobl_timer,"unit_delay_walktobl_timer");
 	add_timer_func_list(unit_teleport_timer,"unit_teleport_timer");
 	add_timer_func_list(unit_step_timer,"unit_step_timer");
+	add_timer_func_list(unit_walkqueue_timer,"unit_walkqueue_timer");
 }
 
 /**
@@ -3223,5 +3333,15 @@ void do_init_unit(void)
  */
 void do_final_unit(void)
 {
-	return;
+	int i;
+
+	for( i = 0; i < MAX_MAP_PER_SERVER; i++ ) {
+		if( unit_walkqueue[i].step != NULL )
+			aFree(unit_walkqueue[i].step);
+	}
+	memset(unit_walkqueue, 0, sizeof(unit_walkqueue));
+	if( unit_walkqueue_tid != INVALID_TIMER ) {
+		delete_timer(unit_walkqueue_tid,unit_walkqueue_timer);
+		unit_walkqueue_tid = INVALID_TIMER;
+	}
 }
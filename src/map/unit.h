@@ -17,6 +17,8 @@ struct map_session_data;
 extern const short dirx[8]; // Lookup to know where will move to x according dir
 extern const short diry[8]; // Lookup to know where will move to y according dir
 
+#define UNIT_WALK_TIMER -3 // walktimer of units whose steps are batched per map (see walk_batch_interval)
+
 struct unit_data {
 	struct block_list *bl; // Link to owner object BL_PC|BL_MOB|BL_PET|BL_NPC|BL_HOM|BL_MER|BL_ELEM
 	struct walkpath_data walkpath;
@@ -33,6 +35,8 @@ struct unit_data {
 	int target_to;
 	int attacktimer;
 	int walktimer;
+	unsigned int walk_tick; // Tick of the next step when walktimer is UNIT_WALK_TIMER
+	int walk_step; // Duration of that step
 	int chaserange;
 	bool stepaction; //Action should be executed on step [Playtester]
 	int steptimer; //Timer that triggers the action [Playtester]
@@ -44,6 +48,7 @@ struct unit_data {
 	uint8 dir;
 	unsigned char walk_count;
 	unsigned char target_count;
+	struct unit_viewcache *viewcache; //Idle packet sent to players getting the unit in sight [clif_getareachar_unit]
 	struct {
 		unsigned change_walk_target : 1 ;
 		unsigned skillcastcancel : 1 ;
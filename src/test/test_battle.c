@@ -0,0 +1,315 @@
+// Copyright (c) Athena Dev Teams - Licensed under GNU GPL
+// For more information, see LICENCE in the main folder
+
+#include "../common/cbasetypes.h"
+#include "../common/core.h"
+#include "../common/malloc.h"
+#include "../common/random.h"
+#include "../common/showmsg.h"
+#include "../common/strlib.h"
+#include "../common/timer.h"
+
+#include "../map/map.h"
+#include "../map/itemdb.h"
+#include "../map/pc.h"
+#include "../map/mob.h"
+#include "../map/status.h"
+#include "../map/skill.h"
+#include "../map/unit.h"
+#include "../map/battle.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//
+// Deterministic benchmark for battle_calc_attack.
+//
+// Links against the map-server objects (map.c built with -DBATTLE_BENCH), so
+// the real item/mob/skill databases and battle configuration get loaded.
+// Every fixture builds a player and a monster, both sides attack each other
+// with a fixed random seed and all results are folded into one digest.
+// Two runs with the same fixtures and seed must print the same digest, which
+// makes it usable to check that an optimization did not change any damage.
+//
+
+#define BENCH_FIXTURE_DIR "src/test"
+#define BENCH_FIXTURE_FILE "battle_bench.txt"
+#define BENCH_MAX_FIXTURES 64
+
+struct bench_fixture {
+	int job, base_level, job_level;
+	int str, agi, vit, int_, dex, luk;
+	unsigned short weapon, card, armor;
+	uint16 skill_id, skill_lv;
+	int mob_id;
+};
+
+static struct bench_fixture bench_fixtures[BENCH_MAX_FIXTURES];
+static int bench_fixture_count = 0;
+
+static const char *bench_fixture_dir = BENCH_FIXTURE_DIR;
+static const char *bench_fixture_file = BENCH_FIXTURE_FILE;
+static unsigned int bench_iterations = 200000;
+static uint32 bench_seed = 1;
+static const char *bench_digest = NULL;
+
+/// Reads the options meant for the benchmark and removes them from argv,
+/// the rest is left for cli_get_options.
+void battle_bench_options(int *argc, char **argv)
+{
+	int i, n = 1;
+
+	for( i = 1; i < *argc; i++ ) {
+		const char *arg = argv[i];
+
+		if( i + 1 < *argc && strcmp(arg, "--bench-fixture") == 0 ) {
+			char *p = argv[++i];
+			char *sep = strrchr(p, '/');
+
+			if( sep ) { //Split into directory and file for sv_readdb
+				*sep = '\0';
+				bench_fixture_dir = p;
+				bench_fixture_file = sep + 1;
+			} else {
+				bench_fixture_dir = ".";
+				bench_fixture_file = p;
+			}
+		} else if( i + 1 < *argc && strcmp(arg, "--bench-iterations") == 0 )
+			bench_iterations = (unsigned int)strtoul(argv[++i], NULL, 10);
+		else if( i + 1 < *argc && strcmp(arg, "--bench-seed") == 0 )
+			bench_seed = (uint32)strtoul(argv[++i], NULL, 10);
+		else if( i + 1 < *argc && strcmp(arg, "--bench-digest") == 0 )
+			bench_digest = argv[++i];
+		else
+			argv[n++] = argv[i];
+	}
+	*argc = n;
+}
+
+/// Job,BaseLv,JobLv,Str,Agi,Vit,Int,Dex,Luk,Weapon,Card,Armor,SkillID,SkillLv,MobID
+static bool battle_bench_read_fixture(char *str[], int columns, int current)
+{
+	struct bench_fixture *f;
+
+	if( bench_fixture_count >= BENCH_MAX_FIXTURES ) {
+		ShowWarning("battle_bench_read_fixture: Too many fixtures, skipping line %d.\n", current);
+		return false;
+	}
+	f = &bench_fixtures[bench_fixture_count];
+	f->job = atoi(str[0]);
+	f->base_level = atoi(str[1]);
+	f->job_level = atoi(str[2]);
+	f->str = atoi(str[3]);
+	f->agi = atoi(str[4]);
+	f->vit = atoi(str[5]);
+	f->int_ = atoi(str[6]);
+	f->dex = atoi(str[7]);
+	f->luk = atoi(str[8]);
+	f->weapon = (unsigned short)atoi(str[9]);
+	f->card = (unsigned short)atoi(str[10]);
+	f->armor = (unsigned short)atoi(str[11]);
+	f->skill_id = (uint16)atoi(str[12]);
+	f->skill_lv = (uint16)atoi(str[13]);
+	f->mob_id = atoi(str[14]);
+	if( pc_jobid2mapid(f->job) == -1 ) {
+		ShowWarning("battle_bench_read_fixture: Invalid job %d in line %d, skipping.\n", f->job, current);
+		return false;
+	}
+	if( !mobdb_checkid(f->mob_id) ) {
+		ShowWarning("battle_bench_read_fixture: Invalid monster %d in line %d, skipping.\n", f->mob_id, current);
+		return false;
+	}
+	if( (f->weapon && !itemdb_exists(f->weapon)) || (f->card && !itemdb_exists(f->card)) || (f->armor && !itemdb_exists(f->armor)) ) {
+		ShowWarning("battle_bench_read_fixture: Unknown item in line %d, skipping.\n", current);
+		return false;
+	}
+	bench_fixture_count++;
+	return true;
+}
+
+/// Builds a player from a fixture without a client or char-server behind it
+static struct map_session_data *battle_bench_create_pc(struct bench_fixture *f, int id, int16 m, int16 x, int16 y)
+{
+	struct map_session_data *sd = (struct map_session_data *)aCalloc(1, sizeof(struct map_session_data));
+	int i;
+
+	pc_init_data(sd, 0);
+	pc_setnewpc(sd, id, id, 0, 0, SEX_MALE, 0);
+	safestrncpy(sd->status.name, "bench", NAME_LENGTH);
+	sd->status.class_ = f->job;
+	sd->class_ = pc_jobid2mapid(f->job);
+	sd->status.base_level = f->base_level;
+	sd->status.job_level = f->job_level;
+	sd->status.str = f->str;
+	sd->status.agi = f->agi;
+	sd->status.vit = f->vit;
+	sd->status.int_ = f->int_;
+	sd->status.dex = f->dex;
+	sd->status.luk = f->luk;
+	if( f->weapon ) {
+		sd->status.inventory[0].nameid = f->weapon;
+		sd->status.inventory[0].amount = 1;
+		sd->status.inventory[0].identify = 1;
+		sd->status.inventory[0].equip = EQP_HAND_R;
+		sd->status.inventory[0].card[0] = f->card;
+	}
+	if( f->armor ) {
+		sd->status.inventory[1].nameid = f->armor;
+		sd->status.inventory[1].amount = 1;
+		sd->status.inventory[1].identify = 1;
+		sd->status.inventory[1].equip = EQP_ARMOR;
+	}
+
+	sd->followtimer = INVALID_TIMER;
+	sd->invincible_timer = INVALID_TIMER;
+	sd->npc_timer_id = INVALID_TIMER;
+	sd->pvp_timer = INVALID_TIMER;
+	sd->expiration_tid = INVALID_TIMER;
+	sd->autotrade_tid = INVALID_TIMER;
+	sd->areachar.timer = INVALID_TIMER;
+	sd->rental_timer = INVALID_TIMER;
+	for( i = 0; i < MAX_SPIRITBALL; i++ )
+		sd->spiritball_timer[i] = INVALID_TIMER;
+	for( i = 0; i < ARRAYLENGTH(sd->autobonus); i++ )
+		sd->autobonus[i].active = INVALID_TIMER;
+	for( i = 0; i < ARRAYLENGTH(sd->autobonus2); i++ )
+		sd->autobonus2[i].active = INVALID_TIMER;
+	for( i = 0; i < ARRAYLENGTH(sd->autobonus3); i++ )
+		sd->autobonus3[i].active = INVALID_TIMER;
+	for( i = 0; i < MAX_EVENTTIMER; i++ )
+		sd->eventtimer[i] = INVALID_TIMER;
+
+	sd->bl.m = m;
+	sd->bl.x = x;
+	sd->bl.y = y;
+
+	pc_setinventorydata(sd);
+	pc_setequipindex(sd);
+	status_change_init(&sd->bl);
+	status_set_viewdata(&sd->bl, sd->status.class_);
+	unit_dataset(&sd->bl);
+	pc_calc_skilltree(sd);
+	status_calc_pc(sd, SCO_FIRST);
+	sd->battle_status.hp = sd->battle_status.max_hp;
+	sd->battle_status.sp = sd->battle_status.max_sp;
+	return sd;
+}
+
+/// Spawns the fixture monster as an object that is not placed on the map
+static struct mob_data *battle_bench_create_mob(struct bench_fixture *f, int16 m, int16 x, int16 y)
+{
+	struct spawn_data data;
+	struct mob_data *md;
+
+	memset(&data, 0, sizeof(data));
+	data.id = f->mob_id;
+	data.m = m;
+	data.x = x;
+	data.y = y;
+	data.num = 1;
+	safestrncpy(data.name, "--ja--", sizeof(data.name));
+	if( !mob_parse_dataset(&data) )
+		return NULL;
+	md = mob_spawn_dataset(&data);
+	status_calc_mob(md, SCO_FIRST);
+	return md;
+}
+
+/// Folds one result into a FNV-1a digest
+static uint64 battle_bench_hash(uint64 hash, int64 value)
+{
+	int i;
+
+	for( i = 0; i < 8; i++ ) {
+		hash ^= (uint8)(value>>(i * 8));
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static uint64 battle_bench_hash_damage(uint64 hash, struct Damage *d)
+{
+	hash = battle_bench_hash(hash, d->damage);
+	hash = battle_bench_hash(hash, d->damage2);
+	hash = battle_bench_hash(hash, d->type);
+	hash = battle_bench_hash(hash, d->div_);
+	hash = battle_bench_hash(hash, d->flag);
+	hash = battle_bench_hash(hash, d->dmg_lv);
+	return hash;
+}
+
+/// Runs all fixtures and reports throughput and the result digest.
+/// Exits with a failure status when an expected digest was given and differs.
+void battle_bench_run(void)
+{
+	struct map_session_data *sd[BENCH_MAX_FIXTURES];
+	struct mob_data *md[BENCH_MAX_FIXTURES];
+	uint64 hash = 14695981039346656037ULL, calls = 0;
+	unsigned int i, tick;
+	int j;
+	int16 m = 0, x, y;
+	char digest[17];
+
+	if( map_num <= 0 ) {
+		ShowError("battle_bench_run: No maps loaded, can't place the fixtures.\n");
+		exit(EXIT_FAILURE);
+	}
+	x = map[m].xs / 2;
+	y = map[m].ys / 2;
+
+	sv_readdb(bench_fixture_dir, bench_fixture_file, ',', 15, 15, BENCH_MAX_FIXTURES, &battle_bench_read_fixture);
+	if( !bench_fixture_count ) {
+		ShowError("battle_bench_run: No fixtures read from '%s/%s'.\n", bench_fixture_dir, bench_fixture_file);
+		exit(EXIT_FAILURE);
+	}
+
+	for( j = 0; j < bench_fixture_count; ) {
+		if( (md[j] = battle_bench_create_mob(&bench_fixtures[j], m, x + 1, y)) == NULL ) {
+			ShowWarning("battle_bench_run: Can't spawn monster %d, skipping fixture %d.\n", bench_fixtures[j].mob_id, j + 1);
+			memmove(&bench_fixtures[j], &bench_fixtures[j + 1], (bench_fixture_count - j - 1) * sizeof(bench_fixtures[0]));
+			bench_fixture_count--;
+			continue;
+		}
+		sd[j] = battle_bench_create_pc(&bench_fixtures[j], START_ACCOUNT_NUM + j, m, x, y);
+		j++;
+	}
+	if( !bench_fixture_count ) {
+		ShowError("battle_bench_run: No usable fixtures.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	ShowStatus("Battle benchmark: %d fixtures, %u iterations, seed %u.\n", bench_fixture_count, bench_iterations, bench_seed);
+	rnd_seed(bench_seed);
+	tick = gettick_nocache();
+	for( i = 0; i < bench_iterations; i++ ) {
+		for( j = 0; j < bench_fixture_count; j++ ) {
+			struct bench_fixture *f = &bench_fixtures[j];
+			struct Damage d;
+			int type = (f->skill_id ? skill_get_type(f->skill_id) : BF_WEAPON);
+
+			d = battle_calc_attack(type, &sd[j]->bl, &md[j]->bl, f->skill_id, f->skill_lv, 0);
+			hash = battle_bench_hash_damage(hash, &d);
+			d = battle_calc_attack(BF_WEAPON, &md[j]->bl, &sd[j]->bl, 0, 0, 0);
+			hash = battle_bench_hash_damage(hash, &d);
+			calls += 2;
+		}
+	}
+	tick = DIFF_TICK(gettick_nocache(), tick);
+
+	snprintf(digest, sizeof(digest), "%016"PRIx64, hash);
+	ShowStatus("Battle benchmark: %"PRIu64" calculations in %u ms (%.0f/s), digest %s.\n",
+		calls, tick, tick ? (double)calls * 1000 / tick : 0., digest);
+
+	for( j = 0; j < bench_fixture_count; j++ ) {
+		unit_free(&md[j]->bl, CLR_OUTSIGHT);
+		status_change_clear(&sd[j]->bl, 1);
+		status_calc_cache_free(sd[j]);
+		aFree(sd[j]);
+	}
+
+	if( bench_digest && strcmpi(bench_digest, digest) != 0 ) {
+		ShowError("Battle benchmark: Digest mismatch, expected %s.\n", bench_digest);
+		exit(EXIT_FAILURE);
+	}
+}